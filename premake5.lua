@@ -62,7 +62,7 @@ project "Line-Render-Test"
 
         filter "system:linux"
             links {
-                "m", "X11", "GL", "GLX",
+                "m", "X11", "GL", "GLX", "pthread",
             }
 
         filter { "system:windows", "action:*gmake*", "configurations:debug" }
@@ -72,7 +72,7 @@ project "Line-Render-Test"
             systemversion "latest"
 
             links {
-                "gdi32", "kernel32", "user32", "opengl32"
+                "gdi32", "kernel32", "user32", "opengl32", "synchronization"
             }
     end            
         
@@ -34,6 +34,14 @@ static_assert(sizeof(f64) == 8, "f64 size");
 
 #define UNUSED(x) (void)(x)
 
+#if defined(__clang__) || defined(__GNUC__)
+#   define THREAD_VAR __thread
+#elif defined(_MSC_VER)
+#   define THREAD_VAR __declspec(thread)
+#else
+#   define THREAD_VAR _Thread_local
+#endif
+
 #define CONCAT_NX(a, b) a##b
 #define CONCAT(a, b) CONCAT_NX(a, b)
 
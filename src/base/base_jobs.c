@@ -0,0 +1,287 @@
+#include "base_jobs.h"
+
+#include <stdio.h>
+
+#include "os/os.h"
+
+typedef struct {
+    // Exactly one of these is set
+    jobs_func* func;
+    jobs_range_func* range_func;
+
+    void* data;
+    u32 start, end;
+
+    jobs_counter* counter;
+} _jobs_job;
+
+typedef struct {
+    os_mutex* mutex;
+
+    // Positions only increase, the slot is pos % JOBS_DEQUE_SIZE
+    // The owner pushes and pops at the back, thieves take from the front
+    u32 front;
+    u32 back;
+
+    _jobs_job jobs[JOBS_DEQUE_SIZE];
+} _jobs_deque;
+
+typedef struct {
+    jobs_system* jobs;
+    u32 index;
+    os_thread* thread;
+} _jobs_worker;
+
+typedef struct jobs_system {
+    // Deque 0 belongs to the thread that created the system
+    u32 num_deques;
+    _jobs_deque* deques;
+
+    u32 num_workers;
+    _jobs_worker* workers;
+
+    b32 running;
+
+    // Changed every time a job is pushed, idle workers sleep on it
+    u32 epoch;
+    u32 num_sleeping;
+} jobs_system;
+
+static THREAD_VAR jobs_system* _jobs_current = NULL;
+static THREAD_VAR u32 _jobs_index = 0;
+
+static void _jobs_worker_main(void* worker_ptr);
+static u32 _jobs_own_deque(jobs_system* jobs);
+static void _jobs_push(jobs_system* jobs, const _jobs_job* job);
+static b32 _jobs_find(jobs_system* jobs, u32 own, _jobs_job* out);
+static void _jobs_execute(const _jobs_job* job);
+
+jobs_system* jobs_create(mg_arena* arena, u32 num_workers) {
+    if (num_workers == 0) {
+        num_workers = os_num_cores() - 1;
+    }
+    num_workers = MIN(num_workers, JOBS_MAX_WORKERS);
+
+    jobs_system* jobs = MGA_PUSH_ZERO_STRUCT(arena, jobs_system);
+
+    jobs->num_deques = num_workers + 1;
+    jobs->deques = MGA_PUSH_ZERO_ARRAY(arena, _jobs_deque, jobs->num_deques);
+    for (u32 i = 0; i < jobs->num_deques; i++) {
+        jobs->deques[i].mutex = os_mutex_create(arena);
+    }
+
+    jobs->running = true;
+
+    _jobs_current = jobs;
+    _jobs_index = 0;
+
+    jobs->workers = MGA_PUSH_ZERO_ARRAY(arena, _jobs_worker, num_workers);
+
+    u32 num_cores = os_num_cores();
+
+    for (u32 i = 0; i < num_workers; i++) {
+        _jobs_worker* worker = &jobs->workers[i];
+
+        worker->jobs = jobs;
+        worker->index = i + 1;
+        worker->thread = os_thread_create(arena, _jobs_worker_main, worker);
+
+        // Without threads, everything runs on the calling thread
+        if (worker->thread == NULL) {
+            break;
+        }
+
+        // The calling thread keeps core 0
+        if (num_cores > 1) {
+            os_thread_set_affinity(worker->thread, (i + 1) % num_cores);
+        }
+
+        jobs->num_workers++;
+    }
+
+    return jobs;
+}
+void jobs_destroy(jobs_system* jobs) {
+    if (jobs == NULL) {
+        fprintf(stderr, "Cannot destroy NULL job system\n");
+        return;
+    }
+
+    OS_ATOMIC_STORE(&jobs->running, false);
+    OS_ATOMIC_ADD(&jobs->epoch, 1);
+    os_futex_wake_all(&jobs->epoch);
+
+    for (u32 i = 0; i < jobs->num_workers; i++) {
+        os_thread_join(jobs->workers[i].thread);
+    }
+
+    for (u32 i = 0; i < jobs->num_deques; i++) {
+        os_mutex_destroy(jobs->deques[i].mutex);
+    }
+
+    if (_jobs_current == jobs) {
+        _jobs_current = NULL;
+    }
+}
+
+u32 jobs_num_threads(const jobs_system* jobs) {
+    return jobs->num_workers + 1;
+}
+u32 jobs_thread_index(const jobs_system* jobs) {
+    return _jobs_current == jobs ? _jobs_index : 0;
+}
+
+void jobs_run(jobs_system* jobs, jobs_func* func, void* data, jobs_counter* counter) {
+    if (counter != NULL) {
+        OS_ATOMIC_ADD(&counter->value, 1);
+    }
+
+    _jobs_push(jobs, &(_jobs_job){
+        .func = func,
+        .data = data,
+        .counter = counter
+    });
+}
+
+void jobs_wait(jobs_system* jobs, jobs_counter* counter) {
+    u32 own = _jobs_own_deque(jobs);
+
+    u32 value = 0;
+    while ((value = OS_ATOMIC_LOAD(&counter->value)) != 0) {
+        _jobs_job job = { 0 };
+
+        if (_jobs_find(jobs, own, &job)) {
+            _jobs_execute(&job);
+            continue;
+        }
+
+        // The remaining jobs are running on other threads
+        // The timeout is there to pick up new jobs that those might push
+        os_futex_wait(&counter->value, value, 1);
+    }
+}
+
+void jobs_parallel_for(jobs_system* jobs, u32 count, u32 batch_size, jobs_range_func* func, void* data) {
+    if (count == 0) {
+        return;
+    }
+
+    if (batch_size == 0) {
+        batch_size = MAX(1, count / (jobs_num_threads(jobs) * 4));
+    }
+
+    jobs_counter counter = { 0 };
+
+    for (u32 start = 0; start < count; start += batch_size) {
+        OS_ATOMIC_ADD(&counter.value, 1);
+
+        _jobs_push(jobs, &(_jobs_job){
+            .range_func = func,
+            .data = data,
+            .start = start,
+            .end = MIN(start + batch_size, count),
+            .counter = &counter
+        });
+    }
+
+    jobs_wait(jobs, &counter);
+}
+
+static void _jobs_worker_main(void* worker_ptr) {
+    _jobs_worker* worker = (_jobs_worker*)worker_ptr;
+    jobs_system* jobs = worker->jobs;
+
+    _jobs_current = jobs;
+    _jobs_index = worker->index;
+
+    // Creating the scratch arenas up front so the first job does not pay for it
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+    mga_scratch_release(scratch);
+
+    while (OS_ATOMIC_LOAD(&jobs->running)) {
+        u32 epoch = OS_ATOMIC_LOAD(&jobs->epoch);
+
+        _jobs_job job = { 0 };
+        if (_jobs_find(jobs, worker->index, &job)) {
+            _jobs_execute(&job);
+            continue;
+        }
+
+        // A push after reading the epoch changes it, so the wait returns right away instead of missing the job
+        OS_ATOMIC_ADD(&jobs->num_sleeping, 1);
+        os_futex_wait(&jobs->epoch, epoch, OS_WAIT_INFINITE);
+        OS_ATOMIC_SUB(&jobs->num_sleeping, 1);
+    }
+}
+
+static u32 _jobs_own_deque(jobs_system* jobs) {
+    // Threads that are not workers share the deque of the creating thread
+    return jobs_thread_index(jobs);
+}
+
+static void _jobs_push(jobs_system* jobs, const _jobs_job* job) {
+    _jobs_deque* deque = &jobs->deques[_jobs_own_deque(jobs)];
+
+    os_mutex_lock(deque->mutex);
+
+    if (deque->back - deque->front >= JOBS_DEQUE_SIZE) {
+        os_mutex_unlock(deque->mutex);
+
+        _jobs_execute(job);
+        return;
+    }
+
+    deque->jobs[deque->back % JOBS_DEQUE_SIZE] = *job;
+    deque->back++;
+
+    os_mutex_unlock(deque->mutex);
+
+    OS_ATOMIC_ADD(&jobs->epoch, 1);
+    if (OS_ATOMIC_LOAD(&jobs->num_sleeping) > 0) {
+        os_futex_wake_one(&jobs->epoch);
+    }
+}
+
+static b32 _jobs_find(jobs_system* jobs, u32 own, _jobs_job* out) {
+    // Newest job from the own deque first, it is the most likely to still be in cache
+    _jobs_deque* deque = &jobs->deques[own];
+
+    os_mutex_lock(deque->mutex);
+    if (deque->back != deque->front) {
+        deque->back--;
+        *out = deque->jobs[deque->back % JOBS_DEQUE_SIZE];
+
+        os_mutex_unlock(deque->mutex);
+        return true;
+    }
+    os_mutex_unlock(deque->mutex);
+
+    // Stealing the oldest job from the others
+    for (u32 i = 1; i < jobs->num_deques; i++) {
+        deque = &jobs->deques[(own + i) % jobs->num_deques];
+
+        os_mutex_lock(deque->mutex);
+        if (deque->back != deque->front) {
+            *out = deque->jobs[deque->front % JOBS_DEQUE_SIZE];
+            deque->front++;
+
+            os_mutex_unlock(deque->mutex);
+            return true;
+        }
+        os_mutex_unlock(deque->mutex);
+    }
+
+    return false;
+}
+
+static void _jobs_execute(const _jobs_job* job) {
+    if (job->range_func != NULL) {
+        job->range_func(job->data, job->start, job->end);
+    } else {
+        job->func(job->data);
+    }
+
+    if (job->counter != NULL && OS_ATOMIC_SUB(&job->counter->value, 1) == 1) {
+        os_futex_wake_all(&job->counter->value);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef BASE_JOBS_H
+#define BASE_JOBS_H
+
+#include "base/base.h"
+
+// Work-stealing job system
+// Every worker has its own deque. Workers pop their own jobs from the back
+// and steal from the front of other deques when they run out.
+// The thread that creates the system also owns a deque and runs jobs while it waits.
+//
+// Workers use the regular thread-local mga scratch arenas,
+// so jobs can call mga_scratch_get like any other code.
+
+#define JOBS_MAX_WORKERS 64
+// Jobs per deque, when a deque is full the job runs right away instead
+#define JOBS_DEQUE_SIZE 1024
+
+typedef void (jobs_func)(void* data);
+// Processes the items in [start, end)
+typedef void (jobs_range_func)(void* data, u32 start, u32 end);
+
+// Number of unfinished jobs that were started with the counter
+// Used to wait for a group of jobs, which is how dependencies between jobs are expressed
+typedef struct {
+    u32 value;
+} jobs_counter;
+
+// Contents defined in base_jobs.c
+typedef struct jobs_system jobs_system;
+
+// num_workers does not include the calling thread, 0 picks one worker per extra core
+// If threads are not supported, every job runs on the calling thread in jobs_wait
+jobs_system* jobs_create(mg_arena* arena, u32 num_workers);
+void jobs_destroy(jobs_system* jobs);
+
+// Workers plus the calling thread
+u32 jobs_num_threads(const jobs_system* jobs);
+// Index of the calling thread in [0, jobs_num_threads), for per-thread data in jobs
+// Threads that are not workers share index 0 with the thread that created the system
+u32 jobs_thread_index(const jobs_system* jobs);
+
+// counter can be NULL if nothing needs to wait for the job
+// Any data the job uses has to stay alive until the job is done
+void jobs_run(jobs_system* jobs, jobs_func* func, void* data, jobs_counter* counter);
+// Runs other jobs until the counter reaches zero
+void jobs_wait(jobs_system* jobs, jobs_counter* counter);
+
+// Splits [0, count) into batches of batch_size and waits for all of them
+// batch_size 0 picks a size that gives every thread a few batches
+void jobs_parallel_for(jobs_system* jobs, u32 count, u32 batch_size, jobs_range_func* func, void* data);
+
+#endif // BASE_JOBS_H
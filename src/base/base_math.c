@@ -41,6 +41,61 @@ b32 rectf_collide_circlef(rectf rect, circlef circle) {
     }
     return false;
 }
+b32 rectf_collide_capsulef(rectf rect, capsulef capsule) {
+    vec2f d = vec2f_sub(capsule.p1, capsule.p0);
+
+    // Clipping the segment to the rect, anything left means it goes through the rect
+    f32 t0 = 0.0f;
+    f32 t1 = 1.0f;
+    f32 p[4] = { -d.x, d.x, -d.y, d.y };
+    f32 q[4] = {
+        capsule.p0.x - rect.x, rect.x + rect.w - capsule.p0.x,
+        capsule.p0.y - rect.y, rect.y + rect.h - capsule.p0.y
+    };
+
+    b32 inside = true;
+    for (u32 i = 0; i < 4 && inside; i++) {
+        if (p[i] == 0.0f) {
+            inside = q[i] >= 0.0f;
+        } else if (p[i] < 0.0f) {
+            t0 = MAX(t0, q[i] / p[i]);
+        } else {
+            t1 = MIN(t1, q[i] / p[i]);
+        }
+    }
+
+    if (inside && t0 <= t1) {
+        return true;
+    }
+
+    // Otherwise the closest points are an end of the segment or a corner of the rect
+    if (rectf_collide_circlef(rect, (circlef){ capsule.p0, capsule.r }) ||
+        rectf_collide_circlef(rect, (circlef){ capsule.p1, capsule.r })) {
+        return true;
+    }
+
+    f32 sqr_r = capsule.r * capsule.r;
+    vec2f corners[4] = {
+        { rect.x, rect.y },
+        { rect.x + rect.w, rect.y },
+        { rect.x, rect.y + rect.h },
+        { rect.x + rect.w, rect.y + rect.h },
+    };
+
+    for (u32 i = 0; i < 4; i++) {
+        if (vec2f_segment_sqr_dist(corners[i], capsule.p0, capsule.p1) <= sqr_r) {
+            return true;
+        }
+    }
+
+    return false;
+}
+f32 rectf_sqr_dist(rectf a, rectf b) {
+    f32 dx = MAX(0.0f, MAX(a.x - (b.x + b.w), b.x - (a.x + a.w)));
+    f32 dy = MAX(0.0f, MAX(a.y - (b.y + b.h), b.y - (a.y + a.h)));
+
+    return dx * dx + dy * dy;
+}
 
 vec2f vec2f_add(vec2f a, vec2f b) {
     return (vec2f){ a.x + b.x, a.y + b.y };
@@ -82,6 +137,16 @@ b32 vec2f_eq(vec2f a, vec2f b) {
 vec2f vec2f_ref(vec2f d, vec2f n) {
     return vec2f_sub(d, vec2f_scl(n, 2.0f * vec2f_dot(d, n)));
 }
+f32 vec2f_segment_sqr_dist(vec2f p, vec2f a, vec2f b) {
+    vec2f ab = vec2f_sub(b, a);
+    vec2f ap = vec2f_sub(p, a);
+
+    f32 len = vec2f_dot(ab, ab);
+    f32 t = len > 0.0f ? vec2f_dot(ap, ab) / len : 0.0f;
+    t = CLAMP(t, 0.0f, 1.0f);
+
+    return vec2f_sqr_dist(ap, vec2f_scl(ab, t));
+}
 
 cubic_bezier cbezier_create(vec2f p0, vec2f p1, vec2f p2, vec2f p3) {
     cubic_bezier out;
@@ -110,6 +175,24 @@ vec2f cbezier_calc(const cubic_bezier* bez, f32 t) {
     return out;
 }
 
+rectf viewf_bounding_box(viewf v) {
+    f32 half_w = v.width * 0.5f;
+    f32 half_h = v.width / v.aspect_ratio * 0.5f;
+
+    f32 r_sin = fabsf(sinf(v.rotation));
+    f32 r_cos = fabsf(cosf(v.rotation));
+
+    vec2f extent = {
+        half_w * r_cos + half_h * r_sin,
+        half_w * r_sin + half_h * r_cos,
+    };
+
+    return (rectf){
+        v.center.x - extent.x, v.center.y - extent.y,
+        extent.x * 2.0f, extent.y * 2.0f
+    };
+}
+
 void mat3f_transform(mat3f* mat, vec2f scale, vec2f offset, f32 rotation) {
     f32 r_sin = sinf(rotation);
     f32 r_cos = cosf(rotation);
@@ -167,6 +250,16 @@ void mat3f_inverse(mat3f* out, const mat3f* mat) {
     out->m[7] = (m[1] * m[6] - m[0] * m[7]) * inv_det;
     out->m[8] = (m[0] * m[4] - m[1] * m[3]) * inv_det;
 }
+void mat3f_mul(mat3f* out, const mat3f* a, const mat3f* b) {
+    for (u32 col = 0; col < 3; col++) {
+        for (u32 row = 0; row < 3; row++) {
+            out->m[row + col * 3] =
+                a->m[row + 0] * b->m[0 + col * 3] +
+                a->m[row + 3] * b->m[1 + col * 3] +
+                a->m[row + 6] * b->m[2 + col * 3];
+        }
+    }
+}
 vec2f mat3f_mul_vec2f(const mat3f* mat, vec2f vec) {
     vec2f out = { 0 };
 
@@ -10,6 +10,8 @@ typedef struct { f32 x, y, z, w; } vec4f;
 typedef struct { f32 x, y, w, h; } rectf;
 
 typedef struct { vec2f pos; f32 r; } circlef;
+// Everything within r of the segment from p0 to p1
+typedef struct { vec2f p0, p1; f32 r; } capsulef;
 
 typedef struct { f32 m[4];  } mat2f;
 typedef struct { f32 m[9];  } mat3f;
@@ -30,6 +32,10 @@ typedef struct {
 b32 vec2f_in_rectf(vec2f point, rectf rect);
 b32 rectf_collide_rectf(rectf a, rectf b);
 b32 rectf_collide_circlef(rectf rect, circlef circle);
+b32 rectf_collide_capsulef(rectf rect, capsulef capsule);
+// Squared distance between the closest points of the two rects, 0 if they touch
+// A point is a rect with no size
+f32 rectf_sqr_dist(rectf a, rectf b);
 
 vec2f vec2f_add(vec2f a, vec2f b);
 vec2f vec2f_sub(vec2f a, vec2f b);
@@ -46,14 +52,21 @@ vec2f vec2f_prp(vec2f v);
 b32 vec2f_eq(vec2f a, vec2f b);
 // Reflects d with normal of n
 vec2f vec2f_ref(vec2f d, vec2f n);
+// Squared distance from p to the closest point of the segment from a to b
+f32 vec2f_segment_sqr_dist(vec2f p, vec2f a, vec2f b);
 
 // Pass in control points
 cubic_bezier cbezier_create(vec2f p0, vec2f p1, vec2f p2, vec2f p3);
 vec2f cbezier_calc(const cubic_bezier* bez, f32 t);
 
+// Axis aligned box containing everything visible in the view
+rectf viewf_bounding_box(viewf v);
+
 void mat3f_transform(mat3f* mat, vec2f scale, vec2f offset, f32 rotation);
 void mat3f_from_view(mat3f* mat, viewf v);
 void mat3f_inverse(mat3f* out, const mat3f* mat);
+// out = a * b, so b is applied first. out cannot be a or b
+void mat3f_mul(mat3f* out, const mat3f* a, const mat3f* b);
 vec2f mat3f_mul_vec2f(const mat3f* mat, vec2f v);
 
 #endif // BASE_MATH_H
@@ -7,6 +7,19 @@
 
 #include "draw_lines.h"
 #include "draw_point_bucket.h"
+#include "draw_layer.h"
+#include "draw_tiles.h"
+#include "draw_predict.h"
+#include "draw_simplify.h"
+#include "draw_stroke.h"
+#include "draw_spline.h"
+#include "draw_query.h"
+#include "draw_history.h"
+#include "draw_file.h"
+#include "draw_journal.h"
+#include "draw_snapshot.h"
+#include "draw_loader.h"
+#include "draw_residency.h"
 
 #endif // DRAW_H
 
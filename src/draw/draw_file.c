@@ -0,0 +1,225 @@
+#include "draw_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "os/os.h"
+
+// Records are gathered into writes of about this size
+#define FILE_WRITE_SIZE MGA_MiB(1)
+
+static u32 _file_checksum(string8 data);
+static b32 _file_write(string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records);
+
+static draw_file_header _file_header = {
+    .magic = DRAW_FILE_MAGIC,
+    .version = DRAW_FILE_VERSION
+};
+
+string8 draw_file_header_str(void) {
+    return (string8){ .size = sizeof(draw_file_header), .str = (u8*)&_file_header };
+}
+b32 draw_file_read_header(string8* data) {
+    if (data->size < sizeof(draw_file_header)) {
+        return false;
+    }
+
+    draw_file_header header = { 0 };
+    memcpy(&header, data->str, sizeof(draw_file_header));
+
+    if (header.magic != DRAW_FILE_MAGIC || header.version != DRAW_FILE_VERSION) {
+        return false;
+    }
+
+    data->str += sizeof(draw_file_header);
+    data->size -= sizeof(draw_file_header);
+
+    return true;
+}
+
+string8 draw_record_push_stroke(mg_arena* arena, const draw_lines* lines, u32 id) {
+    b32 has_widths = lines->points.has_widths;
+    u32 num_points = lines->points.size;
+
+    u64 payload_size = sizeof(draw_record_stroke) + sizeof(vec2f) * num_points;
+    if (has_widths) {
+        payload_size += sizeof(f32) * num_points;
+    }
+
+    string8 out = {
+        .size = sizeof(draw_record_header) + payload_size,
+        .str = MGA_PUSH_ARRAY(arena, u8, sizeof(draw_record_header) + payload_size)
+    };
+
+    u8* payload = out.str + sizeof(draw_record_header);
+
+    draw_record_stroke stroke = {
+        .color = lines->color,
+        .width = lines->width,
+        .has_widths = has_widths,
+        .num_points = num_points,
+        .bounds = lines->bounding_box
+    };
+    memcpy(payload, &stroke, sizeof(draw_record_stroke));
+
+    vec2f* points = (vec2f*)(payload + sizeof(draw_record_stroke));
+    f32* widths = (f32*)(points + num_points);
+
+    u32 pos = 0;
+    for (const draw_point_node* node = lines->points.first; node != NULL; node = node->next) {
+        const draw_point_bucket* bucket = node->bucket;
+
+        memcpy(points + pos, bucket->points, sizeof(vec2f) * bucket->size);
+
+        if (has_widths) {
+            memcpy(widths + pos, bucket->widths->widths, sizeof(f32) * bucket->size);
+        }
+
+        pos += bucket->size;
+    }
+
+    draw_record_header header = {
+        .type = DRAW_RECORD_STROKE,
+        .id = id,
+        .size = (u32)payload_size,
+        .checksum = _file_checksum((string8){ .size = payload_size, .str = payload })
+    };
+    memcpy(out.str, &header, sizeof(draw_record_header));
+
+    return out;
+}
+string8 draw_record_push_remove(mg_arena* arena, u32 id) {
+    string8 out = {
+        .size = sizeof(draw_record_header),
+        .str = MGA_PUSH_ARRAY(arena, u8, sizeof(draw_record_header))
+    };
+
+    draw_record_header header = {
+        .type = DRAW_RECORD_REMOVE,
+        .id = id,
+        .size = 0,
+        .checksum = _file_checksum((string8){ 0 })
+    };
+    memcpy(out.str, &header, sizeof(draw_record_header));
+
+    return out;
+}
+
+b32 draw_file_save(string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records) {
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    string8 tmp_path = str8_pushf(scratch.arena, "%.*s.tmp", (int)path.size, path.str);
+    b32 written = _file_write(tmp_path, lines, num_lines, records) && os_file_replace(tmp_path, path);
+
+    mga_scratch_release(scratch);
+
+    return written;
+}
+
+b32 draw_record_next(string8* data, draw_record* record) {
+    if (data->size < sizeof(draw_record_header)) {
+        return false;
+    }
+
+    draw_record_header header = { 0 };
+    memcpy(&header, data->str, sizeof(draw_record_header));
+
+    if (header.size > data->size - sizeof(draw_record_header)) {
+        return false;
+    }
+
+    string8 payload = { .size = header.size, .str = data->str + sizeof(draw_record_header) };
+    if (_file_checksum(payload) != header.checksum) {
+        return false;
+    }
+
+    record->header = header;
+    record->payload = payload;
+
+    data->str += sizeof(draw_record_header) + header.size;
+    data->size -= sizeof(draw_record_header) + header.size;
+
+    return true;
+}
+b32 draw_record_read_stroke(const draw_record* record, draw_record_stroke* stroke, const vec2f** points, const f32** widths) {
+    if (record->header.type != DRAW_RECORD_STROKE || record->payload.size < sizeof(draw_record_stroke)) {
+        return false;
+    }
+
+    memcpy(stroke, record->payload.str, sizeof(draw_record_stroke));
+
+    u64 expected = sizeof(draw_record_stroke) + sizeof(vec2f) * (u64)stroke->num_points;
+    if (stroke->has_widths) {
+        expected += sizeof(f32) * (u64)stroke->num_points;
+    }
+
+    if (expected != record->payload.size || stroke->num_points == 0) {
+        return false;
+    }
+
+    *points = (const vec2f*)(record->payload.str + sizeof(draw_record_stroke));
+    *widths = stroke->has_widths ? (const f32*)(*points + stroke->num_points) : NULL;
+
+    return true;
+}
+
+static b32 _file_write(string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records) {
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    os_file* file = os_file_open(scratch.arena, path, OS_FILE_WRITE);
+    if (file == NULL) {
+        mga_scratch_release(scratch);
+        return false;
+    }
+
+    b32 written = os_file_write(file, draw_file_header_str());
+
+    u32 i = 0;
+    while (written && i < num_lines) {
+        mga_temp temp = mga_temp_begin(scratch.arena);
+
+        string8_list batch = { 0 };
+        while (i < num_lines && batch.total_size < FILE_WRITE_SIZE) {
+            str8_list_push(temp.arena, &batch, draw_record_push_stroke(temp.arena, lines[i], lines[i]->id));
+            i++;
+        }
+
+        written = os_file_write(file, str8_concat(temp.arena, batch));
+
+        mga_temp_end(temp);
+    }
+
+    // These are already records, they are only gathered into larger writes
+    const string8_node* node = records == NULL ? NULL : records->first;
+    while (written && node != NULL) {
+        mga_temp temp = mga_temp_begin(scratch.arena);
+
+        string8_list batch = { 0 };
+        while (node != NULL && batch.total_size < FILE_WRITE_SIZE) {
+            str8_list_push(temp.arena, &batch, node->str);
+            node = node->next;
+        }
+
+        written = os_file_write(file, str8_concat(temp.arena, batch));
+
+        mga_temp_end(temp);
+    }
+
+    written = written && os_file_sync(file);
+    os_file_close(file);
+
+    mga_scratch_release(scratch);
+
+    return written;
+}
+
+static u32 _file_checksum(string8 data) {
+    u32 hash = 2166136261u;
+
+    for (u64 i = 0; i < data.size; i++) {
+        hash ^= data.str[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
@@ -0,0 +1,73 @@
+#ifndef DRAW_FILE_H
+#define DRAW_FILE_H
+
+#include "base/base.h"
+#include "draw_lines.h"
+
+// Binary format of saved documents
+// A file is a header followed by records. Every record has its own size and checksum,
+// so a file that was cut off while writing can still be read up to the last whole record
+// Everything is little endian and four byte aligned
+
+#define DRAW_FILE_MAGIC 0x4b525453
+#define DRAW_FILE_VERSION 1
+
+typedef struct {
+    u32 magic;
+    u32 version;
+} draw_file_header;
+
+typedef enum {
+    // Adds the stroke with the id, or replaces it if there is one already
+    DRAW_RECORD_STROKE = 1,
+    // Removes the stroke with the id, the record has no payload
+    DRAW_RECORD_REMOVE = 2,
+} draw_record_type;
+
+typedef struct {
+    u32 type;
+    u32 id;
+    // Bytes of payload after the header
+    u32 size;
+    // FNV-1a of the payload
+    u32 checksum;
+} draw_record_header;
+
+// Payload of DRAW_RECORD_STROKE, followed by the points and then the widths if it has them
+typedef struct {
+    vec4f color;
+    f32 width;
+    u32 has_widths;
+    u32 num_points;
+    // Lets readers place the stroke without reading its points
+    rectf bounds;
+} draw_record_stroke;
+
+typedef struct {
+    draw_record_header header;
+    string8 payload;
+} draw_record;
+
+string8 draw_file_header_str(void);
+// Returns false if data does not start with a header of a version this can read
+// Moves data past the header
+b32 draw_file_read_header(string8* data);
+
+// Records are pushed on the arena
+string8 draw_record_push_stroke(mg_arena* arena, const draw_lines* lines, u32 id);
+string8 draw_record_push_remove(mg_arena* arena, u32 id);
+
+// Writes a file with a stroke record for each lines object to a temporary file next to path,
+// then replaces path with it once it is on the disk. Lines are written with their ids
+// records are written after the lines as they are, for strokes that are still records (see draw_loader.h)
+// records can be NULL. This only reads the points, so it can run on any thread while nothing changes them
+b32 draw_file_save(string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records);
+
+// Reads the next record and moves data past it
+// Returns false at the end of the data or at the first record that is cut off or damaged
+b32 draw_record_next(string8* data, draw_record* record);
+// Points into the payload of a stroke record, returns false if the payload does not match its header
+// widths is set to NULL if the stroke does not have them
+b32 draw_record_read_stroke(const draw_record* record, draw_record_stroke* stroke, const vec2f** points, const f32** widths);
+
+#endif // DRAW_FILE_H
@@ -0,0 +1,415 @@
+#include "draw_history.h"
+
+#include <stdio.h>
+
+static void _history_set_push(draw_history* history, draw_history_set* set, draw_lines* lines);
+static draw_lines* _history_set_pop(draw_history* history, draw_history_set* set);
+static void _history_set_clear(draw_history* history, draw_history_set* set);
+static u64 _history_set_size(const draw_history_set* set);
+static void _history_update_size(draw_history* history, draw_history_entry* entry);
+static void _history_drop(draw_history* history, draw_history_entry* entry);
+static void _history_compact(draw_history* history, const draw_history_entry* keep);
+static void _history_take_out(draw_lines** lines, u32* num_lines, const draw_history_set* set);
+static void _history_put_in(draw_lines** lines, u32* num_lines, const draw_history_set* set);
+static void _history_transform(const draw_history_set* set, const mat3f* transform);
+
+draw_history* draw_history_create(mg_arena* arena, u64 budget) {
+    draw_history* history = MGA_PUSH_ZERO_STRUCT(arena, draw_history);
+
+    history->arena = arena;
+    history->budget = budget;
+
+    return history;
+}
+void draw_history_destroy(draw_history* history) {
+    if (history == NULL) {
+        fprintf(stderr, "Cannot destroy NULL history\n");
+        return;
+    }
+
+    for (draw_history_entry* entry = history->first; entry != NULL; entry = entry->next) {
+        if (entry->type == DRAW_HISTORY_TRANSFORM) {
+            continue;
+        }
+
+        const draw_history_set* held = entry->done ? &entry->removed : &entry->added;
+
+        for (draw_history_chunk* chunk = held->first; chunk != NULL; chunk = chunk->next) {
+            for (u32 i = 0; i < chunk->size; i++) {
+                draw_lines_destroy(chunk->lines[i]);
+            }
+        }
+    }
+
+    for (draw_history_chunk* chunk = history->spare.first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            draw_lines_destroy(chunk->lines[i]);
+        }
+    }
+}
+
+draw_lines* draw_history_reuse(draw_history* history, vec4f col, f32 width) {
+    if (history == NULL) {
+        fprintf(stderr, "Cannot reuse lines of NULL history\n");
+        return NULL;
+    }
+
+    draw_lines* lines = _history_set_pop(history, &history->spare);
+
+    if (lines != NULL) {
+        draw_lines_reinit(lines, col, width);
+    }
+
+    return lines;
+}
+void draw_history_release(draw_history* history, draw_lines* lines) {
+    if (history == NULL || lines == NULL) {
+        fprintf(stderr, "Cannot release lines: history or lines is NULL\n");
+        return;
+    }
+
+    draw_lines_clear(lines);
+    draw_lines_evict(lines);
+    _history_set_push(history, &history->spare, lines);
+}
+
+draw_history_entry* draw_history_begin(draw_history* history, draw_history_type type) {
+    if (history == NULL) {
+        fprintf(stderr, "Cannot begin entry of NULL history\n");
+        return NULL;
+    }
+
+    // Nothing can be redone after a new operation
+    while (history->last != NULL && !history->last->done) {
+        _history_drop(history, history->last);
+    }
+
+    draw_history_entry* entry = history->free_entries;
+    if (entry != NULL) {
+        history->free_entries = entry->next;
+    } else {
+        entry = MGA_PUSH_STRUCT(history->arena, draw_history_entry);
+    }
+
+    *entry = (draw_history_entry){
+        .type = type,
+        .done = true,
+        .transform = { { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f } }
+    };
+
+    DLL_PUSH_BACK(history->first, history->last, entry);
+    history->current = entry;
+
+    return entry;
+}
+void draw_history_removed(draw_history* history, draw_history_entry* entry, draw_lines* lines) {
+    if (history == NULL || entry == NULL || lines == NULL) {
+        fprintf(stderr, "Cannot record removed lines: history, entry or lines is NULL\n");
+        return;
+    }
+
+    draw_lines_evict(lines);
+    _history_set_push(history, &entry->removed, lines);
+}
+void draw_history_added(draw_history* history, draw_history_entry* entry, draw_lines* lines) {
+    if (history == NULL || entry == NULL || lines == NULL) {
+        fprintf(stderr, "Cannot record added lines: history, entry or lines is NULL\n");
+        return;
+    }
+
+    _history_set_push(history, &entry->added, lines);
+}
+b32 draw_history_has_added(const draw_history_entry* entry, const draw_lines* lines) {
+    if (entry == NULL) {
+        return false;
+    }
+
+    for (draw_history_chunk* chunk = entry->added.first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            if (chunk->lines[i] == lines) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+void draw_history_drop_added(draw_history* history, draw_history_entry* entry, draw_lines* lines) {
+    if (history == NULL || entry == NULL || lines == NULL) {
+        fprintf(stderr, "Cannot drop added lines: history, entry or lines is NULL\n");
+        return;
+    }
+
+    for (draw_history_chunk* chunk = entry->added.first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            if (chunk->lines[i] != lines) {
+                continue;
+            }
+
+            // Sets are not ordered, so the lines popped off the front can take the place
+            draw_lines* other = _history_set_pop(history, &entry->added);
+            if (other != lines) {
+                chunk->lines[i] = other;
+            }
+
+            draw_history_release(history, lines);
+            return;
+        }
+    }
+
+    fprintf(stderr, "Cannot drop lines that the entry did not add\n");
+}
+void draw_history_end(draw_history* history, draw_history_entry* entry) {
+    if (history == NULL || entry == NULL) {
+        fprintf(stderr, "Cannot end entry: history or entry is NULL\n");
+        return;
+    }
+
+    if (entry->removed.size == 0 && entry->added.size == 0) {
+        _history_drop(history, entry);
+        return;
+    }
+
+    _history_update_size(history, entry);
+    _history_compact(history, NULL);
+}
+
+const draw_history_entry* draw_history_undo(draw_history* history, draw_lines** lines, u32* num_lines, u32 max_lines) {
+    if (history == NULL || lines == NULL || num_lines == NULL) {
+        fprintf(stderr, "Cannot undo: history, lines or num_lines is NULL\n");
+        return NULL;
+    }
+
+    draw_history_entry* entry = history->current;
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    if (entry->type == DRAW_HISTORY_TRANSFORM) {
+        mat3f inverse = { 0 };
+        mat3f_inverse(&inverse, &entry->transform);
+
+        _history_transform(&entry->added, &inverse);
+    } else {
+        if (*num_lines - entry->added.size + entry->removed.size > max_lines) {
+            fprintf(stderr, "Cannot undo: the document has no room for the lines\n");
+            return NULL;
+        }
+
+        _history_take_out(lines, num_lines, &entry->added);
+        _history_put_in(lines, num_lines, &entry->removed);
+    }
+
+    entry->done = false;
+    history->current = entry->prev;
+
+    _history_update_size(history, entry);
+    _history_compact(history, entry);
+
+    return entry;
+}
+const draw_history_entry* draw_history_redo(draw_history* history, draw_lines** lines, u32* num_lines, u32 max_lines) {
+    if (history == NULL || lines == NULL || num_lines == NULL) {
+        fprintf(stderr, "Cannot redo: history, lines or num_lines is NULL\n");
+        return NULL;
+    }
+
+    draw_history_entry* entry = history->current == NULL ? history->first : history->current->next;
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    if (entry->type == DRAW_HISTORY_TRANSFORM) {
+        _history_transform(&entry->added, &entry->transform);
+    } else {
+        if (*num_lines - entry->removed.size + entry->added.size > max_lines) {
+            fprintf(stderr, "Cannot redo: the document has no room for the lines\n");
+            return NULL;
+        }
+
+        _history_take_out(lines, num_lines, &entry->removed);
+        _history_put_in(lines, num_lines, &entry->added);
+    }
+
+    entry->done = true;
+    history->current = entry;
+
+    _history_update_size(history, entry);
+    _history_compact(history, entry);
+
+    return entry;
+}
+
+static void _history_set_push(draw_history* history, draw_history_set* set, draw_lines* lines) {
+    if (set->last == NULL || set->last->size == DRAW_HISTORY_CHUNK_SIZE) {
+        draw_history_chunk* chunk = history->free_chunks;
+
+        if (chunk != NULL) {
+            history->free_chunks = chunk->next;
+        } else {
+            chunk = MGA_PUSH_STRUCT(history->arena, draw_history_chunk);
+        }
+
+        chunk->size = 0;
+        SLL_PUSH_BACK(set->first, set->last, chunk);
+    }
+
+    set->last->lines[set->last->size++] = lines;
+    set->size++;
+}
+
+// Takes the lines from the front, the order of a set does not matter
+static draw_lines* _history_set_pop(draw_history* history, draw_history_set* set) {
+    draw_history_chunk* chunk = set->first;
+    if (chunk == NULL) {
+        return NULL;
+    }
+
+    draw_lines* lines = chunk->lines[--chunk->size];
+    set->size--;
+
+    if (chunk->size == 0) {
+        SLL_POP_FRONT(set->first, set->last);
+
+        chunk->next = history->free_chunks;
+        history->free_chunks = chunk;
+    }
+
+    return lines;
+}
+
+static void _history_set_clear(draw_history* history, draw_history_set* set) {
+    while (set->first != NULL) {
+        draw_history_chunk* chunk = set->first;
+        SLL_POP_FRONT(set->first, set->last);
+
+        chunk->next = history->free_chunks;
+        history->free_chunks = chunk;
+    }
+
+    set->size = 0;
+}
+
+static u64 _history_set_size(const draw_history_set* set) {
+    u64 size = 0;
+
+    for (draw_history_chunk* chunk = set->first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            // Nothing unless the lines were restored while out of the document
+            size += draw_lines_gpu_size(chunk->lines[i]);
+
+            for (draw_point_node* node = chunk->lines[i]->points.first; node != NULL; node = node->next) {
+                const draw_point_bucket* bucket = node->bucket;
+
+                // Shared buckets are split between the lists holding them
+                u64 bucket_size = sizeof(draw_point_bucket) + (bucket->widths != NULL ? sizeof(draw_width_bucket) : 0);
+                size += sizeof(draw_point_node) + bucket_size / bucket->refs;
+            }
+        }
+    }
+
+    return size;
+}
+
+static void _history_update_size(draw_history* history, draw_history_entry* entry) {
+    history->size -= entry->size;
+
+    if (entry->type == DRAW_HISTORY_TRANSFORM) {
+        entry->size = 0;
+    } else {
+        entry->size = _history_set_size(entry->done ? &entry->removed : &entry->added);
+    }
+
+    history->size += entry->size;
+}
+
+// Releases the lines only the entry refers to
+static void _history_drop(draw_history* history, draw_history_entry* entry) {
+    if (entry->type != DRAW_HISTORY_TRANSFORM) {
+        draw_history_set* held = entry->done ? &entry->removed : &entry->added;
+
+        for (draw_history_chunk* chunk = held->first; chunk != NULL; chunk = chunk->next) {
+            for (u32 i = 0; i < chunk->size; i++) {
+                draw_history_release(history, chunk->lines[i]);
+            }
+        }
+    }
+
+    _history_set_clear(history, &entry->removed);
+    _history_set_clear(history, &entry->added);
+
+    if (history->current == entry) {
+        history->current = entry->prev;
+    }
+
+    history->size -= entry->size;
+
+    DLL_REMOVE(history->first, history->last, entry);
+
+    entry->next = history->free_entries;
+    history->free_entries = entry;
+}
+
+static void _history_compact(draw_history* history, const draw_history_entry* keep) {
+    // Oldest entries first, then the undone entries that are furthest from being redone
+    while (history->size > history->budget && history->first != NULL &&
+        history->first != keep && history->first->done) {
+        _history_drop(history, history->first);
+    }
+    while (history->size > history->budget && history->last != NULL &&
+        history->last != keep && !history->last->done) {
+        _history_drop(history, history->last);
+    }
+}
+
+// Removes the lines in set from the document, keeping the order of the rest
+// Only the lines after the first one taken out move
+static void _history_take_out(draw_lines** lines, u32* num_lines, const draw_history_set* set) {
+    u32 first = *num_lines;
+
+    for (draw_history_chunk* chunk = set->first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            u32 slot = chunk->lines[i]->slot;
+
+            if (slot >= *num_lines || lines[slot] != chunk->lines[i]) {
+                fprintf(stderr, "Cannot take lines out of the document: their slot is out of date\n");
+                continue;
+            }
+
+            draw_lines_evict(lines[slot]);
+            lines[slot] = NULL;
+            first = MIN(first, slot);
+        }
+    }
+
+    u32 num_kept = first;
+    for (u32 i = first; i < *num_lines; i++) {
+        if (lines[i] != NULL) {
+            lines[num_kept] = lines[i];
+            lines[num_kept]->slot = num_kept;
+            num_kept++;
+        }
+    }
+    *num_lines = num_kept;
+}
+
+static void _history_put_in(draw_lines** lines, u32* num_lines, const draw_history_set* set) {
+    for (draw_history_chunk* chunk = set->first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            // Undone and redone lines are usually still in view
+            draw_lines_restore(chunk->lines[i]);
+
+            chunk->lines[i]->slot = *num_lines;
+            lines[(*num_lines)++] = chunk->lines[i];
+        }
+    }
+}
+
+static void _history_transform(const draw_history_set* set, const mat3f* transform) {
+    for (draw_history_chunk* chunk = set->first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            draw_lines_set_transform(chunk->lines[i], transform);
+            draw_lines_apply_transform(chunk->lines[i]);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#ifndef DRAW_HISTORY_H
+#define DRAW_HISTORY_H
+
+#include "base/base.h"
+#include "draw_lines.h"
+
+// Undo and redo for a document that is an array of lines objects
+// Entries refer to whole lines objects instead of copying their points.
+// Lines taken out of the document stay alive in the history with their buckets,
+// so undoing an entry only moves pointers between the history and the document.
+// Their geometry is evicted while they are out (see draw_lines_evict), as it is for the spare lines.
+// Once the lines only the history refers to take up more than the budget, the oldest entries are dropped
+
+// Lines per chunk of a set
+#define DRAW_HISTORY_CHUNK_SIZE 32
+
+typedef struct draw_history_chunk {
+    u32 size;
+    draw_lines* lines[DRAW_HISTORY_CHUNK_SIZE];
+    struct draw_history_chunk* next;
+} draw_history_chunk;
+
+typedef struct {
+    u32 size;
+
+    draw_history_chunk* first;
+    draw_history_chunk* last;
+} draw_history_set;
+
+typedef enum {
+    // added is the new stroke
+    DRAW_HISTORY_ADD,
+    // removed has the lines the eraser hit, added has the pieces that were left of them
+    DRAW_HISTORY_ERASE,
+    // added has the lines that were moved by transform
+    DRAW_HISTORY_TRANSFORM,
+} draw_history_type;
+
+typedef struct draw_history_entry {
+    struct draw_history_entry* prev;
+    struct draw_history_entry* next;
+
+    draw_history_type type;
+    b32 done;
+
+    // Lines the operation took out of the document and lines it put in
+    draw_history_set removed;
+    draw_history_set added;
+
+    mat3f transform;
+
+    // Bytes of points and geometry that only the history refers to,
+    // those of removed while the entry is done and those of added while it is undone
+    u64 size;
+} draw_history_entry;
+
+typedef struct {
+    mg_arena* arena;
+
+    u64 budget;
+    u64 size;
+
+    // Oldest first, the undone entries are at the end
+    draw_history_entry* first;
+    draw_history_entry* last;
+    // Newest entry that is done, NULL if there is none
+    draw_history_entry* current;
+
+    // Free lists
+    draw_history_entry* free_entries;
+    draw_history_chunk* free_chunks;
+
+    // Lines that nothing refers to anymore, cleared and ready to be reused
+    draw_history_set spare;
+} draw_history;
+
+// budget is in bytes of point buckets and geometry
+draw_history* draw_history_create(mg_arena* arena, u64 budget);
+// Destroys every lines object that is not in the document
+void draw_history_destroy(draw_history* history);
+
+// Empty lines from the spare lines, NULL if there are none
+draw_lines* draw_history_reuse(draw_history* history, vec4f col, f32 width);
+// Clears and evicts lines that are not needed anymore and keeps them for draw_history_reuse
+void draw_history_release(draw_history* history, draw_lines* lines);
+
+// Starts recording an entry, everything that was undone is dropped
+// Only one entry can be recording at a time, and it cannot be undone until it ends
+draw_history_entry* draw_history_begin(draw_history* history, draw_history_type type);
+// The caller takes lines out of the document, the history keeps them and evicts them
+void draw_history_removed(draw_history* history, draw_history_entry* entry, draw_lines* lines);
+// The caller puts lines in the document
+void draw_history_added(draw_history* history, draw_history_entry* entry, draw_lines* lines);
+// Whether lines were added by the entry, like pieces split off earlier in the same erase
+b32 draw_history_has_added(const draw_history_entry* entry, const draw_lines* lines);
+// Lines the entry added and that were then emptied again, they are released
+void draw_history_drop_added(draw_history* history, draw_history_entry* entry, draw_lines* lines);
+// Entries that did not change anything are dropped
+// Older entries are dropped until the history fits in its budget again
+void draw_history_end(draw_history* history, draw_history_entry* entry);
+
+// These change the document, which has room for max_lines lines
+// Lines are found in the document by their slot, so the caller has to keep the slots of the lines
+// in the document up to date. The lines put back in the document go at the end of it, restored
+// Returns the entry that was undone or redone so the caller can update what depends on its lines,
+// or NULL if there is nothing to undo or redo
+const draw_history_entry* draw_history_undo(draw_history* history, draw_lines** lines, u32* num_lines, u32 max_lines);
+const draw_history_entry* draw_history_redo(draw_history* history, draw_lines** lines, u32* num_lines, u32 max_lines);
+
+#endif // DRAW_HISTORY_H
@@ -0,0 +1,214 @@
+#include "draw_journal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "os/os.h"
+#include "draw_file.h"
+
+typedef struct draw_journal {
+    os_file* file;
+    u32 next_id;
+
+    os_mutex* mutex;
+    os_condvar* cond;
+    // NULL if the platform does not have threads, then records are written right away
+    os_thread* thread;
+    b32 closing;
+
+    // Filled by the calling thread, the writer swaps the two arenas for each batch
+    mg_arena* pending_arena;
+    string8_list pending;
+    mg_arena* writing_arena;
+} draw_journal;
+
+static void _journal_push(draw_journal* journal, b32 stroke, draw_lines* lines, u32 id);
+static void _journal_writer(void* journal_ptr);
+
+draw_journal* draw_journal_open(mg_arena* arena, string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records) {
+    u32 next_id = 1;
+    for (u32 i = 0; i < num_lines; i++) {
+        next_id = MAX(next_id, lines[i]->id + 1);
+    }
+    for (const string8_node* node = records == NULL ? NULL : records->first; node != NULL; node = node->next) {
+        draw_record_header header = { 0 };
+        memcpy(&header, node->str.str, sizeof(draw_record_header));
+
+        next_id = MAX(next_id, header.id + 1);
+    }
+    for (u32 i = 0; i < num_lines; i++) {
+        if (lines[i]->id == 0) {
+            lines[i]->id = next_id++;
+        }
+    }
+
+    // The journal is only replaced once the whole snapshot is on the disk
+    if (!draw_file_save(path, lines, num_lines, records)) {
+        fprintf(stderr, "Cannot open journal: failed to write snapshot to \"%.*s\"\n", (int)path.size, path.str);
+        return NULL;
+    }
+
+    os_file* file = os_file_open(arena, path, OS_FILE_APPEND);
+    if (file == NULL) {
+        return NULL;
+    }
+
+    mga_desc desc = {
+        .desired_max_size = MGA_MiB(256),
+        .desired_block_size = MGA_KiB(256)
+    };
+
+    draw_journal* journal = MGA_PUSH_ZERO_STRUCT(arena, draw_journal);
+
+    journal->file = file;
+    journal->next_id = next_id;
+
+    journal->pending_arena = mga_create(&desc);
+    journal->writing_arena = mga_create(&desc);
+
+    journal->mutex = os_mutex_create(arena);
+    journal->cond = os_condvar_create(arena);
+    journal->thread = os_thread_create(arena, _journal_writer, journal);
+
+    return journal;
+}
+void draw_journal_close(draw_journal* journal) {
+    if (journal == NULL) {
+        fprintf(stderr, "Cannot close NULL journal\n");
+        return;
+    }
+
+    if (journal->thread != NULL) {
+        os_mutex_lock(journal->mutex);
+        journal->closing = true;
+        os_condvar_signal(journal->cond);
+        os_mutex_unlock(journal->mutex);
+
+        os_thread_join(journal->thread);
+    } else {
+        os_file_sync(journal->file);
+    }
+
+    os_file_close(journal->file);
+
+    os_condvar_destroy(journal->cond);
+    os_mutex_destroy(journal->mutex);
+
+    mga_destroy(journal->pending_arena);
+    mga_destroy(journal->writing_arena);
+}
+
+void draw_journal_put(draw_journal* journal, draw_lines* lines) {
+    if (journal == NULL || lines == NULL) {
+        fprintf(stderr, "Cannot put lines in journal: journal or lines is NULL\n");
+        return;
+    }
+
+    if (lines->id == 0) {
+        lines->id = journal->next_id++;
+    }
+
+    _journal_push(journal, true, lines, lines->id);
+}
+void draw_journal_remove(draw_journal* journal, const draw_lines* lines) {
+    if (journal == NULL || lines == NULL) {
+        fprintf(stderr, "Cannot remove lines from journal: journal or lines is NULL\n");
+        return;
+    }
+
+    // Lines that were never saved are not in the journal
+    if (lines->id == 0) {
+        return;
+    }
+
+    _journal_push(journal, false, NULL, lines->id);
+}
+
+static void _journal_push(draw_journal* journal, b32 stroke, draw_lines* lines, u32 id) {
+    if (journal->thread == NULL) {
+        string8 record = stroke ?
+            draw_record_push_stroke(journal->pending_arena, lines, id) :
+            draw_record_push_remove(journal->pending_arena, id);
+
+        if (!os_file_write(journal->file, record)) {
+            fprintf(stderr, "Failed to write journal record\n");
+        }
+
+        mga_reset(journal->pending_arena);
+        return;
+    }
+
+    os_mutex_lock(journal->mutex);
+
+    string8 record = stroke ?
+        draw_record_push_stroke(journal->pending_arena, lines, id) :
+        draw_record_push_remove(journal->pending_arena, id);
+
+    // The writer only has to wake up for the first record of a batch
+    if (journal->pending.node_count == 0) {
+        os_condvar_signal(journal->cond);
+    }
+    str8_list_push(journal->pending_arena, &journal->pending, record);
+
+    os_mutex_unlock(journal->mutex);
+}
+
+static void _journal_writer(void* journal_ptr) {
+    draw_journal* journal = (draw_journal*)journal_ptr;
+
+    b32 unsynced = false;
+    u64 last_sync = os_now_usec();
+
+    os_mutex_lock(journal->mutex);
+
+    while (true) {
+        if (journal->pending.node_count == 0 && !journal->closing) {
+            // Waiting for records, or for long enough that the last batch should be synced
+            b32 signaled = os_condvar_wait(
+                journal->cond, journal->mutex, unsynced ? DRAW_JOURNAL_SYNC_MS : OS_WAIT_INFINITE
+            );
+
+            if (signaled && !journal->closing) {
+                // Strokes usually come with other records, like an erase with its pieces
+                os_mutex_unlock(journal->mutex);
+                os_sleep_ms(DRAW_JOURNAL_BATCH_MS);
+                os_mutex_lock(journal->mutex);
+            }
+        }
+
+        b32 closing = journal->closing;
+
+        string8_list batch = journal->pending;
+        mg_arena* batch_arena = journal->pending_arena;
+
+        journal->pending = (string8_list){ 0 };
+        journal->pending_arena = journal->writing_arena;
+        journal->writing_arena = batch_arena;
+
+        os_mutex_unlock(journal->mutex);
+
+        if (batch.node_count > 0) {
+            if (!os_file_write(journal->file, str8_concat(batch_arena, batch))) {
+                fprintf(stderr, "Failed to write journal records\n");
+            }
+
+            unsynced = true;
+        }
+
+        mga_reset(batch_arena);
+
+        u64 now = os_now_usec();
+        if (unsynced && (closing || batch.node_count == 0 || now - last_sync >= DRAW_JOURNAL_SYNC_MS * 1000)) {
+            os_file_sync(journal->file);
+
+            unsynced = false;
+            last_sync = now;
+        }
+
+        if (closing) {
+            break;
+        }
+
+        os_mutex_lock(journal->mutex);
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef DRAW_JOURNAL_H
+#define DRAW_JOURNAL_H
+
+#include "base/base.h"
+#include "draw_lines.h"
+
+// Append-only autosave of a document
+// Every change is appended to the journal as stroke and remove records (see draw_file.h),
+// so saving costs as much as the change and not as much as the document.
+// A writer thread batches the records into few writes and syncs them to the disk periodically.
+// On startup the journal is loaded like any other document with draw_loader,
+// then rewritten with only the strokes that are left
+
+// Records that come in this soon after the first one are written with it
+#define DRAW_JOURNAL_BATCH_MS 50
+// Longest time written records can go without being synced to the disk
+#define DRAW_JOURNAL_SYNC_MS 1000
+
+// Contents defined in draw_journal.c
+typedef struct draw_journal draw_journal;
+
+// Replaces the journal at path with one that only has the strokes in lines and records, then keeps appending to it
+// records are strokes that are not built yet, it can be NULL. Lines that do not have an id get one
+// Returns NULL if the journal cannot be written
+draw_journal* draw_journal_open(mg_arena* arena, string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records);
+// Writes and syncs everything that is left
+void draw_journal_close(draw_journal* journal);
+
+// The lines were added to the document or their points changed, they get an id if they do not have one
+void draw_journal_put(draw_journal* journal, draw_lines* lines);
+// The lines were taken out of the document
+void draw_journal_remove(draw_journal* journal, const draw_lines* lines);
+
+#endif // DRAW_JOURNAL_H
@@ -0,0 +1,42 @@
+#ifndef DRAW_LAYER_H
+#define DRAW_LAYER_H
+
+#include "base/base.h"
+#include "gfx/gfx.h"
+
+// Contents defined in draw backends
+typedef struct draw_layer_shaders draw_layer_shaders;
+
+draw_layer_shaders* draw_layer_shaders_create(mg_arena* arena);
+void draw_layer_shaders_destroy(draw_layer_shaders* shaders);
+
+// Offscreen render target
+// Used for caching content that does not change every frame
+typedef struct {
+    u32 width, height;
+    // 0 for layers that are not multisampled
+    u32 samples;
+
+    struct _draw_layer_backend* backend;
+} draw_layer;
+
+// samples should match the window for layers that are drawn over it pixel for pixel, 0 or 1 turns it off
+draw_layer* draw_layer_create(mg_arena* arena, u32 width, u32 height, u32 samples);
+void draw_layer_destroy(draw_layer* layer);
+
+// Reallocates the layer storage if the size is different
+// The contents of the layer are undefined after a resize
+void draw_layer_resize(draw_layer* layer, u32 width, u32 height);
+
+// Makes the layer the current render target and clears it
+void draw_layer_begin(draw_layer* layer);
+// Makes the window the current render target again
+void draw_layer_end(draw_layer* layer, const gfx_window* win);
+
+// Draws the layer over the whole window, replacing the current window contents
+void draw_layer_draw_window(const draw_layer* layer, const draw_layer_shaders* shaders);
+// Draws the layer stretched over rect, which is in world space
+void draw_layer_draw(const draw_layer* layer, const draw_layer_shaders* shaders, rectf rect, viewf view);
+
+#endif // DRAW_LAYER_H
+
@@ -2,9 +2,30 @@
 #define DRAW_LINES_H
 
 #include "base/base.h"
+#include "base/base_jobs.h"
 #include "draw_point_bucket.h"
 #include "gfx/gfx.h"
 
+// Simplified levels kept per lines object for zoomed out views
+#define DRAW_LINES_MAX_LODS 4
+// Tolerance of the first level as a fraction of the line width
+#define DRAW_LINES_LOD_BASE_TOLERANCE 0.1f
+// Each level multiplies the tolerance by this
+#define DRAW_LINES_LOD_STEP 4.0f
+// A level is only kept if it has at most this fraction of the points of the level before it
+#define DRAW_LINES_LOD_MIN_REDUCTION 0.75f
+// Largest error allowed on screen when picking a level, in pixels
+#define DRAW_LINES_LOD_PIXEL_TOLERANCE 0.5f
+
+// Most pieces the vertex shader splits one curve segment into
+#define DRAW_LINES_CURVE_MAX_PIECES 32
+// Largest distance between the drawn pieces and the curve, in pixels
+#define DRAW_LINES_CURVE_PIXEL_TOLERANCE 0.25f
+// Largest distance between the points and the curves fitted to them, in pixels at the zoom they are fit for
+#define DRAW_LINES_CURVE_FIT_PIXELS 0.5f
+// Curves are fit again once zooming in makes their error this many times larger
+#define DRAW_LINES_CURVE_REFIT_RATIO 2.0f
+
 // Contents defined in draw backends
 typedef struct draw_lines_shaders draw_lines_shaders;
 
@@ -12,20 +33,57 @@ draw_lines_shaders* draw_lines_shaders_create(mg_arena* arena);
 void draw_lines_shaders_destroy(draw_lines_shaders* shaders);
 
 typedef struct {
+    // Identifies the lines in saved documents, 0 until they are saved
+    u32 id;
+
     vec4f color;
+    // For lines with point widths, this is the largest width a point can have
     f32 width;
 
     // This will not always be 100% accurate, but it should always contain the lines
+    // It does not include the transform
     rectf bounding_box;
 
+    // Applied when drawing, the points and geometry stay where they are until draw_lines_apply_transform
+    b32 has_transform;
+    mat3f transform;
+
     draw_point_allocator* allocator;
     draw_point_list points;
 
+    // Set while a snapshot shares the point list, see draw_snapshot.h
+    struct draw_snapshot_stroke* snapshot;
+
+    // Last frame the lines were near the view, see draw_residency.h
+    u64 last_seen_frame;
+    // Index of the lines in the document, kept up to date by whoever owns the document, see draw_history.h
+    u32 slot;
+
     struct _draw_lines_backend* backend;
 } draw_lines;
 
 // Creates lines with the specified points
 draw_lines* draw_lines_from_points(mg_arena* arena, draw_point_allocator* allocator, vec2f* points, u32 num_points, vec4f col, f32 line_width);
+
+typedef struct {
+    const vec2f* points;
+    // Optional, one width per point, each at most width
+    const f32* widths;
+    u32 num_points;
+
+    vec4f color;
+    f32 width;
+} draw_lines_desc;
+
+// Creates num_lines lines objects at once, for loading whole documents
+// Points are copied and tessellated on the job system,
+// then the calling thread creates and fills all the buffers
+// The lines are treated as finished, so their LODs are built as well.
+// With a curve_tolerance above 0, curves are fit on the job system too (see draw_lines_build_curves),
+// and lines that get curves are not tessellated
+// out needs room for num_lines pointers
+// Returns false without creating any lines if a desc has no points or memory runs out
+b32 draw_lines_load(mg_arena* arena, draw_point_allocator* allocator, jobs_system* jobs, const draw_lines_desc* descs, u32 num_lines, f32 curve_tolerance, draw_lines** out);
 // Creates an empty lines object
 draw_lines* draw_lines_create(mg_arena* arena, draw_point_allocator* allocator, vec4f col, f32 line_width);
 void draw_lines_destroy(draw_lines* lines);
@@ -33,14 +91,72 @@ void draw_lines_destroy(draw_lines* lines);
 // Deletes all the points
 void draw_lines_clear(draw_lines* lines);
 void draw_lines_reinit(draw_lines* lines, vec4f col, f32 width);
+// Switches between one width for the whole lines and a width per point, the lines have to be empty
+// Lines with point widths do not build LODs
+void draw_lines_use_point_widths(draw_lines* lines, b32 enabled);
+// Replaces the contents of lines with a copy of the points, color and width of src
+// The two share the point buckets, and a bucket is only copied once one of them changes it
+// LODs, curves and the transform are not copied
+void draw_lines_copy(draw_lines* lines, const draw_lines* src);
+// Same as above, but lines also takes over the geometry, LODs, curves and transform of src,
+// so nothing is tessellated again. src keeps its points and is left evicted (see draw_lines_evict).
+// For replacing lines in the document with an object that can change while src stays as it was
+void draw_lines_take(draw_lines* lines, draw_lines* src);
 
 void draw_lines_draw(const draw_lines* lines, const draw_lines_shaders* shaders, const gfx_window* win, viewf view);
+
+// Moves the lines on the GPU without touching the points, for dragging selections around
+// transform can be NULL to remove it. It should only rotate, scale uniformly and move,
+// the line widths are scaled along with it
+void draw_lines_set_transform(draw_lines* lines, const mat3f* transform);
+// Moves the points with the transform and tessellates them again, then removes the transform
+// LODs and curves are discarded
+void draw_lines_apply_transform(draw_lines* lines);
 // Updates the geometry of the lines with the new color and width
 void draw_lines_update(draw_lines* lines, vec4f col, f32 line_width);
 void draw_lines_add_point(draw_lines* lines, vec2f point);
 void draw_lines_change_last(draw_lines* lines, vec2f new_last);
+// Same as above for lines with point widths, width is clamped to lines->width
+// Lines without point widths ignore the width
+void draw_lines_add_point_width(draw_lines* lines, vec2f point, f32 width);
+void draw_lines_change_last_width(draw_lines* lines, vec2f new_last, f32 width);
+
+// Builds simplified versions of the lines that draw_lines_draw picks from when zoomed out
+// Call this once the lines are finished, adding or changing points discards them
+void draw_lines_build_lods(draw_lines* lines);
+
+// Fits cubic Bezier segments to the finished lines, tolerance is in world units
+// From then on the vertex shader evaluates the segments at the detail the zoom needs,
+// and the tessellated geometry and LODs are deleted until adding or changing points discards the curves
+void draw_lines_build_curves(draw_lines* lines, f32 tolerance);
+// Fits the curves again for the zoom of the view once it is DRAW_LINES_CURVE_REFIT_RATIO times closer
+// than the one they were fit for. Call this before drawing, returns true if the curves were fit again
+b32 draw_lines_refit_curves(draw_lines* lines, const gfx_window* win, viewf view);
+
+// Bytes of GPU memory the geometry of the lines takes up, 0 if they are evicted
+u64 draw_lines_gpu_size(const draw_lines* lines);
+b32 draw_lines_is_evicted(const draw_lines* lines);
+// Deletes the geometry on the GPU and keeps the points
+// Evicted lines are not drawn, everything else works on them as before.
+// Functions that only rewrite part of the geometry restore the lines first
+void draw_lines_evict(draw_lines* lines);
+// Fits the curves of evicted lines again, lines without curves get their geometry and LODs back
+void draw_lines_restore(draw_lines* lines);
 
 b32 draw_lines_collide_circle(draw_lines* lines, circlef circle);
+// For the path of a moving circle, like the eraser between two frames
+b32 draw_lines_collide_capsule(draw_lines* lines, capsulef capsule);
+
+// Cuts out the first part of the lines that is within the circle, using the same reach as draw_lines_collide_circle
+// The lines keep the points before the cut and the points after it are moved to rest,
+// so a stroke ends up as zero, one or two strokes. Buckets are split and moved instead of copied,
+// and only the end of the kept geometry is rewritten
+// rest has to be empty and share the point allocator, it can be NULL to drop the points after the cut
+// rest can reach into the circle again, so callers should keep erasing it until this returns false
+// Returns false if nothing was erased
+b32 draw_lines_erase_circle(draw_lines* lines, circlef circle, draw_lines* rest);
+// Same as above for everything the circle passed over between two positions
+b32 draw_lines_erase_capsule(draw_lines* lines, capsulef capsule, draw_lines* rest);
 
 #endif // DRAW_LINES_H
 
@@ -0,0 +1,304 @@
+#include "draw_loader.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "os/os.h"
+#include "draw_file.h"
+
+typedef struct {
+    u32 id;
+    b32 built;
+    u32 num_points;
+
+    // Includes the line width, so it can be tested against views directly
+    rectf bounds;
+    // Squared distance from the view the document was opened with
+    f32 dist;
+
+    draw_record record;
+} _loader_stroke;
+
+typedef struct draw_loader {
+    // Holds the loader, the file and the strokes
+    mg_arena* arena;
+
+    _loader_stroke* strokes;
+    u32 num_strokes;
+    u32 num_pending;
+    // Strokes before this are built, it only moves forward
+    u32 first_pending;
+
+    // Nothing in reach of this view was left after the last update
+    b32 has_idle_view;
+    viewf idle_view;
+} draw_loader;
+
+// Used to find the last record of every id
+typedef struct {
+    u32 id;
+    u32 index;
+    draw_record record;
+} _loader_slot;
+
+static int _loader_slot_cmp(const void* a, const void* b);
+static int _loader_stroke_cmp(const void* a, const void* b);
+static b32 _loader_view_eq(viewf a, viewf b);
+
+draw_loader* draw_loader_open(string8 path, viewf view) {
+    mga_desc desc = {
+        .desired_max_size = MGA_GiB(1),
+        .desired_block_size = MGA_MiB(1)
+    };
+    mg_arena* arena = mga_create(&desc);
+    if (arena == NULL) {
+        fprintf(stderr, "Cannot open document: failed to create arena\n");
+        return NULL;
+    }
+
+    string8 data = os_file_read_all(arena, path);
+
+    if (data.size == 0) {
+        mga_destroy(arena);
+        return NULL;
+    }
+    if (!draw_file_read_header(&data)) {
+        fprintf(stderr, "Cannot open document: \"%.*s\" is not a document\n", (int)path.size, path.str);
+        mga_destroy(arena);
+        return NULL;
+    }
+
+    u32 num_records = 0;
+    string8 counting = data;
+    draw_record record = { 0 };
+    while (draw_record_next(&counting, &record)) {
+        num_records++;
+    }
+
+    if (counting.size > 0) {
+        fprintf(stderr, "Document ends with a damaged record, %llu bytes are dropped\n", (unsigned long long)counting.size);
+    }
+
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+
+    _loader_slot* slots = MGA_PUSH_ARRAY(scratch.arena, _loader_slot, num_records);
+    for (u32 i = 0; i < num_records; i++) {
+        draw_record_next(&data, &record);
+        slots[i] = (_loader_slot){ .id = record.header.id, .index = i, .record = record };
+    }
+
+    // The last record of each id decides whether the stroke is in the document
+    qsort(slots, num_records, sizeof(_loader_slot), _loader_slot_cmp);
+
+    draw_loader* loader = MGA_PUSH_ZERO_STRUCT(arena, draw_loader);
+    loader->arena = arena;
+    loader->strokes = MGA_PUSH_ARRAY(arena, _loader_stroke, num_records);
+
+    rectf view_rect = viewf_bounding_box(view);
+
+    for (u32 i = 0; i < num_records; i++) {
+        if (i + 1 < num_records && slots[i + 1].id == slots[i].id) {
+            continue;
+        }
+        if (slots[i].record.header.type != DRAW_RECORD_STROKE) {
+            continue;
+        }
+
+        draw_record_stroke stroke = { 0 };
+        const vec2f* points = NULL;
+        const f32* widths = NULL;
+        if (!draw_record_read_stroke(&slots[i].record, &stroke, &points, &widths)) {
+            fprintf(stderr, "Cannot load stroke %u: record does not match its header\n", slots[i].id);
+            continue;
+        }
+        if (stroke.num_points == 0) {
+            fprintf(stderr, "Cannot load stroke %u: stroke has no points\n", slots[i].id);
+            continue;
+        }
+
+        loader->strokes[loader->num_strokes++] = (_loader_stroke){
+            .id = slots[i].id,
+            .num_points = stroke.num_points,
+            .bounds = stroke.bounds,
+            .dist = rectf_sqr_dist(stroke.bounds, view_rect),
+            .record = slots[i].record
+        };
+    }
+
+    mga_scratch_release(scratch);
+
+    qsort(loader->strokes, loader->num_strokes, sizeof(_loader_stroke), _loader_stroke_cmp);
+
+    loader->num_pending = loader->num_strokes;
+
+    return loader;
+}
+void draw_loader_destroy(draw_loader* loader) {
+    if (loader == NULL) {
+        fprintf(stderr, "Cannot destroy NULL loader\n");
+        return;
+    }
+
+    mga_destroy(loader->arena);
+}
+
+u32 draw_loader_update(draw_loader* loader, viewf view, f32 curve_tolerance, u32 max_points, draw_point_allocator* allocator, jobs_system* jobs, mg_arena* arena, draw_lines** out, u32 max_lines) {
+    if (loader == NULL || out == NULL) {
+        fprintf(stderr, "Cannot update loader: loader or out is NULL\n");
+        return 0;
+    }
+
+    if (loader->num_pending == 0 || max_lines == 0) {
+        return 0;
+    }
+    // Scanning the strokes again would not find anything
+    if (loader->has_idle_view && _loader_view_eq(view, loader->idle_view)) {
+        return 0;
+    }
+
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+
+    rectf view_rect = viewf_bounding_box(view);
+    rectf reach = {
+        view_rect.x - view_rect.w * DRAW_LOADER_PREFETCH,
+        view_rect.y - view_rect.h * DRAW_LOADER_PREFETCH,
+        view_rect.w * (1.0f + 2.0f * DRAW_LOADER_PREFETCH),
+        view_rect.h * (1.0f + 2.0f * DRAW_LOADER_PREFETCH)
+    };
+
+    u32* picked = MGA_PUSH_ARRAY(scratch.arena, u32, MIN(loader->num_pending, max_lines));
+    u32 num_picked = 0;
+    u64 num_points = 0;
+    b32 full = false;
+
+    // Strokes in view first, then the ones within reach
+    // The strokes are in order of distance from the first view, which is the order they were meant to load in
+    for (u32 pass = 0; pass < 2 && !full; pass++) {
+        rectf area = pass == 0 ? view_rect : reach;
+
+        for (u32 i = loader->first_pending; i < loader->num_strokes; i++) {
+            _loader_stroke* stroke = &loader->strokes[i];
+
+            if (stroke->built || !rectf_collide_rectf(stroke->bounds, area)) {
+                continue;
+            }
+
+            if (num_picked > 0 && num_points + stroke->num_points > max_points) {
+                full = true;
+                break;
+            }
+
+            // Marked right away so the second pass skips it
+            stroke->built = true;
+            picked[num_picked++] = i;
+            num_points += stroke->num_points;
+
+            if (num_picked == max_lines) {
+                full = true;
+                break;
+            }
+        }
+    }
+
+    if (num_picked == 0) {
+        loader->has_idle_view = true;
+        loader->idle_view = view;
+
+        mga_scratch_release(scratch);
+        return 0;
+    }
+
+    loader->has_idle_view = false;
+
+    draw_lines_desc* descs = MGA_PUSH_ARRAY(scratch.arena, draw_lines_desc, num_picked);
+
+    for (u32 i = 0; i < num_picked; i++) {
+        draw_record_stroke stroke = { 0 };
+        const vec2f* points = NULL;
+        const f32* widths = NULL;
+        draw_record_read_stroke(&loader->strokes[picked[i]].record, &stroke, &points, &widths);
+
+        descs[i] = (draw_lines_desc){
+            .points = points,
+            .widths = widths,
+            .num_points = stroke.num_points,
+            .color = stroke.color,
+            .width = stroke.width
+        };
+    }
+
+    if (!draw_lines_load(arena, allocator, jobs, descs, num_picked, curve_tolerance, out)) {
+        // The strokes stay pending so a later update tries them again
+        for (u32 i = 0; i < num_picked; i++) {
+            loader->strokes[picked[i]].built = false;
+        }
+
+        mga_scratch_release(scratch);
+        return 0;
+    }
+
+    for (u32 i = 0; i < num_picked; i++) {
+        out[i]->id = loader->strokes[picked[i]].id;
+    }
+
+    loader->num_pending -= num_picked;
+    while (loader->first_pending < loader->num_strokes && loader->strokes[loader->first_pending].built) {
+        loader->first_pending++;
+    }
+
+    mga_scratch_release(scratch);
+
+    return num_picked;
+}
+
+u32 draw_loader_num_pending(const draw_loader* loader) {
+    return loader == NULL ? 0 : loader->num_pending;
+}
+void draw_loader_pending(const draw_loader* loader, mg_arena* arena, string8_list* records) {
+    if (loader == NULL || records == NULL) {
+        fprintf(stderr, "Cannot get pending records: loader or records is NULL\n");
+        return;
+    }
+
+    for (u32 i = loader->first_pending; i < loader->num_strokes; i++) {
+        const _loader_stroke* stroke = &loader->strokes[i];
+
+        if (stroke->built) {
+            continue;
+        }
+
+        // The header is right before the payload in the file
+        string8 record = {
+            .size = sizeof(draw_record_header) + stroke->record.payload.size,
+            .str = stroke->record.payload.str - sizeof(draw_record_header)
+        };
+        str8_list_push(arena, records, record);
+    }
+}
+
+static int _loader_slot_cmp(const void* a, const void* b) {
+    const _loader_slot* slot_a = (const _loader_slot*)a;
+    const _loader_slot* slot_b = (const _loader_slot*)b;
+
+    if (slot_a->id != slot_b->id) {
+        return slot_a->id < slot_b->id ? -1 : 1;
+    }
+
+    return slot_a->index < slot_b->index ? -1 : (slot_a->index > slot_b->index);
+}
+// By distance and then by id, so strokes at the same distance load in the order they were drawn
+static int _loader_stroke_cmp(const void* a, const void* b) {
+    const _loader_stroke* stroke_a = (const _loader_stroke*)a;
+    const _loader_stroke* stroke_b = (const _loader_stroke*)b;
+
+    if (stroke_a->dist != stroke_b->dist) {
+        return stroke_a->dist < stroke_b->dist ? -1 : 1;
+    }
+
+    return stroke_a->id < stroke_b->id ? -1 : (stroke_a->id > stroke_b->id);
+}
+
+static b32 _loader_view_eq(viewf a, viewf b) {
+    return vec2f_eq(a.center, b.center) && a.width == b.width &&
+        a.aspect_ratio == b.aspect_ratio && a.rotation == b.rotation;
+}
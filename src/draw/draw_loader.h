@@ -0,0 +1,39 @@
+#ifndef DRAW_LOADER_H
+#define DRAW_LOADER_H
+
+#include "base/base.h"
+#include "base/base_jobs.h"
+#include "draw_lines.h"
+
+// Progressive loading of saved documents
+// Opening a document only reads the file and indexes its records, the strokes are built over many frames.
+// Every update builds the strokes in view first, then the ones near the view,
+// in order of distance from the view the document was opened with.
+// Strokes far from anything that was looked at stay as the records they were saved as,
+// which are much smaller than built lines, and are written back as they are when the document is saved
+
+// How far past each side of the view strokes are built ahead of time, as a fraction of the view size
+#define DRAW_LOADER_PREFETCH 1.0f
+
+// Contents defined in draw_loader.c
+typedef struct draw_loader draw_loader;
+
+// Returns NULL if there is no file at path or it is not a document
+// Later records replace earlier ones with the same id, so journals load like any other document.
+// Reading stops at the first damaged record, which is where the app stopped if it died while writing a journal
+draw_loader* draw_loader_open(string8 path, viewf view);
+// Frees the records, which the records pushed by draw_loader_pending point to
+void draw_loader_destroy(draw_loader* loader);
+
+// Builds strokes worth about max_points points, at least one if there is any in reach of the view
+// The strokes get curves fit with curve_tolerance, 0 leaves them tessellated (see draw_lines_load)
+// out needs room for max_lines pointers, the lines objects are pushed on arena
+// Returns the number of lines created, 0 if loading failed
+u32 draw_loader_update(draw_loader* loader, viewf view, f32 curve_tolerance, u32 max_points, draw_point_allocator* allocator, jobs_system* jobs, mg_arena* arena, draw_lines** out, u32 max_lines);
+
+// Strokes that are still records
+u32 draw_loader_num_pending(const draw_loader* loader);
+// Pushes the records of the strokes that are not built yet onto records, for saving them
+void draw_loader_pending(const draw_loader* loader, mg_arena* arena, string8_list* records);
+
+#endif // DRAW_LOADER_H
@@ -50,6 +50,9 @@ draw_point_bucket* draw_point_alloc_alloc(draw_point_allocator* point_alloc) {
         SLL_POP_FRONT(point_alloc->free_first, point_alloc->free_last);
 
         out->size = 0;
+        out->bounds = (rectf){ 0 };
+        out->widths = NULL;
+        out->refs = 1;
         out->next = NULL;
         memset(out->points, 0, sizeof(vec2f) * DRAW_POINT_BUCKET_SIZE);
 
@@ -57,6 +60,7 @@ draw_point_bucket* draw_point_alloc_alloc(draw_point_allocator* point_alloc) {
     }
 
     draw_point_bucket* out = MGA_PUSH_ZERO_STRUCT(point_alloc->backing_arena, draw_point_bucket);
+    out->refs = 1;
 
     return out;
 }
@@ -69,25 +73,147 @@ void draw_point_alloc_free(draw_point_allocator* point_alloc, draw_point_bucket*
     SLL_PUSH_FRONT(point_alloc->free_first, point_alloc->free_last, bucket);
 }
 
+draw_width_bucket* draw_point_alloc_alloc_widths(draw_point_allocator* point_alloc) {
+    if (point_alloc == NULL) {
+        fprintf(stderr, "Cannot alloc widths with NULL point allocator\n");
+        return NULL;
+    }
+
+    if (point_alloc->width_free_first != NULL) {
+        draw_width_bucket* out = point_alloc->width_free_first;
+
+        SLL_POP_FRONT(point_alloc->width_free_first, point_alloc->width_free_last);
+
+        out->next = NULL;
+        memset(out->widths, 0, sizeof(f32) * DRAW_POINT_BUCKET_SIZE);
+
+        return out;
+    }
+
+    draw_width_bucket* out = MGA_PUSH_ZERO_STRUCT(point_alloc->backing_arena, draw_width_bucket);
+
+    return out;
+}
+void draw_point_alloc_free_widths(draw_point_allocator* point_alloc, draw_width_bucket* widths) {
+    if (point_alloc == NULL) {
+        fprintf(stderr, "Cannot free widths with NULL point allocator\n");
+        return;
+    }
+
+    SLL_PUSH_FRONT(point_alloc->width_free_first, point_alloc->width_free_last, widths);
+}
+
+draw_point_node* draw_point_alloc_alloc_node(draw_point_allocator* point_alloc) {
+    if (point_alloc == NULL) {
+        fprintf(stderr, "Cannot alloc node with NULL point allocator\n");
+        return NULL;
+    }
+
+    if (point_alloc->node_free_first != NULL) {
+        draw_point_node* out = point_alloc->node_free_first;
+
+        SLL_POP_FRONT(point_alloc->node_free_first, point_alloc->node_free_last);
+
+        *out = (draw_point_node){ 0 };
+
+        return out;
+    }
+
+    draw_point_node* out = MGA_PUSH_ZERO_STRUCT(point_alloc->backing_arena, draw_point_node);
+
+    return out;
+}
+void draw_point_alloc_free_node(draw_point_allocator* point_alloc, draw_point_node* node) {
+    if (point_alloc == NULL) {
+        fprintf(stderr, "Cannot free node with NULL point allocator\n");
+        return;
+    }
+
+    SLL_PUSH_FRONT(point_alloc->node_free_first, point_alloc->node_free_last, node);
+}
+
+void draw_point_bucket_release(draw_point_allocator* point_alloc, draw_point_bucket* bucket) {
+    if (point_alloc == NULL || bucket == NULL) {
+        fprintf(stderr, "Cannot release bucket: point allocator or bucket is NULL\n");
+        return;
+    }
+
+    if (--bucket->refs > 0) {
+        return;
+    }
+
+    if (bucket->widths != NULL) {
+        draw_point_alloc_free_widths(point_alloc, bucket->widths);
+    }
+
+    draw_point_alloc_free(point_alloc, bucket);
+}
+
+void draw_point_bucket_update_bounds(draw_point_bucket* bucket) {
+    if (bucket->size == 0) {
+        bucket->bounds = (rectf){ 0 };
+        return;
+    }
+
+    vec2f min_p = bucket->points[0];
+    vec2f max_p = bucket->points[0];
+
+    for (u32 i = 1; i < bucket->size; i++) {
+        min_p.x = MIN(min_p.x, bucket->points[i].x);
+        min_p.y = MIN(min_p.y, bucket->points[i].y);
+        max_p.x = MAX(max_p.x, bucket->points[i].x);
+        max_p.y = MAX(max_p.y, bucket->points[i].y);
+    }
+
+    bucket->bounds = (rectf){ min_p.x, min_p.y, max_p.x - min_p.x, max_p.y - min_p.y };
+}
+void draw_point_bucket_expand_bounds(draw_point_bucket* bucket, vec2f point) {
+    rectf* b = &bucket->bounds;
+
+    // The bounds of the first point are the point itself
+    if (bucket->size <= 1) {
+        *b = (rectf){ point.x, point.y, 0.0f, 0.0f };
+        return;
+    }
+
+    f32 max_x = MAX(b->x + b->w, point.x);
+    f32 max_y = MAX(b->y + b->h, point.y);
+
+    b->x = MIN(b->x, point.x);
+    b->y = MIN(b->y, point.y);
+    b->w = max_x - b->x;
+    b->h = max_y - b->y;
+}
+
 void draw_point_list_add(draw_point_list* list, vec2f point) {
+    draw_point_list_add_width(list, point, 0.0f);
+}
+void draw_point_list_add_width(draw_point_list* list, vec2f point, f32 width) {
     if (list == NULL) {
         fprintf(stderr, "Cannot add point to NULL list\n");
         return;
     }
 
-    list->size++;
-
-    if (list->last == NULL || list->last->size == DRAW_POINT_BUCKET_SIZE) {
+    if (list->last == NULL || list->last->bucket->size == DRAW_POINT_BUCKET_SIZE) {
         draw_point_bucket* bucket = draw_point_alloc_alloc(list->allocator);
-        bucket->size = 1;
-        bucket->points[0] = point;
 
-        SLL_PUSH_BACK(list->first, list->last, bucket);
+        if (list->has_widths) {
+            bucket->widths = draw_point_alloc_alloc_widths(list->allocator);
+        }
 
-        return;
+        draw_point_list_push(list, bucket);
+    }
+
+    list->size++;
+
+    draw_point_bucket* last = draw_point_list_own(list, list->last);
+
+    if (list->has_widths) {
+        last->widths->widths[last->size] = width;
     }
 
-    list->last->points[list->last->size++] = point;
+    last->points[last->size++] = point;
+    draw_point_bucket_expand_bounds(last, point);
 }
 void draw_point_list_clear(draw_point_list* list) {
     if (list == NULL) {
@@ -96,12 +222,68 @@ void draw_point_list_clear(draw_point_list* list) {
     }
 
     while (list->first != NULL) {
-        draw_point_bucket* bucket = list->first;
+        draw_point_node* node = list->first;
         SLL_POP_FRONT(list->first, list->last);
 
-        draw_point_alloc_free(list->allocator, bucket);
+        draw_point_bucket_release(list->allocator, node->bucket);
+        draw_point_alloc_free_node(list->allocator, node);
     }
 
     list->size = 0;
 }
 
+void draw_point_list_push(draw_point_list* list, draw_point_bucket* bucket) {
+    if (list == NULL || bucket == NULL) {
+        fprintf(stderr, "Cannot push bucket: list or bucket is NULL\n");
+        return;
+    }
+
+    draw_point_node* node = draw_point_alloc_alloc_node(list->allocator);
+    node->bucket = bucket;
+
+    SLL_PUSH_BACK(list->first, list->last, node);
+    list->size += bucket->size;
+}
+void draw_point_list_share(draw_point_list* list, const draw_point_list* src) {
+    if (list == NULL || src == NULL) {
+        fprintf(stderr, "Cannot share points: list or src is NULL\n");
+        return;
+    }
+    if (list->allocator != src->allocator) {
+        fprintf(stderr, "Cannot share points between lists with different allocators\n");
+        return;
+    }
+
+    for (draw_point_node* node = src->first; node != NULL; node = node->next) {
+        node->bucket->refs++;
+        draw_point_list_push(list, node->bucket);
+    }
+}
+draw_point_bucket* draw_point_list_own(draw_point_list* list, draw_point_node* node) {
+    if (list == NULL || node == NULL) {
+        fprintf(stderr, "Cannot own bucket: list or node is NULL\n");
+        return NULL;
+    }
+
+    draw_point_bucket* shared = node->bucket;
+    if (shared->refs == 1) {
+        return shared;
+    }
+
+    draw_point_bucket* bucket = draw_point_alloc_alloc(list->allocator);
+
+    bucket->size = shared->size;
+    bucket->bounds = shared->bounds;
+    memcpy(bucket->points, shared->points, sizeof(vec2f) * shared->size);
+
+    if (shared->widths != NULL) {
+        bucket->widths = draw_point_alloc_alloc_widths(list->allocator);
+        memcpy(bucket->widths->widths, shared->widths->widths, sizeof(f32) * shared->size);
+    }
+
+    draw_point_bucket_release(list->allocator, shared);
+    node->bucket = bucket;
+
+    return bucket;
+}
+
@@ -6,12 +6,34 @@
 // Right now, this value is arbitrary
 #define DRAW_POINT_BUCKET_SIZE 64
 
+// Per-point widths, kept next to the point bucket they belong to
+// Only lists with has_widths set have these, so constant width lists do not pay for them
+typedef struct draw_width_bucket {
+    f32 widths[DRAW_POINT_BUCKET_SIZE];
+    // Only used by the free list
+    struct draw_width_bucket* next;
+} draw_width_bucket;
+
 typedef struct draw_point_bucket {
     u32 size;
     vec2f points[DRAW_POINT_BUCKET_SIZE];
+    // Contains every point in the bucket, without the line width
+    // Removing points does not shrink it, so it can be larger than the points
+    rectf bounds;
+    // NULL unless the list has widths
+    draw_width_bucket* widths;
+    // Number of nodes pointing to the bucket, which only changes while it has one
+    u32 refs;
+    // Only used by the free list
     struct draw_point_bucket* next;
 } draw_point_bucket;
 
+// Lists link their buckets through nodes, so the same bucket can be in more than one list
+typedef struct draw_point_node {
+    draw_point_bucket* bucket;
+    struct draw_point_node* next;
+} draw_point_node;
+
 typedef struct {
     b32 owned_arena;
     mg_arena* backing_arena;
@@ -19,25 +41,59 @@ typedef struct {
     // Free list
     draw_point_bucket* free_first;
     draw_point_bucket* free_last;
+
+    draw_width_bucket* width_free_first;
+    draw_width_bucket* width_free_last;
+
+    draw_point_node* node_free_first;
+    draw_point_node* node_free_last;
 } draw_point_allocator;
 
 typedef struct {
     u32 size;
+    // Every bucket has a width bucket
+    b32 has_widths;
 
     draw_point_allocator* allocator;
 
-    draw_point_bucket* first;
-    draw_point_bucket* last;
+    draw_point_node* first;
+    draw_point_node* last;
 } draw_point_list;
 
 // backing_arena can be NULL
 draw_point_allocator* draw_point_alloc_create(mg_arena* backing_arena);
 void draw_point_alloc_destroy(draw_point_allocator* point_alloc);
+// New buckets have one reference
 draw_point_bucket* draw_point_alloc_alloc(draw_point_allocator* point_alloc);
 void draw_point_alloc_free(draw_point_allocator* point_alloc, draw_point_bucket* bucket);
+draw_width_bucket* draw_point_alloc_alloc_widths(draw_point_allocator* point_alloc);
+void draw_point_alloc_free_widths(draw_point_allocator* point_alloc, draw_width_bucket* widths);
+draw_point_node* draw_point_alloc_alloc_node(draw_point_allocator* point_alloc);
+void draw_point_alloc_free_node(draw_point_allocator* point_alloc, draw_point_node* node);
+
+// Drops a reference to the bucket, it is freed with its widths once there are none left
+void draw_point_bucket_release(draw_point_allocator* point_alloc, draw_point_bucket* bucket);
+
+// Code that writes bucket points directly has to keep the bounds up to date with these
+// Recomputes the bounds from the points in the bucket
+void draw_point_bucket_update_bounds(draw_point_bucket* bucket);
+// Grows the bounds to contain point, which has to be in the bucket already
+void draw_point_bucket_expand_bounds(draw_point_bucket* bucket, vec2f point);
 
 // Create point lists on the stack
+// Points added without a width get a width of zero in lists with widths
 void draw_point_list_add(draw_point_list* list, vec2f point);
+// The width is ignored if the list does not have widths
+void draw_point_list_add_width(draw_point_list* list, vec2f point, f32 width);
+// Releases every bucket of the list
 void draw_point_list_clear(draw_point_list* list);
 
+// Appends a new bucket, the list takes over its reference
+void draw_point_list_push(draw_point_list* list, draw_point_bucket* bucket);
+// Appends the buckets of src without copying them, both lists need the same allocator
+void draw_point_list_share(draw_point_list* list, const draw_point_list* src);
+// Call this before changing the points of the bucket in node
+// A bucket that other lists share is replaced with a copy first. Returns the bucket of the node
+draw_point_bucket* draw_point_list_own(draw_point_list* list, draw_point_node* node);
+
 #endif // DRAW_POINT_BUCKET_H
@@ -0,0 +1,142 @@
+#include "draw_predict.h"
+
+#include <stdio.h>
+#include <math.h>
+
+static const draw_predict_sample* _predict_get(const draw_predictor* pred, u32 age);
+
+void draw_predict_reset(draw_predictor* pred) {
+    if (pred == NULL) {
+        fprintf(stderr, "Cannot reset NULL predictor\n");
+        return;
+    }
+
+    pred->next = 0;
+    pred->num_samples = 0;
+}
+
+void draw_predict_add_sample(draw_predictor* pred, vec2f pos, u64 time_usec) {
+    if (pred == NULL) {
+        fprintf(stderr, "Cannot add sample to NULL predictor\n");
+        return;
+    }
+
+    // Samples with the same timestamp add nothing to the fit
+    if (pred->num_samples > 0 && _predict_get(pred, 0)->time_usec >= time_usec) {
+        pred->samples[(pred->next + DRAW_PREDICT_HISTORY - 1) % DRAW_PREDICT_HISTORY].pos = pos;
+        return;
+    }
+
+    pred->samples[pred->next] = (draw_predict_sample){ pos, time_usec };
+    pred->next = (pred->next + 1) % DRAW_PREDICT_HISTORY;
+    pred->num_samples = MIN(pred->num_samples + 1, DRAW_PREDICT_HISTORY);
+}
+
+vec2f draw_predict_point(const draw_predictor* pred, u64 lead_usec, f32 max_dist) {
+    if (pred == NULL || pred->num_samples == 0) {
+        fprintf(stderr, "Cannot predict point: predictor is NULL or has no samples\n");
+        return (vec2f){ 0 };
+    }
+
+    const draw_predict_sample* newest = _predict_get(pred, 0);
+
+    // Times are in seconds relative to the newest sample, so they are all <= 0
+    f32 s[5] = { 0 };
+    vec2f sy[3] = { 0 };
+    u32 n = 0;
+
+    for (u32 i = 0; i < pred->num_samples; i++) {
+        const draw_predict_sample* sample = _predict_get(pred, i);
+
+        if (newest->time_usec - sample->time_usec > DRAW_PREDICT_WINDOW_USEC) {
+            break;
+        }
+
+        f32 t = -(f32)(newest->time_usec - sample->time_usec) / 1e6f;
+        f32 tn = 1.0f;
+
+        for (u32 j = 0; j < 5; j++) {
+            s[j] += tn;
+
+            if (j < 3) {
+                sy[j] = vec2f_add(sy[j], vec2f_scl(sample->pos, tn));
+            }
+
+            tn *= t;
+        }
+
+        n++;
+    }
+
+    if (n < 2) {
+        return newest->pos;
+    }
+
+    // p(t) = a + bt + ct^2, b is the velocity at the newest sample and 2c is the acceleration
+    vec2f a = newest->pos;
+    vec2f b = { 0 };
+    vec2f c = { 0 };
+
+    // Least squares normal equations, solved with Cramer's rule
+    f32 det = s[0] * (s[2] * s[4] - s[3] * s[3]) -
+        s[1] * (s[1] * s[4] - s[3] * s[2]) +
+        s[2] * (s[1] * s[3] - s[2] * s[2]);
+
+    if (n >= 3 && fabsf(det) > 1e-18f) {
+        f32 inv_det = 1.0f / det;
+
+        for (u32 axis = 0; axis < 2; axis++) {
+            f32 y0 = axis == 0 ? sy[0].x : sy[0].y;
+            f32 y1 = axis == 0 ? sy[1].x : sy[1].y;
+            f32 y2 = axis == 0 ? sy[2].x : sy[2].y;
+
+            f32 ca = (y0 * (s[2] * s[4] - s[3] * s[3]) -
+                s[1] * (y1 * s[4] - s[3] * y2) +
+                s[2] * (y1 * s[3] - s[2] * y2)) * inv_det;
+            f32 cb = (s[0] * (y1 * s[4] - y2 * s[3]) -
+                y0 * (s[1] * s[4] - s[3] * s[2]) +
+                s[2] * (s[1] * y2 - y1 * s[2])) * inv_det;
+            f32 cc = (s[0] * (s[2] * y2 - s[3] * y1) -
+                s[1] * (s[1] * y2 - y1 * s[2]) +
+                y0 * (s[1] * s[3] - s[2] * s[2])) * inv_det;
+
+            if (axis == 0) {
+                a.x = ca; b.x = cb; c.x = cc;
+            } else {
+                a.y = ca; b.y = cb; c.y = cc;
+            }
+        }
+    } else {
+        // Not enough samples for a curve, falling back to the last two
+        const draw_predict_sample* prev = _predict_get(pred, 1);
+        f32 dt = (f32)(newest->time_usec - prev->time_usec) / 1e6f;
+
+        b = vec2f_scl(vec2f_sub(newest->pos, prev->pos), 1.0f / dt);
+    }
+
+    f32 lead = (f32)lead_usec / 1e6f;
+
+    vec2f predicted = a;
+    predicted = vec2f_add(predicted, vec2f_scl(b, lead));
+    predicted = vec2f_add(predicted, vec2f_scl(c, lead * lead * DRAW_PREDICT_ACCEL_SCALE));
+
+    vec2f offset = vec2f_sub(predicted, newest->pos);
+
+    f32 speed = vec2f_len(b);
+    f32 confidence = (speed - DRAW_PREDICT_MIN_SPEED) / (DRAW_PREDICT_FULL_SPEED - DRAW_PREDICT_MIN_SPEED);
+    confidence = CLAMP(confidence, 0.0f, 1.0f);
+
+    offset = vec2f_scl(offset, confidence);
+
+    f32 dist = vec2f_len(offset);
+    if (dist > max_dist) {
+        offset = vec2f_scl(offset, max_dist / dist);
+    }
+
+    return vec2f_add(newest->pos, offset);
+}
+
+// age 0 is the newest sample
+static const draw_predict_sample* _predict_get(const draw_predictor* pred, u32 age) {
+    return &pred->samples[(pred->next + DRAW_PREDICT_HISTORY - 1 - age) % DRAW_PREDICT_HISTORY];
+}
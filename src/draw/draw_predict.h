@@ -0,0 +1,40 @@
+#ifndef DRAW_PREDICT_H
+#define DRAW_PREDICT_H
+
+#include "base/base.h"
+
+// Number of input samples kept for fitting
+#define DRAW_PREDICT_HISTORY 8
+// Samples older than this (relative to the newest one) are ignored
+#define DRAW_PREDICT_WINDOW_USEC 50000
+// Below this speed the pen is treated as still, in units per second
+#define DRAW_PREDICT_MIN_SPEED 60.0f
+// At this speed and above the full prediction is used, in units per second
+#define DRAW_PREDICT_FULL_SPEED 600.0f
+// Acceleration overshoots on sharp turns, so only part of it is used
+#define DRAW_PREDICT_ACCEL_SCALE 0.5f
+
+typedef struct {
+    vec2f pos;
+    u64 time_usec;
+} draw_predict_sample;
+
+// Extrapolates the pen position from the most recent input samples
+// A quadratic is fit to the samples, and the prediction is faded out at low speeds
+// where sensor noise would make the tail jitter.
+typedef struct {
+    // Ring buffer, next is where the next sample goes
+    draw_predict_sample samples[DRAW_PREDICT_HISTORY];
+    u32 next;
+    u32 num_samples;
+} draw_predictor;
+
+void draw_predict_reset(draw_predictor* pred);
+void draw_predict_add_sample(draw_predictor* pred, vec2f pos, u64 time_usec);
+
+// Predicts the position lead_usec after the newest sample
+// The prediction is never further than max_dist from the newest sample
+// Returns the newest sample if there is not enough history
+vec2f draw_predict_point(const draw_predictor* pred, u64 lead_usec, f32 max_dist);
+
+#endif // DRAW_PREDICT_H
@@ -0,0 +1,753 @@
+#include "draw_query.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+
+// Every kernel is written once against these wrappers
+#if defined(__AVX2__)
+
+#include <immintrin.h>
+
+#define QUERY_LANES 8
+typedef __m256 _qv;
+
+static inline _qv _qv_set1(f32 v) { return _mm256_set1_ps(v); }
+static inline _qv _qv_add(_qv a, _qv b) { return _mm256_add_ps(a, b); }
+static inline _qv _qv_sub(_qv a, _qv b) { return _mm256_sub_ps(a, b); }
+static inline _qv _qv_mul(_qv a, _qv b) { return _mm256_mul_ps(a, b); }
+static inline _qv _qv_div(_qv a, _qv b) { return _mm256_div_ps(a, b); }
+static inline _qv _qv_min(_qv a, _qv b) { return _mm256_min_ps(a, b); }
+static inline _qv _qv_max(_qv a, _qv b) { return _mm256_max_ps(a, b); }
+// Lanes are all ones where the comparison holds
+static inline _qv _qv_lt(_qv a, _qv b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline _qv _qv_and(_qv a, _qv b) { return _mm256_and_ps(a, b); }
+static inline _qv _qv_andnot(_qv mask, _qv a) { return _mm256_andnot_ps(mask, a); }
+static inline _qv _qv_xor(_qv a, _qv b) { return _mm256_xor_ps(a, b); }
+static inline b32 _qv_any(_qv mask) { return _mm256_movemask_ps(mask) != 0; }
+static inline void _qv_store(f32* out, _qv a) { _mm256_storeu_ps(out, a); }
+
+// Splits QUERY_LANES interleaved points into their x and y coordinates
+static inline void _qv_load_points(const vec2f* points, _qv* x, _qv* y) {
+    __m256 a = _mm256_loadu_ps((const f32*)points);
+    __m256 b = _mm256_loadu_ps((const f32*)points + 8);
+
+    // The shuffles work within 128 bit halves, the permutes put the halves back in order
+    __m256 xs = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    __m256 ys = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+    *x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(xs), _MM_SHUFFLE(3, 1, 2, 0)));
+    *y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(ys), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+#include <emmintrin.h>
+
+#define QUERY_LANES 4
+typedef __m128 _qv;
+
+static inline _qv _qv_set1(f32 v) { return _mm_set1_ps(v); }
+static inline _qv _qv_add(_qv a, _qv b) { return _mm_add_ps(a, b); }
+static inline _qv _qv_sub(_qv a, _qv b) { return _mm_sub_ps(a, b); }
+static inline _qv _qv_mul(_qv a, _qv b) { return _mm_mul_ps(a, b); }
+static inline _qv _qv_div(_qv a, _qv b) { return _mm_div_ps(a, b); }
+static inline _qv _qv_min(_qv a, _qv b) { return _mm_min_ps(a, b); }
+static inline _qv _qv_max(_qv a, _qv b) { return _mm_max_ps(a, b); }
+static inline _qv _qv_lt(_qv a, _qv b) { return _mm_cmplt_ps(a, b); }
+static inline _qv _qv_and(_qv a, _qv b) { return _mm_and_ps(a, b); }
+static inline _qv _qv_andnot(_qv mask, _qv a) { return _mm_andnot_ps(mask, a); }
+static inline _qv _qv_xor(_qv a, _qv b) { return _mm_xor_ps(a, b); }
+static inline b32 _qv_any(_qv mask) { return _mm_movemask_ps(mask) != 0; }
+static inline void _qv_store(f32* out, _qv a) { _mm_storeu_ps(out, a); }
+
+static inline void _qv_load_points(const vec2f* points, _qv* x, _qv* y) {
+    __m128 a = _mm_loadu_ps((const f32*)points);
+    __m128 b = _mm_loadu_ps((const f32*)points + 4);
+
+    *x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    *y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+#else
+
+#define QUERY_LANES 1
+typedef f32 _qv;
+
+static inline _qv _qv_set1(f32 v) { return v; }
+static inline _qv _qv_add(_qv a, _qv b) { return a + b; }
+static inline _qv _qv_sub(_qv a, _qv b) { return a - b; }
+static inline _qv _qv_mul(_qv a, _qv b) { return a * b; }
+static inline _qv _qv_div(_qv a, _qv b) { return a / b; }
+static inline _qv _qv_min(_qv a, _qv b) { return MIN(a, b); }
+static inline _qv _qv_max(_qv a, _qv b) { return MAX(a, b); }
+// Masks are 1 or 0 here, which the other functions treat the same way
+static inline _qv _qv_lt(_qv a, _qv b) { return a < b ? 1.0f : 0.0f; }
+static inline _qv _qv_and(_qv a, _qv b) { return a != 0.0f && b != 0.0f ? 1.0f : 0.0f; }
+static inline _qv _qv_andnot(_qv mask, _qv a) { return mask != 0.0f ? 0.0f : a; }
+static inline _qv _qv_xor(_qv a, _qv b) { return (a != 0.0f) != (b != 0.0f) ? 1.0f : 0.0f; }
+static inline b32 _qv_any(_qv mask) { return mask != 0.0f; }
+static inline void _qv_store(f32* out, _qv a) { *out = a; }
+
+static inline void _qv_load_points(const vec2f* points, _qv* x, _qv* y) {
+    *x = points->x;
+    *y = points->y;
+}
+
+#endif
+
+// Squared distance from p to segment ab, and how far along ab the closest point is
+static inline _qv _qv_point_segment(_qv px, _qv py, _qv ax, _qv ay, _qv bx, _qv by, _qv* t_out) {
+    _qv abx = _qv_sub(bx, ax);
+    _qv aby = _qv_sub(by, ay);
+    _qv apx = _qv_sub(px, ax);
+    _qv apy = _qv_sub(py, ay);
+
+    _qv len = _qv_add(_qv_mul(abx, abx), _qv_mul(aby, aby));
+    // Segments with zero length leave t at zero
+    _qv t = _qv_div(_qv_add(_qv_mul(apx, abx), _qv_mul(apy, aby)), _qv_max(len, _qv_set1(1e-12f)));
+    t = _qv_min(_qv_max(t, _qv_set1(0.0f)), _qv_set1(1.0f));
+
+    _qv dx = _qv_sub(apx, _qv_mul(abx, t));
+    _qv dy = _qv_sub(apy, _qv_mul(aby, t));
+
+    if (t_out != NULL) {
+        *t_out = t;
+    }
+
+    return _qv_add(_qv_mul(dx, dx), _qv_mul(dy, dy));
+}
+
+// Squared distance between segments ab and cd
+// Unless they cross, the closest points include an end point of one of them,
+// so it is the smallest of four point to segment distances
+static inline _qv _qv_segment_segment(_qv ax, _qv ay, _qv bx, _qv by, _qv cx, _qv cy, _qv dx, _qv dy) {
+    _qv d0 = _qv_point_segment(ax, ay, cx, cy, dx, dy, NULL);
+    _qv d1 = _qv_point_segment(bx, by, cx, cy, dx, dy, NULL);
+    _qv d2 = _qv_point_segment(cx, cy, ax, ay, bx, by, NULL);
+    _qv d3 = _qv_point_segment(dx, dy, ax, ay, bx, by, NULL);
+
+    _qv d = _qv_min(_qv_min(d0, d1), _qv_min(d2, d3));
+
+    // The ends of each segment are on opposite sides of the other one
+    _qv cdx = _qv_sub(dx, cx);
+    _qv cdy = _qv_sub(dy, cy);
+    _qv abx = _qv_sub(bx, ax);
+    _qv aby = _qv_sub(by, ay);
+
+    _qv s0 = _qv_sub(_qv_mul(cdx, _qv_sub(ay, cy)), _qv_mul(cdy, _qv_sub(ax, cx)));
+    _qv s1 = _qv_sub(_qv_mul(cdx, _qv_sub(by, cy)), _qv_mul(cdy, _qv_sub(bx, cx)));
+    _qv s2 = _qv_sub(_qv_mul(abx, _qv_sub(cy, ay)), _qv_mul(aby, _qv_sub(cx, ax)));
+    _qv s3 = _qv_sub(_qv_mul(abx, _qv_sub(dy, ay)), _qv_mul(aby, _qv_sub(dx, ax)));
+
+    _qv zero = _qv_set1(0.0f);
+    _qv crossing = _qv_and(_qv_lt(_qv_mul(s0, s1), zero), _qv_lt(_qv_mul(s2, s3), zero));
+
+    return _qv_andnot(crossing, d);
+}
+
+// Walks the list as runs of points that hold whole segments
+// Buckets are not always full, so the segment between two buckets is a run of its own
+typedef struct {
+    const draw_point_node* node;
+    const draw_point_bucket* prev;
+
+    // Index of the next bucket's first point in the list
+    u32 start;
+
+    b32 seam_done;
+    vec2f seam[2];
+} _query_runs;
+
+// start is the index of the run's first point in the list
+static b32 _query_next_run(_query_runs* runs, const vec2f** points, u32* num_points, u32* start) {
+    while (runs->node != NULL && runs->node->bucket->size == 0) {
+        runs->node = runs->node->next;
+    }
+    if (runs->node == NULL) {
+        return false;
+    }
+
+    const draw_point_bucket* bucket = runs->node->bucket;
+
+    if (runs->prev != NULL && !runs->seam_done) {
+        runs->seam[0] = runs->prev->points[runs->prev->size - 1];
+        runs->seam[1] = bucket->points[0];
+        runs->seam_done = true;
+
+        *points = runs->seam;
+        *num_points = 2;
+        *start = runs->start - 1;
+
+        return true;
+    }
+
+    *points = bucket->points;
+    *num_points = bucket->size;
+    *start = runs->start;
+
+    runs->start += bucket->size;
+    runs->prev = bucket;
+    runs->node = runs->node->next;
+    runs->seam_done = false;
+
+    return true;
+}
+
+// First segment, or point, of the batch at segment i
+// Runs with fewer segments than lanes go one segment at a time with every lane the same,
+// otherwise the last batch is moved back to end on the last segment.
+// Segments it repeats give the same results again, so no query has to know about it
+static inline u32 _query_batch_start(u32 i, u32 num_segments) {
+    return num_segments < QUERY_LANES ? i : MIN(i, num_segments - QUERY_LANES);
+}
+static inline u32 _query_batch_step(u32 num_segments) {
+    return num_segments < QUERY_LANES ? 1 : QUERY_LANES;
+}
+static inline void _query_load_segments(const vec2f* points, u32 first, u32 num_segments, _qv* x0, _qv* y0, _qv* x1, _qv* y1) {
+    if (num_segments < QUERY_LANES) {
+        *x0 = _qv_set1(points[first].x);
+        *y0 = _qv_set1(points[first].y);
+        *x1 = _qv_set1(points[first + 1].x);
+        *y1 = _qv_set1(points[first + 1].y);
+    } else {
+        // Segment i goes from point i to point i + 1, so the ends are one point further along
+        _qv_load_points(points + first, x0, y0);
+        _qv_load_points(points + first + 1, x1, y1);
+    }
+}
+
+typedef struct {
+    _qv cx0, cy0, cx1, cy1;
+    _qv sqr_reach;
+
+    // A circle only needs the distances to its center
+    b32 circle;
+} _query_capsule_args;
+
+// Returns true on the first batch with a segment within reach
+static b32 _query_run_capsule(const vec2f* points, u32 num_points, const _query_capsule_args* args) {
+    u32 num_segments = num_points - 1;
+    u32 step = _query_batch_step(num_segments);
+
+    for (u32 i = 0; i < num_segments; i += step) {
+        _qv x0, y0, x1, y1;
+        _query_load_segments(points, _query_batch_start(i, num_segments), num_segments, &x0, &y0, &x1, &y1);
+
+        _qv d = args->circle ?
+            _qv_point_segment(args->cx0, args->cy0, x0, y0, x1, y1, NULL) :
+            _qv_segment_segment(x0, y0, x1, y1, args->cx0, args->cy0, args->cx1, args->cy1);
+
+        if (_qv_any(_qv_lt(d, args->sqr_reach))) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+b32 draw_query_capsule(const draw_point_list* points, capsulef capsule, f32 reach) {
+    if (points == NULL) {
+        fprintf(stderr, "Cannot query NULL point list\n");
+        return false;
+    }
+    if (points->size == 0) {
+        return false;
+    }
+
+    f32 sqr_reach = (capsule.r + reach) * (capsule.r + reach);
+
+    if (points->size == 1) {
+        vec2f point = points->first->bucket->points[0];
+
+        return vec2f_segment_sqr_dist(point, capsule.p0, capsule.p1) < sqr_reach;
+    }
+
+    _query_capsule_args args = {
+        .cx0 = _qv_set1(capsule.p0.x),
+        .cy0 = _qv_set1(capsule.p0.y),
+        .cx1 = _qv_set1(capsule.p1.x),
+        .cy1 = _qv_set1(capsule.p1.y),
+        .sqr_reach = _qv_set1(sqr_reach),
+        .circle = vec2f_eq(capsule.p0, capsule.p1)
+    };
+
+    _query_runs runs = { .node = points->first };
+    const vec2f* run = NULL;
+    u32 num_run = 0;
+    u32 start = 0;
+
+    while (_query_next_run(&runs, &run, &num_run, &start)) {
+        if (_query_run_capsule(run, num_run, &args)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+typedef struct {
+    _qv px, py;
+
+    // Closest so far, starting at the largest distance allowed
+    f32 sqr_dist;
+    u32 segment;
+    f32 t;
+    b32 found;
+} _query_nearest_args;
+
+// Keeps the closest segment of the run in args
+static void _query_run_nearest(const vec2f* points, u32 num_points, u32 start, _query_nearest_args* args) {
+    u32 num_segments = num_points - 1;
+    u32 step = _query_batch_step(num_segments);
+
+    for (u32 i = 0; i < num_segments; i += step) {
+        u32 first = _query_batch_start(i, num_segments);
+
+        _qv x0, y0, x1, y1;
+        _query_load_segments(points, first, num_segments, &x0, &y0, &x1, &y1);
+
+        _qv t;
+        _qv d = _qv_point_segment(args->px, args->py, x0, y0, x1, y1, &t);
+
+        // Most batches have nothing closer, the lanes are only looked at when one does
+        if (!_qv_any(_qv_lt(d, _qv_set1(args->sqr_dist)))) {
+            continue;
+        }
+
+        f32 lane_dist[QUERY_LANES];
+        f32 lane_t[QUERY_LANES];
+        _qv_store(lane_dist, d);
+        _qv_store(lane_t, t);
+
+        for (u32 j = 0; j < QUERY_LANES; j++) {
+            if (lane_dist[j] < args->sqr_dist) {
+                args->sqr_dist = lane_dist[j];
+                // Every lane is the same segment in short runs
+                args->segment = start + first + (step == 1 ? 0 : j);
+                args->t = lane_t[j];
+                args->found = true;
+            }
+        }
+    }
+}
+
+b32 draw_query_nearest(const draw_point_list* points, vec2f point, f32 max_dist, u32* segment, f32* t, f32* dist) {
+    if (points == NULL || segment == NULL || t == NULL || dist == NULL) {
+        fprintf(stderr, "Cannot query nearest segment: points or outputs are NULL\n");
+        return false;
+    }
+    if (points->size == 0) {
+        return false;
+    }
+
+    _query_nearest_args args = {
+        .px = _qv_set1(point.x),
+        .py = _qv_set1(point.y),
+        .sqr_dist = max_dist * max_dist,
+    };
+
+    if (points->size == 1) {
+        f32 sqr_dist = vec2f_sqr_dist(points->first->bucket->points[0], point);
+
+        if (sqr_dist < args.sqr_dist) {
+            args.sqr_dist = sqr_dist;
+            args.found = true;
+        }
+    } else {
+        _query_runs runs = { .node = points->first };
+        const vec2f* run = NULL;
+        u32 num_run = 0;
+        u32 start = 0;
+
+        while (_query_next_run(&runs, &run, &num_run, &start)) {
+            _query_run_nearest(run, num_run, start, &args);
+        }
+    }
+
+    if (!args.found) {
+        return false;
+    }
+
+    *segment = args.segment;
+    *t = args.t;
+    *dist = sqrtf(args.sqr_dist);
+
+    return true;
+}
+
+// Even-odd test of a batch of points against every edge of the polygon
+static inline _qv _qv_in_polygon(_qv px, _qv py, const vec2f* polygon, u32 num_polygon) {
+    _qv inside = _qv_set1(0.0f);
+
+    for (u32 i = 0, j = num_polygon - 1; i < num_polygon; j = i++) {
+        _qv ax = _qv_set1(polygon[j].x);
+        _qv ay = _qv_set1(polygon[j].y);
+        _qv bx = _qv_set1(polygon[i].x);
+        _qv by = _qv_set1(polygon[i].y);
+
+        // The edge spans the height of the point
+        _qv spans = _qv_xor(_qv_lt(py, ay), _qv_lt(py, by));
+
+        // Edges without height give infinity or NaN here, but those never span the point
+        _qv cross_x = _qv_add(ax, _qv_div(_qv_mul(_qv_sub(bx, ax), _qv_sub(py, ay)), _qv_sub(by, ay)));
+
+        inside = _qv_xor(inside, _qv_and(spans, _qv_lt(px, cross_x)));
+    }
+
+    return inside;
+}
+
+b32 draw_query_polygon(const draw_point_list* points, const vec2f* polygon, u32 num_polygon) {
+    if (points == NULL || polygon == NULL) {
+        fprintf(stderr, "Cannot query polygon: points or polygon is NULL\n");
+        return false;
+    }
+    if (num_polygon < 3) {
+        return false;
+    }
+
+    for (const draw_point_node* node = points->first; node != NULL; node = node->next) {
+        const draw_point_bucket* bucket = node->bucket;
+        u32 size = bucket->size;
+        u32 step = _query_batch_step(size);
+
+        for (u32 i = 0; i < size; i += step) {
+            u32 first = _query_batch_start(i, size);
+
+            _qv px, py;
+            if (size < QUERY_LANES) {
+                px = _qv_set1(bucket->points[first].x);
+                py = _qv_set1(bucket->points[first].y);
+            } else {
+                _qv_load_points(bucket->points + first, &px, &py);
+            }
+
+            if (_qv_any(_qv_in_polygon(px, py, polygon, num_polygon))) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Entries of the best-first traversal
+// Lines go in as a whole and are replaced by their buckets when they come out
+typedef struct {
+    // Nothing in the entry is closer than this
+    f32 sqr_dist;
+
+    u32 index;
+    // NULL for whole lines
+    const draw_point_node* node;
+    // Index of the bucket's first point in its list
+    u32 start;
+} _query_entry;
+
+// Binary min heap on sqr_dist
+typedef struct {
+    mg_arena* arena;
+
+    _query_entry* entries;
+    u32 size;
+    u32 capacity;
+} _query_heap;
+
+static void _query_heap_push(_query_heap* heap, const _query_entry* entry) {
+    if (heap->size == heap->capacity) {
+        u32 capacity = MAX(64, heap->capacity * 2);
+        _query_entry* entries = MGA_PUSH_ARRAY(heap->arena, _query_entry, capacity);
+
+        if (heap->size > 0) {
+            memcpy(entries, heap->entries, sizeof(_query_entry) * heap->size);
+        }
+
+        heap->entries = entries;
+        heap->capacity = capacity;
+    }
+
+    u32 i = heap->size++;
+    while (i > 0) {
+        u32 parent = (i - 1) / 2;
+        if (heap->entries[parent].sqr_dist <= entry->sqr_dist) {
+            break;
+        }
+
+        heap->entries[i] = heap->entries[parent];
+        i = parent;
+    }
+    heap->entries[i] = *entry;
+}
+
+static b32 _query_heap_pop(_query_heap* heap, _query_entry* out) {
+    if (heap->size == 0) {
+        return false;
+    }
+
+    *out = heap->entries[0];
+
+    _query_entry last = heap->entries[--heap->size];
+
+    u32 i = 0;
+    while (true) {
+        u32 child = i * 2 + 1;
+        if (child >= heap->size) {
+            break;
+        }
+        if (child + 1 < heap->size && heap->entries[child + 1].sqr_dist < heap->entries[child].sqr_dist) {
+            child++;
+        }
+        if (last.sqr_dist <= heap->entries[child].sqr_dist) {
+            break;
+        }
+
+        heap->entries[i] = heap->entries[child];
+        i = child;
+    }
+    heap->entries[i] = last;
+
+    return true;
+}
+
+static const draw_point_bucket* _query_next_bucket(const draw_point_node* node) {
+    node = node->next;
+    while (node != NULL && node->bucket->size == 0) {
+        node = node->next;
+    }
+
+    return node == NULL ? NULL : node->bucket;
+}
+
+// Pushes every bucket of the lines that could have something closer than max_sqr_dist
+// With segments set, a bucket also holds the segment from its last point into the next bucket
+static void _query_open_lines(_query_heap* heap, const draw_lines* lines, u32 index, vec2f point, f32 max_sqr_dist, b32 segments) {
+    u32 start = 0;
+
+    for (const draw_point_node* node = lines->points.first; node != NULL; node = node->next) {
+        const draw_point_bucket* bucket = node->bucket;
+        if (bucket->size == 0) {
+            continue;
+        }
+
+        rectf bounds = bucket->bounds;
+        const draw_point_bucket* next = _query_next_bucket(node);
+
+        if (segments && next != NULL) {
+            vec2f p = next->points[0];
+
+            f32 max_x = MAX(bounds.x + bounds.w, p.x);
+            f32 max_y = MAX(bounds.y + bounds.h, p.y);
+            bounds.x = MIN(bounds.x, p.x);
+            bounds.y = MIN(bounds.y, p.y);
+            bounds.w = max_x - bounds.x;
+            bounds.h = max_y - bounds.y;
+        }
+
+        f32 sqr_dist = rectf_sqr_dist(bounds, (rectf){ point.x, point.y, 0.0f, 0.0f });
+
+        if (sqr_dist < max_sqr_dist) {
+            _query_heap_push(heap, &(_query_entry){
+                .sqr_dist = sqr_dist,
+                .index = index,
+                .node = node,
+                .start = start
+            });
+        }
+
+        start += bucket->size;
+    }
+}
+
+// Pushes the lines whose bounding boxes are within reach
+static void _query_push_lines(_query_heap* heap, draw_lines* const* lines, u32 num_lines, vec2f point, f32 max_sqr_dist) {
+    for (u32 i = 0; i < num_lines; i++) {
+        if (lines[i] == NULL || lines[i]->points.size == 0) {
+            continue;
+        }
+
+        f32 sqr_dist = rectf_sqr_dist(lines[i]->bounding_box, (rectf){ point.x, point.y, 0.0f, 0.0f });
+
+        if (sqr_dist < max_sqr_dist) {
+            _query_heap_push(heap, &(_query_entry){ .sqr_dist = sqr_dist, .index = i });
+        }
+    }
+}
+
+b32 draw_query_nearest_lines(draw_lines* const* lines, u32 num_lines, vec2f point, f32 max_dist, draw_query_hit* hit) {
+    if (lines == NULL || hit == NULL) {
+        fprintf(stderr, "Cannot query nearest lines: lines or hit is NULL\n");
+        return false;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+    _query_heap heap = { .arena = scratch.arena };
+
+    _query_nearest_args args = {
+        .px = _qv_set1(point.x),
+        .py = _qv_set1(point.y),
+        .sqr_dist = max_dist * max_dist,
+    };
+    u32 best = 0;
+
+    _query_push_lines(&heap, lines, num_lines, point, args.sqr_dist);
+
+    _query_entry entry = { 0 };
+    while (_query_heap_pop(&heap, &entry) && entry.sqr_dist < args.sqr_dist) {
+        const draw_lines* cur = lines[entry.index];
+
+        if (entry.node == NULL) {
+            if (cur->points.size == 1) {
+                f32 sqr_dist = vec2f_sqr_dist(cur->points.first->bucket->points[0], point);
+
+                if (sqr_dist < args.sqr_dist) {
+                    args.sqr_dist = sqr_dist;
+                    args.segment = 0;
+                    args.t = 0.0f;
+                    args.found = true;
+                    best = entry.index;
+                }
+            } else {
+                _query_open_lines(&heap, cur, entry.index, point, args.sqr_dist, true);
+            }
+
+            continue;
+        }
+
+        f32 prev_sqr_dist = args.sqr_dist;
+
+        const draw_point_bucket* bucket = entry.node->bucket;
+        _query_run_nearest(bucket->points, bucket->size, entry.start, &args);
+
+        const draw_point_bucket* next = _query_next_bucket(entry.node);
+        if (next != NULL) {
+            vec2f seam[2] = { bucket->points[bucket->size - 1], next->points[0] };
+            _query_run_nearest(seam, 2, entry.start + bucket->size - 1, &args);
+        }
+
+        if (args.sqr_dist < prev_sqr_dist) {
+            best = entry.index;
+        }
+    }
+
+    mga_scratch_release(scratch);
+
+    if (!args.found) {
+        return false;
+    }
+
+    *hit = (draw_query_hit){
+        .lines = lines[best],
+        .index = best,
+        .segment = args.segment,
+        .t = args.t,
+        .dist = sqrtf(args.sqr_dist)
+    };
+
+    return true;
+}
+
+typedef struct {
+    _qv px, py;
+
+    u32 k;
+    u32 num_hits;
+    // Sorted closest first, dist holds the squared distance until the end
+    draw_query_hit* hits;
+
+    f32 max_sqr_dist;
+} _query_points_args;
+
+// Anything at or past this cannot be one of the k closest
+static inline f32 _query_points_limit(const _query_points_args* args) {
+    return args->num_hits == args->k ? args->hits[args->k - 1].dist : args->max_sqr_dist;
+}
+
+static void _query_points_insert(_query_points_args* args, u32 index, u32 point, f32 sqr_dist) {
+    u32 i = MIN(args->num_hits, args->k - 1);
+    while (i > 0 && args->hits[i - 1].dist > sqr_dist) {
+        args->hits[i] = args->hits[i - 1];
+        i--;
+    }
+
+    args->hits[i] = (draw_query_hit){ .index = index, .segment = point, .dist = sqr_dist };
+    args->num_hits = MIN(args->num_hits + 1, args->k);
+}
+
+static void _query_run_points(const vec2f* points, u32 num_points, u32 start, u32 index, _query_points_args* args) {
+    u32 step = _query_batch_step(num_points);
+    // Short runs have the same point in every lane
+    u32 num_lanes = step == 1 ? 1 : QUERY_LANES;
+
+    for (u32 i = 0; i < num_points; i += step) {
+        u32 first = _query_batch_start(i, num_points);
+
+        _qv x, y;
+        if (step == 1) {
+            x = _qv_set1(points[first].x);
+            y = _qv_set1(points[first].y);
+        } else {
+            _qv_load_points(points + first, &x, &y);
+        }
+
+        _qv dx = _qv_sub(x, args->px);
+        _qv dy = _qv_sub(y, args->py);
+        _qv d = _qv_add(_qv_mul(dx, dx), _qv_mul(dy, dy));
+
+        if (!_qv_any(_qv_lt(d, _qv_set1(_query_points_limit(args))))) {
+            continue;
+        }
+
+        f32 lane_dist[QUERY_LANES];
+        _qv_store(lane_dist, d);
+
+        // The last batch can repeat points, those would show up twice
+        for (u32 j = 0; j < num_lanes; j++) {
+            if (first + j >= i && lane_dist[j] < _query_points_limit(args)) {
+                _query_points_insert(args, index, start + first + j, lane_dist[j]);
+            }
+        }
+    }
+}
+
+u32 draw_query_nearest_points(draw_lines* const* lines, u32 num_lines, vec2f point, f32 max_dist, u32 k, draw_query_hit* hits) {
+    if (lines == NULL || hits == NULL) {
+        fprintf(stderr, "Cannot query nearest points: lines or hits is NULL\n");
+        return 0;
+    }
+    if (k == 0) {
+        return 0;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+    _query_heap heap = { .arena = scratch.arena };
+
+    _query_points_args args = {
+        .px = _qv_set1(point.x),
+        .py = _qv_set1(point.y),
+        .k = k,
+        .hits = hits,
+        .max_sqr_dist = max_dist * max_dist
+    };
+
+    _query_push_lines(&heap, lines, num_lines, point, args.max_sqr_dist);
+
+    _query_entry entry = { 0 };
+    while (_query_heap_pop(&heap, &entry) && entry.sqr_dist < _query_points_limit(&args)) {
+        if (entry.node == NULL) {
+            _query_open_lines(&heap, lines[entry.index], entry.index, point, _query_points_limit(&args), false);
+        } else {
+            const draw_point_bucket* bucket = entry.node->bucket;
+            _query_run_points(bucket->points, bucket->size, entry.start, entry.index, &args);
+        }
+    }
+
+    mga_scratch_release(scratch);
+
+    for (u32 i = 0; i < args.num_hits; i++) {
+        hits[i].lines = lines[hits[i].index];
+        hits[i].dist = sqrtf(hits[i].dist);
+    }
+
+    return args.num_hits;
+}
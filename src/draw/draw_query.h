@@ -0,0 +1,50 @@
+#ifndef DRAW_QUERY_H
+#define DRAW_QUERY_H
+
+#include "base/base.h"
+#include "draw_point_bucket.h"
+#include "draw_lines.h"
+
+// Distance queries over the segments of point lists, for erasing, selecting and picking
+// The kernels read the points straight out of the buckets, several segments at a time:
+// eight with AVX2, four with SSE2 and one at a time everywhere else
+
+// Whether any segment of the list comes within reach of the capsule
+// reach is added to the capsule radius, it is usually half the line width
+// A list with one point is tested as that point
+b32 draw_query_capsule(const draw_point_list* points, capsulef capsule, f32 reach);
+
+// Closest segment of the list to point, if there is one within max_dist
+// segment is the index of the first point of the segment and t is the closest point on it
+// A list with one point gives that point as segment 0 with t 0
+b32 draw_query_nearest(const draw_point_list* points, vec2f point, f32 max_dist, u32* segment, f32* t, f32* dist);
+
+// Whether any point of the list is inside the polygon, using the even-odd rule
+// The polygon is closed from its last point back to its first
+b32 draw_query_polygon(const draw_point_list* points, const vec2f* polygon, u32 num_polygon);
+
+// Picking over many lines objects, like the strokes of a document
+// Lines are visited closest bounding box first, and then closest bucket first,
+// so anything further than the best result so far is never looked at.
+// Transforms set on the lines are not applied, the same as for their bounding boxes
+
+typedef struct {
+    draw_lines* lines;
+    // Index of lines in the array that was queried
+    u32 index;
+
+    // Index of the first point of the segment, or of the point for point queries
+    u32 segment;
+    // Closest point on the segment, 0 at its first point and 1 at the next one
+    f32 t;
+    // Distance to the center of the lines, without the line width
+    f32 dist;
+} draw_query_hit;
+
+// Closest segment of all the lines to point, if there is one within max_dist
+b32 draw_query_nearest_lines(draw_lines* const* lines, u32 num_lines, vec2f point, f32 max_dist, draw_query_hit* hit);
+// Up to k points of the lines that are closest to point and within max_dist, closest first
+// hits needs room for k hits, returns the number found
+u32 draw_query_nearest_points(draw_lines* const* lines, u32 num_lines, vec2f point, f32 max_dist, u32 k, draw_query_hit* hits);
+
+#endif // DRAW_QUERY_H
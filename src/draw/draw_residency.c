@@ -0,0 +1,146 @@
+#include "draw_residency.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct draw_residency {
+    u64 budget;
+    u64 size;
+
+    u64 frame;
+} draw_residency;
+
+typedef struct {
+    draw_lines* lines;
+
+    u64 last_seen_frame;
+    // Squared distance from the view
+    f32 dist;
+} _residency_entry;
+
+static int _residency_restore_cmp(const void* a, const void* b);
+static int _residency_evict_cmp(const void* a, const void* b);
+
+draw_residency* draw_residency_create(mg_arena* arena, u64 budget) {
+    draw_residency* residency = MGA_PUSH_ZERO_STRUCT(arena, draw_residency);
+
+    residency->budget = budget;
+
+    return residency;
+}
+
+u32 draw_residency_update(draw_residency* residency, draw_lines** lines, u32 num_lines, viewf view, u32 max_points) {
+    if (residency == NULL || (lines == NULL && num_lines > 0)) {
+        fprintf(stderr, "Cannot update residency: residency or lines is NULL\n");
+        return 0;
+    }
+
+    residency->frame++;
+
+    rectf view_rect = viewf_bounding_box(view);
+    rectf near = {
+        view_rect.x - view_rect.w * DRAW_RESIDENCY_PREFETCH,
+        view_rect.y - view_rect.h * DRAW_RESIDENCY_PREFETCH,
+        view_rect.w * (1.0f + 2.0f * DRAW_RESIDENCY_PREFETCH),
+        view_rect.h * (1.0f + 2.0f * DRAW_RESIDENCY_PREFETCH)
+    };
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    _residency_entry* entries = MGA_PUSH_ARRAY(scratch.arena, _residency_entry, num_lines);
+    u32 num_evicted = 0;
+    u64 size = 0;
+
+    for (u32 i = 0; i < num_lines; i++) {
+        if (rectf_collide_rectf(lines[i]->bounding_box, near)) {
+            lines[i]->last_seen_frame = residency->frame;
+
+            if (draw_lines_is_evicted(lines[i])) {
+                entries[num_evicted++] = (_residency_entry){
+                    .lines = lines[i],
+                    .dist = rectf_sqr_dist(lines[i]->bounding_box, view_rect)
+                };
+            }
+        }
+
+        size += draw_lines_gpu_size(lines[i]);
+    }
+
+    // Closest first, everything in view is at distance 0 and is needed right away
+    qsort(entries, num_evicted, sizeof(_residency_entry), _residency_restore_cmp);
+
+    u32 num_waiting = 0;
+    u64 num_points = 0;
+
+    for (u32 i = 0; i < num_evicted; i++) {
+        _residency_entry* entry = &entries[i];
+
+        if (entry->dist > 0.0f) {
+            // Lines that do not fit in the budget are left until the view moves
+            if (size >= residency->budget) {
+                break;
+            }
+            if (num_points >= max_points) {
+                num_waiting = num_evicted - i;
+                break;
+            }
+        }
+
+        draw_lines_restore(entry->lines);
+
+        size += draw_lines_gpu_size(entry->lines);
+        num_points += entry->lines->points.size;
+    }
+
+    if (size > residency->budget) {
+        u32 num_resident = 0;
+
+        for (u32 i = 0; i < num_lines; i++) {
+            if (lines[i]->last_seen_frame == residency->frame || draw_lines_is_evicted(lines[i])) {
+                continue;
+            }
+
+            entries[num_resident++] = (_residency_entry){
+                .lines = lines[i],
+                .last_seen_frame = lines[i]->last_seen_frame,
+                .dist = rectf_sqr_dist(lines[i]->bounding_box, view_rect)
+            };
+        }
+
+        qsort(entries, num_resident, sizeof(_residency_entry), _residency_evict_cmp);
+
+        for (u32 i = 0; i < num_resident && size > residency->budget; i++) {
+            size -= draw_lines_gpu_size(entries[i].lines);
+
+            draw_lines_evict(entries[i].lines);
+        }
+    }
+
+    residency->size = size;
+
+    mga_scratch_release(scratch);
+
+    return num_waiting;
+}
+
+u64 draw_residency_size(const draw_residency* residency) {
+    return residency == NULL ? 0 : residency->size;
+}
+
+static int _residency_restore_cmp(const void* a, const void* b) {
+    const _residency_entry* entry_a = (const _residency_entry*)a;
+    const _residency_entry* entry_b = (const _residency_entry*)b;
+
+    return entry_a->dist < entry_b->dist ? -1 : (entry_a->dist > entry_b->dist);
+}
+// Least recently seen first, then the farthest from the view
+static int _residency_evict_cmp(const void* a, const void* b) {
+    const _residency_entry* entry_a = (const _residency_entry*)a;
+    const _residency_entry* entry_b = (const _residency_entry*)b;
+
+    if (entry_a->last_seen_frame != entry_b->last_seen_frame) {
+        return entry_a->last_seen_frame < entry_b->last_seen_frame ? -1 : 1;
+    }
+
+    return entry_a->dist > entry_b->dist ? -1 : (entry_a->dist < entry_b->dist);
+}
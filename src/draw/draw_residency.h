@@ -0,0 +1,31 @@
+#ifndef DRAW_RESIDENCY_H
+#define DRAW_RESIDENCY_H
+
+#include "base/base.h"
+#include "draw_lines.h"
+
+// Keeps the GPU memory of the lines under a budget
+// Once the budget is exceeded, the lines that have been away from the view the longest are evicted,
+// which deletes their geometry and keeps their points (see draw_lines_evict).
+// Evicted lines are restored as they come near the view again, the closest ones first
+
+// How far past each side of the view lines count as near it, as a fraction of the view size
+#define DRAW_RESIDENCY_PREFETCH 0.5f
+
+// Contents defined in draw_residency.c
+typedef struct draw_residency draw_residency;
+
+// budget is in bytes
+draw_residency* draw_residency_create(mg_arena* arena, u64 budget);
+
+// Call this every frame before drawing
+// Lines in view are always restored, the other evicted lines near the view are restored with about max_points points.
+// Lines near the view are never evicted, so they can go over the budget
+// Only the lines passed in count towards the budget, lines out of the document are evicted by the history (see draw_history.h)
+// Returns the number of evicted lines near the view left for the next update, not counting the ones over the budget
+u32 draw_residency_update(draw_residency* residency, draw_lines** lines, u32 num_lines, viewf view, u32 max_points);
+
+// Bytes of GPU memory the lines took up after the last update
+u64 draw_residency_size(const draw_residency* residency);
+
+#endif // DRAW_RESIDENCY_H
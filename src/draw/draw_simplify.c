@@ -0,0 +1,199 @@
+#include "draw_simplify.h"
+
+#include <stdio.h>
+#include <math.h>
+
+static f32 _segment_sqr_dist(vec2f p, vec2f a, vec2f b, f32* t_out);
+
+typedef struct {
+    u32 start;
+    u32 end;
+} _rdp_span;
+
+u32 draw_simplify_rdp(const vec2f* points, u32 num_points, f32 tolerance, vec2f* out) {
+    if (points == NULL || out == NULL) {
+        fprintf(stderr, "Cannot simplify NULL points\n");
+        return 0;
+    }
+
+    if (num_points <= 2) {
+        for (u32 i = 0; i < num_points; i++) {
+            out[i] = points[i];
+        }
+
+        return num_points;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    b8* keep = MGA_PUSH_ZERO_ARRAY(scratch.arena, b8, num_points);
+    keep[0] = true;
+    keep[num_points - 1] = true;
+
+    // Every span on the stack is split at most once, so it never holds more than num_points spans
+    _rdp_span* stack = MGA_PUSH_ARRAY(scratch.arena, _rdp_span, num_points);
+    u32 stack_size = 0;
+
+    stack[stack_size++] = (_rdp_span){ 0, num_points - 1 };
+
+    f32 sqr_tolerance = tolerance * tolerance;
+
+    while (stack_size > 0) {
+        _rdp_span span = stack[--stack_size];
+
+        f32 max_sqr_dist = 0.0f;
+        u32 max_index = span.start;
+
+        for (u32 i = span.start + 1; i < span.end; i++) {
+            f32 sqr_dist = _segment_sqr_dist(points[i], points[span.start], points[span.end], NULL);
+
+            if (sqr_dist > max_sqr_dist) {
+                max_sqr_dist = sqr_dist;
+                max_index = i;
+            }
+        }
+
+        if (max_sqr_dist > sqr_tolerance) {
+            keep[max_index] = true;
+
+            if (max_index - span.start > 1) {
+                stack[stack_size++] = (_rdp_span){ span.start, max_index };
+            }
+            if (span.end - max_index > 1) {
+                stack[stack_size++] = (_rdp_span){ max_index, span.end };
+            }
+        }
+    }
+
+    // Kept points are never ahead of the read position, so this also works in place
+    u32 num_out = 0;
+    for (u32 i = 0; i < num_points; i++) {
+        if (keep[i]) {
+            out[num_out++] = points[i];
+        }
+    }
+
+    mga_scratch_release(scratch);
+
+    return num_out;
+}
+
+// Distance to the segment instead of the infinite line,
+// so closed strokes where a == b still work
+// t_out is set to where the closest point is along the segment, if it is not NULL
+static f32 _segment_sqr_dist(vec2f p, vec2f a, vec2f b, f32* t_out) {
+    vec2f line_vec = vec2f_sub(b, a);
+    vec2f point_vec = vec2f_sub(p, a);
+
+    f32 sqr_len = vec2f_dot(line_vec, line_vec);
+    if (sqr_len == 0.0f) {
+        if (t_out != NULL) {
+            *t_out = 0.0f;
+        }
+        return vec2f_dot(point_vec, point_vec);
+    }
+
+    f32 t = vec2f_dot(point_vec, line_vec) / sqr_len;
+    t = CLAMP(t, 0, 1);
+
+    if (t_out != NULL) {
+        *t_out = t;
+    }
+
+    return vec2f_sqr_dist(point_vec, vec2f_scl(line_vec, t));
+}
+
+void draw_simplify_stream_begin(draw_simplifier* simp, vec2f first, f32 first_width, f32 tolerance) {
+    if (simp == NULL) {
+        fprintf(stderr, "Cannot begin NULL simplifier\n");
+        return;
+    }
+
+    simp->tolerance = tolerance;
+    simp->anchor = first;
+    simp->anchor_width = first_width;
+    simp->span_size = 0;
+}
+
+b32 draw_simplify_stream_add(draw_simplifier* simp, vec2f point, f32 width, vec2f* kept, f32* kept_width) {
+    if (simp == NULL || kept == NULL || kept_width == NULL) {
+        fprintf(stderr, "Cannot add point to simplifier: simplifier, kept or kept_width is NULL\n");
+        return false;
+    }
+
+    // Repeated points would make zero length segments
+    vec2f newest = simp->span_size > 0 ? simp->span[simp->span_size - 1] : simp->anchor;
+    if (vec2f_eq(point, newest)) {
+        return false;
+    }
+
+    if (simp->span_size < DRAW_SIMPLIFY_MAX_SPAN && draw_simplify_stream_fits(simp, point, width)) {
+        simp->span[simp->span_size] = point;
+        simp->span_widths[simp->span_size] = width;
+        simp->span_size++;
+
+        return false;
+    }
+
+    *kept = simp->span[simp->span_size - 1];
+    *kept_width = simp->span_widths[simp->span_size - 1];
+
+    simp->anchor = *kept;
+    simp->anchor_width = *kept_width;
+    simp->span[0] = point;
+    simp->span_widths[0] = width;
+    simp->span_size = 1;
+
+    return true;
+}
+
+b32 draw_simplify_stream_fits(const draw_simplifier* simp, vec2f point, f32 width) {
+    if (simp == NULL) {
+        fprintf(stderr, "Cannot check NULL simplifier\n");
+        return false;
+    }
+
+    // Ending on the anchor would make the kept point a repeat of it
+    if (simp->span_size > 0 && vec2f_eq(point, simp->anchor)) {
+        return false;
+    }
+
+    f32 sqr_tolerance = simp->tolerance * simp->tolerance;
+
+    for (u32 i = 0; i < simp->span_size; i++) {
+        f32 t = 0.0f;
+        f32 sqr_dist = _segment_sqr_dist(simp->span[i], simp->anchor, point, &t);
+
+        if (sqr_dist > sqr_tolerance) {
+            return false;
+        }
+
+        // The edges are half the width away from the center, so they move by half the width difference
+        f32 width_error = fabsf(simp->anchor_width + (width - simp->anchor_width) * t - simp->span_widths[i]) * 0.5f;
+        if (width_error > 0.0f && sqrtf(sqr_dist) + width_error > simp->tolerance) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+b32 draw_simplify_stream_flush(draw_simplifier* simp, vec2f* kept, f32* kept_width) {
+    if (simp == NULL || kept == NULL || kept_width == NULL) {
+        fprintf(stderr, "Cannot flush simplifier: simplifier, kept or kept_width is NULL\n");
+        return false;
+    }
+
+    if (simp->span_size == 0) {
+        return false;
+    }
+
+    *kept = simp->span[simp->span_size - 1];
+    *kept_width = simp->span_widths[simp->span_size - 1];
+
+    simp->anchor = *kept;
+    simp->anchor_width = *kept_width;
+    simp->span_size = 0;
+
+    return true;
+}
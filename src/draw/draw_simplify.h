@@ -0,0 +1,45 @@
+#ifndef DRAW_SIMPLIFY_H
+#define DRAW_SIMPLIFY_H
+
+#include "base/base.h"
+
+// Ramer-Douglas-Peucker simplification
+// Keeps the first and last points and every point needed so that
+// no removed point is further than tolerance from the simplified lines.
+// out needs room for num_points, and it can be the same as points
+// Returns the number of points written to out
+u32 draw_simplify_rdp(const vec2f* points, u32 num_points, f32 tolerance, vec2f* out);
+
+// Longest run of points that can be merged into one segment
+#define DRAW_SIMPLIFY_MAX_SPAN 64
+
+// Simplifies points as they come in, for building lines while drawing
+// Points since the last kept point (the anchor) are held back for as long as
+// a single segment from the anchor stays within tolerance of all of them.
+// Every point has a width, and the edges of the segment have to stay within tolerance as well,
+// with the width changing linearly along it. Points with the same width only have to be close to the segment.
+// The newest held back point is the pending end, it only gets kept once a new point no longer fits.
+typedef struct {
+    // Can be changed between points, for example when the view zooms
+    f32 tolerance;
+
+    vec2f anchor;
+    f32 anchor_width;
+
+    // Points since the anchor, the last one is the pending end
+    vec2f span[DRAW_SIMPLIFY_MAX_SPAN];
+    f32 span_widths[DRAW_SIMPLIFY_MAX_SPAN];
+    u32 span_size;
+} draw_simplifier;
+
+// first is kept as the anchor
+void draw_simplify_stream_begin(draw_simplifier* simp, vec2f first, f32 first_width, f32 tolerance);
+// Returns true if the pending end was kept, it is written to kept and kept_width
+// A point equal to the newest one is ignored
+b32 draw_simplify_stream_add(draw_simplifier* simp, vec2f point, f32 width, vec2f* kept, f32* kept_width);
+// Whether the held back points would stay within tolerance if the span ended at point
+b32 draw_simplify_stream_fits(const draw_simplifier* simp, vec2f point, f32 width);
+// Keeps the pending end, returns false if there is none
+b32 draw_simplify_stream_flush(draw_simplifier* simp, vec2f* kept, f32* kept_width);
+
+#endif // DRAW_SIMPLIFY_H
@@ -0,0 +1,209 @@
+#include "draw_snapshot.h"
+
+#include <stdio.h>
+
+#include "os/os.h"
+#include "draw_file.h"
+
+typedef struct draw_snapshot {
+    // Strokes and path of the current save, reset after every save
+    mg_arena* save_arena;
+
+    os_mutex* mutex;
+    os_condvar* cond;
+    // NULL if the platform does not have threads
+    os_thread* thread;
+
+    // Only used by the calling thread, set from the start of a save until it is released
+    b32 busy;
+
+    // Shared with the worker, under the mutex
+    b32 closing;
+    b32 pending;
+    b32 done;
+    b32 written;
+
+    string8 path;
+    draw_snapshot_stroke* strokes;
+    // Points to the copies in strokes
+    draw_lines** copies;
+    u32 num_strokes;
+    string8_list records;
+} draw_snapshot;
+
+static void _snapshot_release(draw_snapshot* snapshot);
+static void _snapshot_worker(void* snapshot_ptr);
+
+draw_snapshot* draw_snapshot_create(mg_arena* arena) {
+    mga_desc desc = {
+        .desired_max_size = MGA_MiB(64),
+        .desired_block_size = MGA_KiB(64)
+    };
+    mg_arena* save_arena = mga_create(&desc);
+    if (save_arena == NULL) {
+        fprintf(stderr, "Cannot create snapshot: failed to create save arena\n");
+        return NULL;
+    }
+
+    draw_snapshot* snapshot = MGA_PUSH_ZERO_STRUCT(arena, draw_snapshot);
+
+    snapshot->save_arena = save_arena;
+
+    snapshot->mutex = os_mutex_create(arena);
+    snapshot->cond = os_condvar_create(arena);
+    snapshot->thread = os_thread_create(arena, _snapshot_worker, snapshot);
+
+    return snapshot;
+}
+void draw_snapshot_destroy(draw_snapshot* snapshot) {
+    if (snapshot == NULL) {
+        fprintf(stderr, "Cannot destroy NULL snapshot\n");
+        return;
+    }
+
+    if (snapshot->thread != NULL) {
+        os_mutex_lock(snapshot->mutex);
+        snapshot->closing = true;
+        os_condvar_signal(snapshot->cond);
+        os_mutex_unlock(snapshot->mutex);
+
+        // The worker finishes the save in progress first
+        os_thread_join(snapshot->thread);
+    }
+
+    if (snapshot->busy) {
+        _snapshot_release(snapshot);
+    }
+
+    os_condvar_destroy(snapshot->cond);
+    os_mutex_destroy(snapshot->mutex);
+
+    mga_destroy(snapshot->save_arena);
+}
+
+b32 draw_snapshot_save(draw_snapshot* snapshot, string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records) {
+    if (snapshot == NULL || lines == NULL) {
+        fprintf(stderr, "Cannot save snapshot: snapshot or lines is NULL\n");
+        return false;
+    }
+
+    if (snapshot->busy) {
+        return false;
+    }
+
+    snapshot->busy = true;
+
+    mg_arena* arena = snapshot->save_arena;
+
+    snapshot->path = str8_copy(arena, path);
+    snapshot->strokes = MGA_PUSH_ARRAY(arena, draw_snapshot_stroke, num_lines);
+    snapshot->copies = MGA_PUSH_ARRAY(arena, draw_lines*, num_lines);
+    snapshot->num_strokes = num_lines;
+
+    // Only the lines objects are copied, the buckets are shared until the lines change
+    for (u32 i = 0; i < num_lines; i++) {
+        draw_snapshot_stroke* stroke = &snapshot->strokes[i];
+
+        stroke->lines = lines[i];
+        stroke->copy = *lines[i];
+        lines[i]->snapshot = stroke;
+
+        snapshot->copies[i] = &stroke->copy;
+    }
+
+    // The list can change after this returns, the strings it points to cannot
+    snapshot->records = (string8_list){ 0 };
+    for (const string8_node* node = records == NULL ? NULL : records->first; node != NULL; node = node->next) {
+        str8_list_push(arena, &snapshot->records, node->str);
+    }
+
+    if (snapshot->thread == NULL) {
+        snapshot->written = draw_file_save(snapshot->path, snapshot->copies, snapshot->num_strokes, &snapshot->records);
+        snapshot->done = true;
+
+        return true;
+    }
+
+    os_mutex_lock(snapshot->mutex);
+    snapshot->pending = true;
+    os_condvar_signal(snapshot->cond);
+    os_mutex_unlock(snapshot->mutex);
+
+    return true;
+}
+b32 draw_snapshot_update(draw_snapshot* snapshot, b32* written) {
+    if (snapshot == NULL) {
+        fprintf(stderr, "Cannot update NULL snapshot\n");
+        return false;
+    }
+
+    if (!snapshot->busy) {
+        return false;
+    }
+
+    os_mutex_lock(snapshot->mutex);
+    b32 done = snapshot->done;
+    os_mutex_unlock(snapshot->mutex);
+
+    if (!done) {
+        return false;
+    }
+
+    if (written != NULL) {
+        *written = snapshot->written;
+    }
+
+    _snapshot_release(snapshot);
+
+    return true;
+}
+
+// Gives the lists that are still shared back to their lines and releases the ones that were handed over
+static void _snapshot_release(draw_snapshot* snapshot) {
+    for (u32 i = 0; i < snapshot->num_strokes; i++) {
+        draw_snapshot_stroke* stroke = &snapshot->strokes[i];
+
+        if (stroke->lines != NULL) {
+            stroke->lines->snapshot = NULL;
+        } else {
+            draw_point_list_clear(&stroke->copy.points);
+        }
+    }
+
+    snapshot->busy = false;
+    snapshot->done = false;
+    snapshot->strokes = NULL;
+    snapshot->copies = NULL;
+    snapshot->num_strokes = 0;
+    snapshot->records = (string8_list){ 0 };
+
+    mga_reset(snapshot->save_arena);
+}
+
+static void _snapshot_worker(void* snapshot_ptr) {
+    draw_snapshot* snapshot = (draw_snapshot*)snapshot_ptr;
+
+    os_mutex_lock(snapshot->mutex);
+
+    while (true) {
+        while (!snapshot->pending && !snapshot->closing) {
+            os_condvar_wait(snapshot->cond, snapshot->mutex, OS_WAIT_INFINITE);
+        }
+
+        if (!snapshot->pending) {
+            break;
+        }
+
+        snapshot->pending = false;
+        os_mutex_unlock(snapshot->mutex);
+
+        // Nothing changes the shared buckets until the snapshot is released
+        b32 written = draw_file_save(snapshot->path, snapshot->copies, snapshot->num_strokes, &snapshot->records);
+
+        os_mutex_lock(snapshot->mutex);
+        snapshot->written = written;
+        snapshot->done = true;
+    }
+
+    os_mutex_unlock(snapshot->mutex);
+}
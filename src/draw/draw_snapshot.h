@@ -0,0 +1,37 @@
+#ifndef DRAW_SNAPSHOT_H
+#define DRAW_SNAPSHOT_H
+
+#include "base/base.h"
+#include "draw_lines.h"
+
+// Saving a document in the background without copying its points
+// A snapshot copies the lines objects but shares their point lists with them.
+// The draw_lines functions that change points hand the shared list over to the snapshot first
+// and carry on with a list of their own that shares the buckets (see draw_point_list_share),
+// so only the buckets that change during a save are ever copied.
+// A worker thread writes the snapshot with draw_file_save while the calling thread keeps going
+
+typedef struct draw_snapshot_stroke {
+    // Set to NULL when the lines hand their list over, the snapshot releases it then
+    draw_lines* lines;
+    // The lines as they were when the snapshot was taken
+    draw_lines copy;
+} draw_snapshot_stroke;
+
+// Contents defined in draw_snapshot.c
+typedef struct draw_snapshot draw_snapshot;
+
+draw_snapshot* draw_snapshot_create(mg_arena* arena);
+// Waits for the save in progress
+void draw_snapshot_destroy(draw_snapshot* snapshot);
+
+// Takes a snapshot of lines and starts writing it to path, lines without an id are written with id 0
+// records are written as they are (see draw_file_save), their memory has to stay until the save is released
+// Returns false if the last save is still in progress
+// If the platform does not have threads, the snapshot is written before this returns
+b32 draw_snapshot_save(draw_snapshot* snapshot, string8 path, draw_lines* const* lines, u32 num_lines, const string8_list* records);
+// Releases the snapshot once it is written, call this regularly from the thread that owns the lines
+// Returns true once per finished save, written is set to whether the file was written
+b32 draw_snapshot_update(draw_snapshot* snapshot, b32* written);
+
+#endif // DRAW_SNAPSHOT_H
@@ -0,0 +1,369 @@
+#include "draw_spline.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+// Span of points to fit, with the unit tangents at both ends pointing into the span
+typedef struct {
+    u32 first;
+    u32 last;
+
+    vec2f tan_first;
+    vec2f tan_last;
+} _fit_span;
+
+static vec2f _fit_tangent(vec2f from, vec2f to);
+static void _fit_chord_params(const vec2f* points, u32 first, u32 last, f32* params);
+static void _fit_bezier(const vec2f* points, const _fit_span* span, const f32* params, vec2f ctrl[4]);
+static f32 _fit_max_error(const vec2f* points, const f32* widths, u32 first, u32 last, const vec2f ctrl[4], const f32* params, u32* split);
+static void _fit_reparameterize(const vec2f* points, u32 first, u32 last, const vec2f ctrl[4], f32* params);
+
+draw_spline draw_spline_fit(mg_arena* arena, const draw_point_list* points, f32 tolerance) {
+    draw_spline spline = { 0 };
+
+    if (points == NULL || points->size == 0) {
+        fprintf(stderr, "Cannot fit spline to empty points\n");
+        return spline;
+    }
+
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+
+    u32 num_points = 0;
+    vec2f* pts = MGA_PUSH_ARRAY(scratch.arena, vec2f, points->size);
+    f32* widths = points->has_widths ? MGA_PUSH_ARRAY(scratch.arena, f32, points->size) : NULL;
+
+    // Repeated points have no direction, so they are dropped and keep the widest width
+    for (const draw_point_node* node = points->first; node != NULL; node = node->next) {
+        const draw_point_bucket* bucket = node->bucket;
+
+        for (u32 i = 0; i < bucket->size && num_points < points->size; i++) {
+            f32 width = widths == NULL ? 0.0f : bucket->widths->widths[i];
+
+            if (num_points == 0 || !vec2f_eq(bucket->points[i], pts[num_points - 1])) {
+                pts[num_points] = bucket->points[i];
+                if (widths != NULL) {
+                    widths[num_points] = width;
+                }
+
+                num_points++;
+            } else if (widths != NULL) {
+                widths[num_points - 1] = MAX(widths[num_points - 1], width);
+            }
+        }
+    }
+
+    if (num_points == 1) {
+        spline.num_segments = 1;
+        spline.segments = MGA_PUSH_ARRAY(arena, cubic_bezier, 1);
+        spline.segments[0] = cbezier_create(pts[0], pts[0], pts[0], pts[0]);
+
+        if (widths != NULL) {
+            spline.widths = MGA_PUSH_ARRAY(arena, f32, 2);
+            spline.widths[0] = widths[0];
+            spline.widths[1] = widths[0];
+        }
+
+        mga_scratch_release(scratch);
+        return spline;
+    }
+
+    f32* params = MGA_PUSH_ARRAY(scratch.arena, f32, num_points);
+
+    // A span never has fewer than two points, so there are at most num_points - 1 of them
+    cubic_bezier* segments = MGA_PUSH_ARRAY(scratch.arena, cubic_bezier, num_points - 1);
+    // The spans are fit in order, so the first point of each segment gives its starting width
+    u32* segment_firsts = MGA_PUSH_ARRAY(scratch.arena, u32, num_points - 1);
+    u32 num_segments = 0;
+
+    _fit_span* stack = MGA_PUSH_ARRAY(scratch.arena, _fit_span, num_points);
+    u32 stack_size = 0;
+
+    // Sharp corners split the points up front, pushed last to first so the first span is fitted first
+    u32 span_last = num_points - 1;
+    for (u32 i = num_points - 2; i > 0; i--) {
+        vec2f in = _fit_tangent(pts[i - 1], pts[i]);
+        vec2f out = _fit_tangent(pts[i], pts[i + 1]);
+
+        if (vec2f_dot(in, out) < DRAW_SPLINE_CORNER_COS) {
+            stack[stack_size++] = (_fit_span){
+                i, span_last,
+                _fit_tangent(pts[i], pts[i + 1]), _fit_tangent(pts[span_last], pts[span_last - 1])
+            };
+
+            span_last = i;
+        }
+    }
+    stack[stack_size++] = (_fit_span){
+        0, span_last,
+        _fit_tangent(pts[0], pts[1]), _fit_tangent(pts[span_last], pts[span_last - 1])
+    };
+
+    f32 sqr_tolerance = tolerance * tolerance;
+
+    while (stack_size > 0) {
+        _fit_span span = stack[--stack_size];
+
+        vec2f ctrl[4] = { 0 };
+
+        if (span.last - span.first == 1) {
+            // Straight segment with the control points a third of the way along the tangents
+            f32 dist = vec2f_dist(pts[span.first], pts[span.last]) / 3.0f;
+
+            ctrl[0] = pts[span.first];
+            ctrl[1] = vec2f_add(pts[span.first], vec2f_scl(span.tan_first, dist));
+            ctrl[2] = vec2f_add(pts[span.last], vec2f_scl(span.tan_last, dist));
+            ctrl[3] = pts[span.last];
+
+            segment_firsts[num_segments] = span.first;
+            segments[num_segments++] = cbezier_create(ctrl[0], ctrl[1], ctrl[2], ctrl[3]);
+            continue;
+        }
+
+        _fit_chord_params(pts, span.first, span.last, params);
+        _fit_bezier(pts, &span, params, ctrl);
+
+        u32 split = 0;
+        f32 max_error = _fit_max_error(pts, widths, span.first, span.last, ctrl, params, &split);
+
+        // Close fits are usually improved enough by a better parameterization
+        if (max_error > sqr_tolerance && max_error < sqr_tolerance * 4.0f) {
+            for (u32 i = 0; i < DRAW_SPLINE_MAX_ITERATIONS && max_error > sqr_tolerance; i++) {
+                _fit_reparameterize(pts, span.first, span.last, ctrl, params);
+                _fit_bezier(pts, &span, params, ctrl);
+
+                max_error = _fit_max_error(pts, widths, span.first, span.last, ctrl, params, &split);
+            }
+        }
+
+        if (max_error <= sqr_tolerance) {
+            segment_firsts[num_segments] = span.first;
+            segments[num_segments++] = cbezier_create(ctrl[0], ctrl[1], ctrl[2], ctrl[3]);
+            continue;
+        }
+
+        // Splitting with a shared tangent keeps the spline smooth at the split
+        vec2f tan_center = _fit_tangent(pts[split + 1], pts[split - 1]);
+        if (vec2f_sqr_len(tan_center) == 0.0f) {
+            tan_center = _fit_tangent(pts[split], pts[split - 1]);
+        }
+
+        stack[stack_size++] = (_fit_span){ split, span.last, vec2f_scl(tan_center, -1.0f), span.tan_last };
+        stack[stack_size++] = (_fit_span){ span.first, split, span.tan_first, tan_center };
+    }
+
+    spline.num_segments = num_segments;
+    spline.segments = MGA_PUSH_ARRAY(arena, cubic_bezier, num_segments);
+    memcpy(spline.segments, segments, sizeof(cubic_bezier) * num_segments);
+
+    if (widths != NULL) {
+        spline.widths = MGA_PUSH_ARRAY(arena, f32, num_segments + 1);
+
+        for (u32 i = 0; i < num_segments; i++) {
+            spline.widths[i] = widths[segment_firsts[i]];
+        }
+        spline.widths[num_segments] = widths[num_points - 1];
+    }
+
+    mga_scratch_release(scratch);
+
+    return spline;
+}
+
+u32 draw_spline_subdivisions(const cubic_bezier* segment, f32 tolerance) {
+    // The second derivative is 6b + 6at, which is largest at one of the ends
+    // A piece of length h strays at most max|B''| h^2 / 8 from its chord
+    f32 max_accel = 6.0f * sqrtf(MAX(
+        vec2f_sqr_len(segment->b),
+        vec2f_sqr_len(vec2f_add(segment->a, segment->b))
+    ));
+
+    if (tolerance <= 0.0f || max_accel == 0.0f) {
+        return 1;
+    }
+
+    f32 pieces = ceilf(sqrtf(max_accel / (8.0f * tolerance)));
+
+    return (u32)MAX(pieces, 1.0f);
+}
+
+vec2f* draw_spline_flatten(mg_arena* arena, const draw_spline* spline, f32 tolerance, u32* num_points) {
+    if (spline == NULL || spline->num_segments == 0 || num_points == NULL) {
+        fprintf(stderr, "Cannot flatten spline: spline is NULL or empty\n");
+        return NULL;
+    }
+
+    u32 total = 1;
+    for (u32 i = 0; i < spline->num_segments; i++) {
+        total += draw_spline_subdivisions(&spline->segments[i], tolerance);
+    }
+
+    vec2f* out = MGA_PUSH_ARRAY(arena, vec2f, total);
+    u32 num_out = 0;
+
+    out[num_out++] = spline->segments[0].d;
+
+    for (u32 i = 0; i < spline->num_segments; i++) {
+        const cubic_bezier* segment = &spline->segments[i];
+        u32 pieces = draw_spline_subdivisions(segment, tolerance);
+
+        for (u32 j = 1; j <= pieces; j++) {
+            out[num_out++] = cbezier_calc(segment, (f32)j / (f32)pieces);
+        }
+    }
+
+    *num_points = num_out;
+
+    return out;
+}
+
+// Unit vector from one point toward the other, zero if they are the same
+static vec2f _fit_tangent(vec2f from, vec2f to) {
+    vec2f dir = vec2f_sub(to, from);
+    f32 sqr_len = vec2f_sqr_len(dir);
+
+    return sqr_len == 0.0f ? (vec2f){ 0 } : vec2f_scl(dir, 1.0f / sqrtf(sqr_len));
+}
+
+static void _fit_chord_params(const vec2f* points, u32 first, u32 last, f32* params) {
+    params[first] = 0.0f;
+
+    for (u32 i = first + 1; i <= last; i++) {
+        params[i] = params[i - 1] + vec2f_dist(points[i], points[i - 1]);
+    }
+
+    f32 total = params[last];
+    for (u32 i = first + 1; i <= last; i++) {
+        params[i] /= total;
+    }
+}
+
+static void _fit_bernstein(f32 t, f32 b[4]) {
+    f32 mt = 1.0f - t;
+
+    b[0] = mt * mt * mt;
+    b[1] = 3.0f * t * mt * mt;
+    b[2] = 3.0f * t * t * mt;
+    b[3] = t * t * t;
+}
+
+static vec2f _fit_eval(const vec2f ctrl[4], f32 t) {
+    f32 b[4];
+    _fit_bernstein(t, b);
+
+    vec2f out = vec2f_scl(ctrl[0], b[0]);
+    out = vec2f_add(out, vec2f_scl(ctrl[1], b[1]));
+    out = vec2f_add(out, vec2f_scl(ctrl[2], b[2]));
+    out = vec2f_add(out, vec2f_scl(ctrl[3], b[3]));
+
+    return out;
+}
+
+// Least squares fit for the lengths of the two tangents, the end points stay fixed
+static void _fit_bezier(const vec2f* points, const _fit_span* span, const f32* params, vec2f ctrl[4]) {
+    vec2f p0 = points[span->first];
+    vec2f p3 = points[span->last];
+
+    f32 c00 = 0.0f, c01 = 0.0f, c11 = 0.0f;
+    f32 x0 = 0.0f, x1 = 0.0f;
+
+    for (u32 i = span->first; i <= span->last; i++) {
+        f32 b[4];
+        _fit_bernstein(params[i], b);
+
+        vec2f a0 = vec2f_scl(span->tan_first, b[1]);
+        vec2f a1 = vec2f_scl(span->tan_last, b[2]);
+
+        c00 += vec2f_dot(a0, a0);
+        c01 += vec2f_dot(a0, a1);
+        c11 += vec2f_dot(a1, a1);
+
+        vec2f tmp = vec2f_sub(points[i], vec2f_add(
+            vec2f_scl(p0, b[0] + b[1]), vec2f_scl(p3, b[2] + b[3])
+        ));
+
+        x0 += vec2f_dot(a0, tmp);
+        x1 += vec2f_dot(a1, tmp);
+    }
+
+    f32 det_c = c00 * c11 - c01 * c01;
+    f32 alpha_first = 0.0f;
+    f32 alpha_last = 0.0f;
+
+    if (det_c != 0.0f) {
+        alpha_first = (x0 * c11 - x1 * c01) / det_c;
+        alpha_last = (c00 * x1 - c01 * x0) / det_c;
+    }
+
+    // Tangents that are too short or point backwards give a bad curve,
+    // a third of the distance along each tangent is a safe fallback
+    f32 seg_len = vec2f_dist(p0, p3);
+    f32 epsilon = 1e-6f * seg_len;
+    if (alpha_first < epsilon || alpha_last < epsilon) {
+        alpha_first = seg_len / 3.0f;
+        alpha_last = seg_len / 3.0f;
+    }
+
+    ctrl[0] = p0;
+    ctrl[1] = vec2f_add(p0, vec2f_scl(span->tan_first, alpha_first));
+    ctrl[2] = vec2f_add(p3, vec2f_scl(span->tan_last, alpha_last));
+    ctrl[3] = p3;
+}
+
+// Returns the largest squared distance, split is set to the point it belongs to
+// With widths, the distance includes how far the edges move from the width changing linearly along the span
+static f32 _fit_max_error(const vec2f* points, const f32* widths, u32 first, u32 last, const vec2f ctrl[4], const f32* params, u32* split) {
+    f32 max_error = 0.0f;
+    *split = (first + last) / 2;
+
+    for (u32 i = first + 1; i < last; i++) {
+        f32 error = vec2f_sqr_dist(_fit_eval(ctrl, params[i]), points[i]);
+
+        if (widths != NULL) {
+            f32 width = widths[first] + (widths[last] - widths[first]) * params[i];
+            f32 dist = sqrtf(error) + fabsf(width - widths[i]) * 0.5f;
+
+            error = dist * dist;
+        }
+
+        if (error > max_error) {
+            max_error = error;
+            *split = i;
+        }
+    }
+
+    return max_error;
+}
+
+// One Newton-Raphson step per point toward the parameter of the closest point on the curve
+static void _fit_reparameterize(const vec2f* points, u32 first, u32 last, const vec2f ctrl[4], f32* params) {
+    vec2f d1[3] = {
+        vec2f_scl(vec2f_sub(ctrl[1], ctrl[0]), 3.0f),
+        vec2f_scl(vec2f_sub(ctrl[2], ctrl[1]), 3.0f),
+        vec2f_scl(vec2f_sub(ctrl[3], ctrl[2]), 3.0f),
+    };
+    vec2f d2[2] = {
+        vec2f_scl(vec2f_sub(d1[1], d1[0]), 2.0f),
+        vec2f_scl(vec2f_sub(d1[2], d1[1]), 2.0f),
+    };
+
+    for (u32 i = first + 1; i < last; i++) {
+        f32 t = params[i];
+        f32 mt = 1.0f - t;
+
+        vec2f q = _fit_eval(ctrl, t);
+        vec2f q1 = vec2f_add(
+            vec2f_add(vec2f_scl(d1[0], mt * mt), vec2f_scl(d1[1], 2.0f * t * mt)),
+            vec2f_scl(d1[2], t * t)
+        );
+        vec2f q2 = vec2f_add(vec2f_scl(d2[0], mt), vec2f_scl(d2[1], t));
+
+        vec2f diff = vec2f_sub(q, points[i]);
+        f32 numerator = vec2f_dot(diff, q1);
+        f32 denominator = vec2f_dot(q1, q1) + vec2f_dot(diff, q2);
+
+        if (denominator != 0.0f) {
+            params[i] = CLAMP(t - numerator / denominator, 0.0f, 1.0f);
+        }
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef DRAW_SPLINE_H
+#define DRAW_SPLINE_H
+
+#include "base/base.h"
+#include "draw_point_bucket.h"
+
+// Newton-Raphson reparameterization steps before a span gets split
+#define DRAW_SPLINE_MAX_ITERATIONS 4
+// Points where the direction turns by more than this (cosine of the angle)
+// are kept as corners instead of being smoothed over
+#define DRAW_SPLINE_CORNER_COS 0.25f
+
+// Chain of cubic Bezier segments, each one starts where the previous one ends
+typedef struct {
+    u32 num_segments;
+    cubic_bezier* segments;
+
+    // Width at the start of every segment and at the end of the last one, widths change linearly in between
+    // NULL if the points have no widths
+    f32* widths;
+} draw_spline;
+
+// Fits a spline to a finished point list, no point is further than tolerance from it
+// Uses the least squares fit from Schneider's "An Algorithm for Automatically Fitting Digitized Curves",
+// splitting spans at the point with the largest error until every span fits.
+// With point widths, the edges of the lines are kept within tolerance as well.
+// The segments and widths are pushed onto arena
+draw_spline draw_spline_fit(mg_arena* arena, const draw_point_list* points, f32 tolerance);
+
+// Number of pieces the segment needs so that straight lines between them
+// stay within tolerance of the curve, always at least 1
+u32 draw_spline_subdivisions(const cubic_bezier* segment, f32 tolerance);
+
+// Regenerates a polyline from the spline at the density needed for tolerance
+// The points are pushed onto arena
+vec2f* draw_spline_flatten(mg_arena* arena, const draw_spline* spline, f32 tolerance, u32* num_points);
+
+#endif // DRAW_SPLINE_H
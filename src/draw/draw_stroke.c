@@ -0,0 +1,177 @@
+#include "draw_stroke.h"
+
+#include <stdio.h>
+#include <math.h>
+
+// Keeps knot intervals away from zero when control points overlap
+#define KNOT_EPSILON 1e-6f
+
+// p(t) = c0 + c1 t + c2 t^2 + c3 t^3 for t in [0, 1]
+typedef struct {
+    vec2f c0, c1, c2, c3;
+} _stroke_curve;
+
+static _stroke_curve _stroke_uniform(vec2f p0, vec2f p1, vec2f p2, vec2f p3);
+static _stroke_curve _stroke_centripetal(vec2f p0, vec2f p1, vec2f p2, vec2f p3);
+static vec2f _stroke_eval(const _stroke_curve* curve, f32 t);
+static u32 _stroke_subdivide(const _stroke_curve* curve, f32 t0, vec2f p0, f32 t1, vec2f p1, f32 sqr_tolerance, u32 depth, vec2f* out, const f32 widths[2], f32* out_widths);
+
+void draw_stroke_begin(draw_stroke_builder* builder, vec2f first, f32 first_width, draw_stroke_spline spline, f32 tolerance) {
+    if (builder == NULL) {
+        fprintf(stderr, "Cannot begin NULL stroke builder\n");
+        return;
+    }
+
+    builder->spline = spline;
+    builder->tolerance = tolerance;
+
+    builder->prev_prev = first;
+    builder->prev = first;
+    builder->prev_width = first_width;
+}
+
+u32 draw_stroke_add_samples(draw_stroke_builder* builder, const vec2f* samples, const f32* widths, u32 num_samples, vec2f* out, f32* out_widths) {
+    if (builder == NULL || (num_samples > 0 && (samples == NULL || out == NULL))) {
+        fprintf(stderr, "Cannot add samples to stroke: builder, samples or out is NULL\n");
+        return 0;
+    }
+    if ((widths == NULL) != (out_widths == NULL)) {
+        fprintf(stderr, "Cannot add samples to stroke: widths and out_widths have to be given together\n");
+        return 0;
+    }
+
+    f32 sqr_tolerance = builder->tolerance * builder->tolerance;
+    u32 num_out = 0;
+
+    for (u32 i = 0; i < num_samples; i++) {
+        vec2f p0 = builder->prev_prev;
+        vec2f p1 = builder->prev;
+        vec2f p2 = samples[i];
+
+        // Pressure can change while the pen stays still, the next span starts with the new width
+        f32 span_widths[2] = { builder->prev_width, widths == NULL ? 0.0f : widths[i] };
+        builder->prev_width = span_widths[1];
+
+        if (vec2f_eq(p1, p2)) {
+            continue;
+        }
+
+        // The first span has no point before it, so the second one is mirrored
+        if (vec2f_eq(p0, p1)) {
+            p0 = vec2f_sub(vec2f_scl(p1, 2.0f), p2);
+        }
+
+        // Chosen so the uniform spline is the quadratic through p0, p1 and p2,
+        // which is the least surprising guess for where the pen goes next
+        vec2f p3 = vec2f_add(p0, vec2f_scl(vec2f_sub(p2, p1), 3.0f));
+
+        _stroke_curve curve = builder->spline == DRAW_STROKE_CENTRIPETAL ?
+            _stroke_centripetal(p0, p1, p2, p3) : _stroke_uniform(p0, p1, p2, p3);
+
+        num_out += _stroke_subdivide(
+            &curve, 0.0f, p1, 1.0f, p2, sqr_tolerance, 0,
+            out + num_out, span_widths, out_widths == NULL ? NULL : out_widths + num_out
+        );
+
+        builder->prev_prev = p1;
+        builder->prev = p2;
+    }
+
+    return num_out;
+}
+
+static _stroke_curve _stroke_uniform(vec2f p0, vec2f p1, vec2f p2, vec2f p3) {
+    // https://www.mvps.org/directx/articles/catmull/
+    _stroke_curve curve = {
+        .c0 = p1,
+        .c1 = vec2f_scl(vec2f_sub(p2, p0), 0.5f),
+        .c2 = vec2f_scl(vec2f_add(
+            vec2f_sub(vec2f_scl(p0, 2.0f), vec2f_scl(p1, 5.0f)),
+            vec2f_sub(vec2f_scl(p2, 4.0f), p3)
+        ), 0.5f),
+        .c3 = vec2f_scl(vec2f_add(
+            vec2f_sub(vec2f_scl(p1, 3.0f), p0),
+            vec2f_sub(p3, vec2f_scl(p2, 3.0f))
+        ), 0.5f),
+    };
+
+    return curve;
+}
+
+static _stroke_curve _stroke_centripetal(vec2f p0, vec2f p1, vec2f p2, vec2f p3) {
+    // Knot intervals are the distances raised to 0.5, sqrt of the distance is the fourth root of the squared distance
+    f32 dt0 = powf(MAX(vec2f_sqr_dist(p0, p1), KNOT_EPSILON), 0.25f);
+    f32 dt1 = powf(MAX(vec2f_sqr_dist(p1, p2), KNOT_EPSILON), 0.25f);
+    f32 dt2 = powf(MAX(vec2f_sqr_dist(p2, p3), KNOT_EPSILON), 0.25f);
+
+    // Tangents at p1 and p2 for the non-uniform knots
+    // https://www.cemyuksel.com/research/catmullrom_param/
+    vec2f m1 = vec2f_add(
+        vec2f_sub(vec2f_scl(vec2f_sub(p1, p0), 1.0f / dt0), vec2f_scl(vec2f_sub(p2, p0), 1.0f / (dt0 + dt1))),
+        vec2f_scl(vec2f_sub(p2, p1), 1.0f / dt1)
+    );
+    vec2f m2 = vec2f_add(
+        vec2f_sub(vec2f_scl(vec2f_sub(p2, p1), 1.0f / dt1), vec2f_scl(vec2f_sub(p3, p1), 1.0f / (dt1 + dt2))),
+        vec2f_scl(vec2f_sub(p3, p2), 1.0f / dt2)
+    );
+
+    // Rescaled to the [0, 1] span
+    m1 = vec2f_scl(m1, dt1);
+    m2 = vec2f_scl(m2, dt1);
+
+    // Hermite form
+    vec2f d = vec2f_sub(p2, p1);
+    _stroke_curve curve = {
+        .c0 = p1,
+        .c1 = m1,
+        .c2 = vec2f_sub(vec2f_sub(vec2f_scl(d, 3.0f), vec2f_scl(m1, 2.0f)), m2),
+        .c3 = vec2f_add(vec2f_add(vec2f_scl(d, -2.0f), m1), m2),
+    };
+
+    return curve;
+}
+
+static vec2f _stroke_eval(const _stroke_curve* curve, f32 t) {
+    vec2f p = curve->c3;
+    p = vec2f_add(vec2f_scl(p, t), curve->c2);
+    p = vec2f_add(vec2f_scl(p, t), curve->c1);
+    p = vec2f_add(vec2f_scl(p, t), curve->c0);
+
+    return p;
+}
+
+// Writes the points after p0 up to and including p1
+// out_widths gets the widths at the start and end of the span interpolated to every point, if it is not NULL
+static u32 _stroke_subdivide(const _stroke_curve* curve, f32 t0, vec2f p0, f32 t1, vec2f p1, f32 sqr_tolerance, u32 depth, vec2f* out, const f32 widths[2], f32* out_widths) {
+    f32 tm = (t0 + t1) * 0.5f;
+    vec2f pm = _stroke_eval(curve, tm);
+
+    // Distance of the curve midpoint from the chord
+    vec2f chord = vec2f_sub(p1, p0);
+    vec2f mid_vec = vec2f_sub(pm, p0);
+    f32 sqr_chord = vec2f_dot(chord, chord);
+
+    f32 sqr_dist = vec2f_sqr_len(mid_vec);
+    if (sqr_chord > 0.0f) {
+        f32 t = vec2f_dot(mid_vec, chord) / sqr_chord;
+        t = CLAMP(t, 0, 1);
+        sqr_dist = vec2f_sqr_dist(mid_vec, vec2f_scl(chord, t));
+    }
+
+    if (depth < DRAW_STROKE_MAX_DEPTH && sqr_dist > sqr_tolerance) {
+        u32 num_out = _stroke_subdivide(curve, t0, p0, tm, pm, sqr_tolerance, depth + 1, out, widths, out_widths);
+        num_out += _stroke_subdivide(
+            curve, tm, pm, t1, p1, sqr_tolerance, depth + 1,
+            out + num_out, widths, out_widths == NULL ? NULL : out_widths + num_out
+        );
+
+        return num_out;
+    }
+
+    out[0] = p1;
+    if (out_widths != NULL) {
+        out_widths[0] = widths[0] + (widths[1] - widths[0]) * t1;
+    }
+
+    return 1;
+}
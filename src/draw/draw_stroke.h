@@ -0,0 +1,45 @@
+#ifndef DRAW_STROKE_H
+#define DRAW_STROKE_H
+
+#include "base/base.h"
+
+// Each span between two samples is split in half at most this many times
+#define DRAW_STROKE_MAX_DEPTH 6
+// Most points a single span can produce
+#define DRAW_STROKE_MAX_SPAN_POINTS (1 << DRAW_STROKE_MAX_DEPTH)
+
+typedef enum {
+    // Evenly spaced knots, can overshoot and loop when samples are unevenly spaced
+    DRAW_STROKE_UNIFORM,
+    // Knots spaced by the square root of the distance between samples, which avoids cusps and self intersections
+    DRAW_STROKE_CENTRIPETAL,
+} draw_stroke_spline;
+
+// Turns input samples into stroke points along a Catmull-Rom spline
+// Spans are split until every piece is within tolerance of the curve,
+// so tight curves get many points and straight runs get only their end.
+// The next sample is not known yet when a span is built, so the last control point is extrapolated.
+// Samples can carry a width, which changes linearly along each span.
+typedef struct {
+    draw_stroke_spline spline;
+
+    // Largest distance between the curve and the output segments
+    // Can be changed between samples, for example when the view zooms
+    f32 tolerance;
+
+    // prev is the start of the next span
+    vec2f prev_prev;
+    vec2f prev;
+    f32 prev_width;
+} draw_stroke_builder;
+
+void draw_stroke_begin(draw_stroke_builder* builder, vec2f first, f32 first_width, draw_stroke_spline spline, f32 tolerance);
+
+// Builds the spans from the previous sample through every sample
+// Every span ends with its sample, samples equal to the previous one are skipped and only update the width
+// out needs room for num_samples * DRAW_STROKE_MAX_SPAN_POINTS, out_widths needs the same room
+// widths and out_widths can both be NULL for strokes with one width
+// Returns the number of points written to out
+u32 draw_stroke_add_samples(draw_stroke_builder* builder, const vec2f* samples, const f32* widths, u32 num_samples, vec2f* out, f32* out_widths);
+
+#endif // DRAW_STROKE_H
@@ -0,0 +1,298 @@
+#include "draw_tiles.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "os/os.h"
+
+typedef struct {
+    i32 x, y;
+    f32 sqr_dist;
+} _tile_request;
+
+static u32 _tile_hash(i32 x, i32 y, i32 level) {
+    return ((u32)x * 73856093u) ^ ((u32)y * 19349663u) ^ ((u32)level * 83492791u);
+}
+static f32 _tile_size(i32 level) {
+    return ldexpf(DRAW_TILE_BASE_SIZE, level);
+}
+static rectf _tile_rect(i32 x, i32 y, i32 level) {
+    f32 size = _tile_size(level);
+    return (rectf){ x * size, y * size, size, size };
+}
+
+static draw_tile* _tile_find(draw_tiles* tiles, i32 x, i32 y, i32 level);
+static void _tile_touch(draw_tiles* tiles, draw_tile* tile);
+static draw_tile* _tile_acquire(draw_tiles* tiles, i32 x, i32 y, i32 level);
+static void _tile_render(draw_tiles* tiles, draw_tile* tile, const gfx_window* win);
+static void _tile_draw(draw_tile* tile, const draw_layer_shaders* shaders, viewf view);
+static int _tile_request_cmp(const void* a, const void* b);
+
+draw_tiles* draw_tiles_create(mg_arena* arena, u32 max_tiles, draw_tiles_render_func* render_func, void* user_data) {
+    if (max_tiles == 0) {
+        fprintf(stderr, "Cannot create tiles with a budget of zero tiles\n");
+        return NULL;
+    }
+
+    draw_tiles* tiles = MGA_PUSH_ZERO_STRUCT(arena, draw_tiles);
+
+    tiles->arena = arena;
+    tiles->render_func = render_func;
+    tiles->user_data = user_data;
+    tiles->max_tiles = max_tiles;
+
+    tiles->hash_size = 1;
+    while (tiles->hash_size < max_tiles * 2) {
+        tiles->hash_size <<= 1;
+    }
+    tiles->hash_table = MGA_PUSH_ZERO_ARRAY(arena, draw_tile*, tiles->hash_size);
+
+    return tiles;
+}
+void draw_tiles_destroy(draw_tiles* tiles) {
+    if (tiles == NULL) {
+        fprintf(stderr, "Cannot destroy tiles: tiles is NULL\n");
+        return;
+    }
+
+    for (draw_tile* tile = tiles->lru_first; tile != NULL; tile = tile->next) {
+        draw_layer_destroy(tile->layer);
+    }
+}
+
+void draw_tiles_invalidate(draw_tiles* tiles, rectf rect) {
+    if (tiles == NULL) {
+        fprintf(stderr, "Cannot invalidate NULL tiles\n");
+        return;
+    }
+
+    for (draw_tile* tile = tiles->lru_first; tile != NULL; tile = tile->next) {
+        if (rectf_collide_rectf(_tile_rect(tile->x, tile->y, tile->level), rect)) {
+            tile->valid = false;
+        }
+    }
+}
+void draw_tiles_invalidate_all(draw_tiles* tiles) {
+    if (tiles == NULL) {
+        fprintf(stderr, "Cannot invalidate NULL tiles\n");
+        return;
+    }
+
+    for (draw_tile* tile = tiles->lru_first; tile != NULL; tile = tile->next) {
+        tile->valid = false;
+    }
+}
+
+b32 draw_tiles_draw(draw_tiles* tiles, const draw_layer_shaders* shaders, const gfx_window* win, viewf view, u64 render_budget_usec) {
+    if (tiles == NULL) {
+        fprintf(stderr, "Cannot draw tiles: tiles is NULL\n");
+        return false;
+    }
+
+    u64 start_time = os_now_usec();
+
+    tiles->frame++;
+
+    // Picking the level where tile pixels are at least as small as screen pixels
+    f32 world_per_pixel = view.width / (f32)win->width;
+    i32 level = (i32)floorf(log2f(world_per_pixel * DRAW_TILE_PIXELS / DRAW_TILE_BASE_SIZE));
+
+    rectf bounds = viewf_bounding_box(view);
+
+    i32 min_x, min_y, max_x, max_y;
+    u32 num_visible = 0;
+
+    // Every visible tile needs to fit in the budget at once, otherwise tiles would evict each other every frame
+    while (true) {
+        f32 size = _tile_size(level);
+
+        min_x = (i32)floorf(bounds.x / size);
+        min_y = (i32)floorf(bounds.y / size);
+        max_x = (i32)floorf((bounds.x + bounds.w) / size);
+        max_y = (i32)floorf((bounds.y + bounds.h) / size);
+
+        num_visible = (u32)(max_x - min_x + 1) * (u32)(max_y - min_y + 1);
+
+        if (num_visible <= tiles->max_tiles / 2 || num_visible <= 1) {
+            break;
+        }
+
+        level++;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    _tile_request* requests = MGA_PUSH_ARRAY(scratch.arena, _tile_request, num_visible);
+    u32 num_requests = 0;
+
+    // Coarser tiles go first so that anything more detailed is drawn over them
+    for (i32 y = min_y; y <= max_y; y++) {
+        for (i32 x = min_x; x <= max_x; x++) {
+            draw_tile* tile = _tile_find(tiles, x, y, level);
+
+            if (tile != NULL && tile->valid) {
+                continue;
+            }
+
+            rectf rect = _tile_rect(x, y, level);
+            vec2f center = { rect.x + rect.w * 0.5f, rect.y + rect.h * 0.5f };
+
+            requests[num_requests++] = (_tile_request){
+                x, y, vec2f_sqr_dist(center, view.center)
+            };
+
+            if (tile != NULL) {
+                continue;
+            }
+
+            for (i32 l = 1; l <= DRAW_TILE_FALLBACK_LEVELS; l++) {
+                f32 scale = (f32)(1 << l);
+                draw_tile* parent = _tile_find(
+                    tiles, (i32)floorf(x / scale), (i32)floorf(y / scale), level + l
+                );
+
+                if (parent == NULL) {
+                    continue;
+                }
+
+                if (parent->last_used_frame != tiles->frame) {
+                    _tile_draw(parent, shaders, view);
+                    _tile_touch(tiles, parent);
+                }
+
+                break;
+            }
+        }
+    }
+
+    // Stale tiles are drawn as well, they are still better than nothing while they wait to be rendered
+    for (i32 y = min_y; y <= max_y; y++) {
+        for (i32 x = min_x; x <= max_x; x++) {
+            draw_tile* tile = _tile_find(tiles, x, y, level);
+
+            if (tile != NULL) {
+                _tile_draw(tile, shaders, view);
+                _tile_touch(tiles, tile);
+            }
+        }
+    }
+
+    qsort(requests, num_requests, sizeof(_tile_request), _tile_request_cmp);
+
+    u32 num_rendered = 0;
+    for (; num_rendered < num_requests; num_rendered++) {
+        if (os_now_usec() - start_time >= render_budget_usec) {
+            break;
+        }
+
+        _tile_request* req = &requests[num_rendered];
+
+        draw_tile* tile = _tile_find(tiles, req->x, req->y, level);
+        if (tile == NULL) {
+            tile = _tile_acquire(tiles, req->x, req->y, level);
+        }
+
+        // Every tile is in use this frame
+        if (tile == NULL) {
+            break;
+        }
+
+        _tile_render(tiles, tile, win);
+        _tile_draw(tile, shaders, view);
+        _tile_touch(tiles, tile);
+    }
+
+    mga_scratch_release(scratch);
+
+    return num_rendered < num_requests;
+}
+
+static draw_tile* _tile_find(draw_tiles* tiles, i32 x, i32 y, i32 level) {
+    u32 index = _tile_hash(x, y, level) & (tiles->hash_size - 1);
+
+    for (draw_tile* tile = tiles->hash_table[index]; tile != NULL; tile = tile->hash_next) {
+        if (tile->x == x && tile->y == y && tile->level == level) {
+            return tile;
+        }
+    }
+
+    return NULL;
+}
+
+static void _tile_touch(draw_tiles* tiles, draw_tile* tile) {
+    tile->last_used_frame = tiles->frame;
+
+    DLL_REMOVE(tiles->lru_first, tiles->lru_last, tile);
+    DLL_PUSH_BACK(tiles->lru_first, tiles->lru_last, tile);
+}
+
+static draw_tile* _tile_acquire(draw_tiles* tiles, i32 x, i32 y, i32 level) {
+    draw_tile* tile = NULL;
+
+    if (tiles->num_tiles < tiles->max_tiles) {
+        tile = MGA_PUSH_ZERO_STRUCT(tiles->arena, draw_tile);
+        // Tiles are only shown scaled while the view moves, so they are not worth the memory of multisampling
+        tile->layer = draw_layer_create(tiles->arena, DRAW_TILE_PIXELS, DRAW_TILE_PIXELS, 0);
+
+        tiles->num_tiles++;
+    } else {
+        tile = tiles->lru_first;
+
+        if (tile == NULL || tile->last_used_frame == tiles->frame) {
+            return NULL;
+        }
+
+        // Removing the evicted tile from the hash table
+        u32 index = _tile_hash(tile->x, tile->y, tile->level) & (tiles->hash_size - 1);
+        draw_tile** cur = &tiles->hash_table[index];
+        while (*cur != tile) {
+            cur = &(*cur)->hash_next;
+        }
+        *cur = tile->hash_next;
+
+        DLL_REMOVE(tiles->lru_first, tiles->lru_last, tile);
+    }
+
+    tile->x = x;
+    tile->y = y;
+    tile->level = level;
+    tile->valid = false;
+
+    u32 index = _tile_hash(x, y, level) & (tiles->hash_size - 1);
+    tile->hash_next = tiles->hash_table[index];
+    tiles->hash_table[index] = tile;
+
+    DLL_PUSH_BACK(tiles->lru_first, tiles->lru_last, tile);
+
+    return tile;
+}
+
+static void _tile_render(draw_tiles* tiles, draw_tile* tile, const gfx_window* win) {
+    rectf rect = _tile_rect(tile->x, tile->y, tile->level);
+
+    viewf view = {
+        .center = { rect.x + rect.w * 0.5f, rect.y + rect.h * 0.5f },
+        .aspect_ratio = 1.0f,
+        .width = rect.w,
+        .rotation = 0.0f
+    };
+
+    draw_layer_begin(tile->layer);
+    tiles->render_func(tiles->user_data, view, rect);
+    draw_layer_end(tile->layer, win);
+
+    tile->valid = true;
+}
+
+static void _tile_draw(draw_tile* tile, const draw_layer_shaders* shaders, viewf view) {
+    draw_layer_draw(tile->layer, shaders, _tile_rect(tile->x, tile->y, tile->level), view);
+}
+
+static int _tile_request_cmp(const void* a, const void* b) {
+    f32 dist_a = ((const _tile_request*)a)->sqr_dist;
+    f32 dist_b = ((const _tile_request*)b)->sqr_dist;
+
+    return (dist_a > dist_b) - (dist_a < dist_b);
+}
+
@@ -0,0 +1,69 @@
+#ifndef DRAW_TILES_H
+#define DRAW_TILES_H
+
+#include "base/base.h"
+#include "gfx/gfx.h"
+#include "draw_layer.h"
+
+// Size of a tile texture in pixels
+#define DRAW_TILE_PIXELS 256
+// Size of a tile in world units at level 0
+// Each level up doubles the size of the tile
+#define DRAW_TILE_BASE_SIZE 256.0f
+// How many levels up to look for a replacement for a missing tile
+#define DRAW_TILE_FALLBACK_LEVELS 3
+
+// Called to render the contents of a tile
+// The tile is already bound and cleared, bounds is the world space area of the tile
+typedef void (draw_tiles_render_func)(void* user_data, viewf view, rectf bounds);
+
+typedef struct draw_tile {
+    // LRU list, last is the most recently used
+    struct draw_tile* next;
+    struct draw_tile* prev;
+
+    struct draw_tile* hash_next;
+
+    i32 x, y, level;
+
+    // False if the contents need to be rendered again
+    b32 valid;
+    u64 last_used_frame;
+
+    draw_layer* layer;
+} draw_tile;
+
+typedef struct {
+    mg_arena* arena;
+
+    draw_tiles_render_func* render_func;
+    void* user_data;
+
+    u32 max_tiles;
+    u32 num_tiles;
+
+    u32 hash_size;
+    draw_tile** hash_table;
+
+    draw_tile* lru_first;
+    draw_tile* lru_last;
+
+    u64 frame;
+} draw_tiles;
+
+// max_tiles is the budget of tile textures, each one is DRAW_TILE_PIXELS^2 RGBA pixels
+draw_tiles* draw_tiles_create(mg_arena* arena, u32 max_tiles, draw_tiles_render_func* render_func, void* user_data);
+void draw_tiles_destroy(draw_tiles* tiles);
+
+// Marks every tile touching rect as needing to be rendered again
+void draw_tiles_invalidate(draw_tiles* tiles, rectf rect);
+void draw_tiles_invalidate_all(draw_tiles* tiles);
+
+// Draws the view with the cached tiles
+// Missing tiles are rendered in order of distance to the view center until render_budget_usec runs out.
+// Until then, tiles from coarser levels are drawn in their place.
+// Returns true if there are still tiles waiting to be rendered
+b32 draw_tiles_draw(draw_tiles* tiles, const draw_layer_shaders* shaders, const gfx_window* win, viewf view, u64 render_budget_usec);
+
+#endif // DRAW_TILES_H
+
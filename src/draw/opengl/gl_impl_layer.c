@@ -0,0 +1,269 @@
+#include "draw/draw.h"
+
+#ifdef DRAW_BACKEND_OPENGL
+
+#include <stdio.h>
+
+#include "gfx/opengl/opengl.h"
+#include "gfx/opengl/opengl_helpers.h"
+
+typedef struct draw_layer_shaders {
+    u32 program;
+    u32 view_mat_loc;
+    u32 rect_loc;
+    u32 texture_loc;
+
+    // Empty vertex array, the quad is generated in the vertex shader
+    u32 vertex_array;
+} draw_layer_shaders;
+
+typedef struct _draw_layer_backend {
+    // Holds the contents that get drawn
+    u32 framebuffer;
+    u32 texture;
+
+    // Multisampled layers are rendered here and resolved into the texture by draw_layer_end
+    u32 msaa_framebuffer;
+    u32 msaa_renderbuffer;
+} draw_layer_backend;
+
+static const char* layer_vert;
+static const char* layer_frag;
+
+static void _layer_create_storage(draw_layer* layer);
+static void _layer_destroy_storage(draw_layer* layer);
+
+draw_layer_shaders* draw_layer_shaders_create(mg_arena* arena) {
+    draw_layer_shaders* shaders = MGA_PUSH_ZERO_STRUCT(arena, draw_layer_shaders);
+
+    shaders->program = glh_create_shader(layer_vert, layer_frag);
+
+    glUseProgram(shaders->program);
+    shaders->view_mat_loc = glGetUniformLocation(shaders->program, "u_view_mat");
+    shaders->rect_loc = glGetUniformLocation(shaders->program, "u_rect");
+    shaders->texture_loc = glGetUniformLocation(shaders->program, "u_texture");
+    glUseProgram(0);
+
+    glGenVertexArrays(1, &shaders->vertex_array);
+
+    return shaders;
+}
+void draw_layer_shaders_destroy(draw_layer_shaders* shaders) {
+    if (shaders == NULL) {
+        fprintf(stderr, "Cannot destroy layer shaders: shaders is NULL\n");
+        return;
+    }
+
+    glDeleteProgram(shaders->program);
+    glDeleteVertexArrays(1, &shaders->vertex_array);
+}
+
+draw_layer* draw_layer_create(mg_arena* arena, u32 width, u32 height, u32 samples) {
+    draw_layer* layer = MGA_PUSH_ZERO_STRUCT(arena, draw_layer);
+    layer->backend = MGA_PUSH_ZERO_STRUCT(arena, draw_layer_backend);
+
+    layer->width = width;
+    layer->height = height;
+    layer->samples = samples > 1 ? samples : 0;
+
+    _layer_create_storage(layer);
+
+    return layer;
+}
+void draw_layer_destroy(draw_layer* layer) {
+    if (layer == NULL) {
+        fprintf(stderr, "Cannot destroy layer: layer is NULL\n");
+        return;
+    }
+
+    _layer_destroy_storage(layer);
+}
+
+void draw_layer_resize(draw_layer* layer, u32 width, u32 height) {
+    if (layer == NULL) {
+        fprintf(stderr, "Cannot resize layer: layer is NULL\n");
+        return;
+    }
+
+    if (layer->width == width && layer->height == height) {
+        return;
+    }
+
+    _layer_destroy_storage(layer);
+
+    layer->width = width;
+    layer->height = height;
+
+    _layer_create_storage(layer);
+}
+
+void draw_layer_begin(draw_layer* layer) {
+    u32 framebuffer = layer->samples > 0 ? layer->backend->msaa_framebuffer : layer->backend->framebuffer;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glViewport(0, 0, layer->width, layer->height);
+
+    glClear(GL_COLOR_BUFFER_BIT);
+}
+void draw_layer_end(draw_layer* layer, const gfx_window* win) {
+    // Both framebuffers have the same size, so this only resolves the samples
+    if (layer->samples > 0) {
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, layer->backend->msaa_framebuffer);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, layer->backend->framebuffer);
+
+        glBlitFramebuffer(
+            0, 0, layer->width, layer->height,
+            0, 0, layer->width, layer->height,
+            GL_COLOR_BUFFER_BIT, GL_NEAREST
+        );
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, win->width, win->height);
+
+    glh_check_errors("draw_layer_end");
+}
+
+void draw_layer_draw_window(const draw_layer* layer, const draw_layer_shaders* shaders) {
+    if (layer == NULL) {
+        fprintf(stderr, "Cannot draw layer: layer is NULL\n");
+        return;
+    }
+
+    // The window can be multisampled and the layer is not, so it is drawn as a quad instead of blitted
+    // The quad goes from the top of the screen down, which undoes the flip in the vertex shader
+    mat3f identity = { .m = { 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f } };
+
+    glUseProgram(shaders->program);
+    glUniformMatrix3fv(shaders->view_mat_loc, 1, GL_FALSE, identity.m);
+    glUniform4f(shaders->rect_loc, -1.0f, 1.0f, 2.0f, -2.0f);
+    glUniform1i(shaders->texture_loc, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, layer->backend->texture);
+
+    // Replacing what is there, the layer is not premultiplied
+    b32 blend = glIsEnabled(GL_BLEND);
+    glDisable(GL_BLEND);
+
+    glBindVertexArray(shaders->vertex_array);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    if (blend) {
+        glEnable(GL_BLEND);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glBindVertexArray(0);
+
+    glh_check_errors("draw_layer_draw_window");
+}
+
+void draw_layer_draw(const draw_layer* layer, const draw_layer_shaders* shaders, rectf rect, viewf view) {
+    if (layer == NULL) {
+        fprintf(stderr, "Cannot draw layer: layer is NULL\n");
+        return;
+    }
+
+    mat3f view_mat = { 0 };
+    mat3f_from_view(&view_mat, view);
+
+    glUseProgram(shaders->program);
+    glUniformMatrix3fv(shaders->view_mat_loc, 1, GL_FALSE, view_mat.m);
+    glUniform4f(shaders->rect_loc, rect.x, rect.y, rect.w, rect.h);
+    glUniform1i(shaders->texture_loc, 0);
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, layer->backend->texture);
+
+    glBindVertexArray(shaders->vertex_array);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glUseProgram(0);
+    glBindVertexArray(0);
+}
+
+static void _layer_create_storage(draw_layer* layer) {
+    glGenTextures(1, &layer->backend->texture);
+    glBindTexture(GL_TEXTURE_2D, layer->backend->texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, layer->width, layer->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    glGenFramebuffers(1, &layer->backend->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, layer->backend->framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, layer->backend->texture, 0);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "Failed to create layer framebuffer\n");
+    }
+
+    if (layer->samples > 0) {
+        glGenRenderbuffers(1, &layer->backend->msaa_renderbuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, layer->backend->msaa_renderbuffer);
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, layer->samples, GL_RGBA8, layer->width, layer->height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &layer->backend->msaa_framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, layer->backend->msaa_framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, layer->backend->msaa_renderbuffer);
+
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            fprintf(stderr, "Failed to create multisampled layer framebuffer\n");
+        }
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glh_check_errors("_layer_create_storage");
+}
+static void _layer_destroy_storage(draw_layer* layer) {
+    glDeleteFramebuffers(1, &layer->backend->framebuffer);
+    glDeleteTextures(1, &layer->backend->texture);
+
+    if (layer->samples > 0) {
+        glDeleteFramebuffers(1, &layer->backend->msaa_framebuffer);
+        glDeleteRenderbuffers(1, &layer->backend->msaa_renderbuffer);
+    }
+}
+
+static const char* layer_vert = GLSL_SOURCE(
+    330,
+
+    out vec2 uv;
+
+    uniform mat3 u_view_mat;
+    uniform vec4 u_rect;
+
+    void main() {
+        vec2 corner = vec2(float(gl_VertexID % 2), float(gl_VertexID / 2));
+
+        // Layers are rendered with the y axis flipped
+        uv = vec2(corner.x, 1.0 - corner.y);
+
+        vec2 pos = u_rect.xy + corner * u_rect.zw;
+        gl_Position = vec4((u_view_mat * vec3(pos, 1.0)).xy, 0.0, 1.0);
+    }
+);
+
+static const char* layer_frag = GLSL_SOURCE(
+    330,
+
+    layout (location = 0) out vec4 out_col;
+
+    in vec2 uv;
+
+    uniform sampler2D u_texture;
+
+    void main() {
+        out_col = texture(u_texture, uv);
+    }
+);
+
+#endif // DRAW_BACKEND_OPENGL
+
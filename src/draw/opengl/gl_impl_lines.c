@@ -17,13 +17,41 @@ typedef struct draw_lines_shaders {
     u32 corner_program;
     u32 corner_view_mat_loc;
     u32 corner_screen_loc;
-    u32 corner_line_width_loc;
     u32 corner_col_loc;
+
+    u32 curve_program;
+    u32 curve_view_mat_loc;
+    u32 curve_pixels_per_unit_loc;
+    u32 curve_tolerance_loc;
+    u32 curve_col_loc;
+
+    u32 joint_program;
+    u32 joint_view_mat_loc;
+    u32 joint_col_loc;
 } draw_lines_shaders;
 
+// Simplified geometry for zoomed out views
+typedef struct {
+    // Largest distance from the full lines, in world units
+    f32 tolerance;
+
+    u32 num_verts;
+    u32 num_indices;
+    u32 num_corners;
+
+    u32 segment_array;
+    u32 corner_array;
+
+    u32 vert_buffer;
+    u32 index_buffer;
+    u32 corner_buffer;
+} _draw_lines_lod;
+
 typedef struct _draw_lines_backend {
     // last_points[2] is the most recent point
     vec2f last_points[3];
+    // Only used with point widths
+    f32 last_widths[3];
 
     u32 vert_capacity;
     u32 index_capacity;
@@ -40,6 +68,35 @@ typedef struct _draw_lines_backend {
     u32 vert_buffer;
     u32 index_buffer;
     u32 corner_buffer;
+
+    // One width per corner, only created for lines with point widths
+    // Without it the corner shader gets lines->width as a constant attribute
+    u32 corner_width_capacity;
+    u32 corner_width_buffer;
+
+    // Ordered from the least to the most simplified
+    u32 num_lods;
+    _draw_lines_lod lods[DRAW_LINES_MAX_LODS];
+
+    // Bezier segments evaluated on the GPU, drawn instead of everything above when set
+    u32 num_curves;
+    u32 curve_array;
+    u32 curve_buffer;
+    // num_curves + 1 widths at the joints, only created for lines with point widths
+    u32 curve_width_buffer;
+    // Kept so the curves can be fit again after the lines are restored
+    f32 curve_tolerance;
+
+    // Set while the segments, corners and LODs are deleted, for evicted lines and while the curves are drawn
+    // They are only built again by _lines_restore_geometry once the curves cannot be used
+    b32 geometry_dropped;
+
+    // Set by draw_lines_evict, all of the OpenGL objects above are deleted
+    // The sizes and last points are still kept up to date
+    b32 evicted;
+    // What is built again along with the geometry
+    b32 evicted_lods;
+    b32 evicted_curves;
 } draw_lines_backend;
 
 // Line vertex data
@@ -48,6 +105,7 @@ typedef struct {
 } line_vert;
 
 // Line corner instance data
+// The width at p1 is kept in a separate buffer for lines with point widths
 typedef struct {
     vec2f p0;
     vec2f p1;
@@ -58,16 +116,35 @@ typedef struct {
 #define TANGENT_EPSILON 1e-5
 #define MITER_LIMIT 1.2
 
+// Starting buffer sizes of new lines
+#define LINES_START_VERTS (DRAW_POINT_BUCKET_SIZE * 2)
+#define LINES_START_INDICES ((DRAW_POINT_BUCKET_SIZE - 1) * 6)
+// TODO: is there a better starting value?
+// how often are corners?
+#define LINES_START_CORNERS 8
+
+// Staging memory for one chunk of draw_lines_load
+#define LOAD_STAGING_SIZE MGA_MiB(32)
+
+// Segments with less than this fraction of the eraser radius inside it are only touching it
+#define ERASE_TOUCH_EPSILON 1e-3f
+
 static const char* line_seg_vert;
 static const char* line_seg_frag;
 static const char* corner_vert;
 static const char* corner_frag;
+static const char* curve_vert;
+static const char* joint_vert;
+static const char* joint_frag;
 
 draw_lines_shaders* draw_lines_shaders_create(mg_arena* arena) {
     draw_lines_shaders* shaders = MGA_PUSH_ZERO_STRUCT(arena, draw_lines_shaders);
 
     shaders->line_program = glh_create_shader(line_seg_vert, line_seg_frag);
     shaders->corner_program = glh_create_shader(corner_vert, corner_frag);
+    // Curve segments are antialiased the same way as the regular segments
+    shaders->curve_program = glh_create_shader(curve_vert, line_seg_frag);
+    shaders->joint_program = glh_create_shader(joint_vert, joint_frag);
 
     glUseProgram(shaders->line_program);
     shaders->line_view_mat_loc = glGetUniformLocation(shaders->line_program, "u_view_mat");
@@ -76,9 +153,18 @@ draw_lines_shaders* draw_lines_shaders_create(mg_arena* arena) {
     glUseProgram(shaders->corner_program);
     shaders->corner_view_mat_loc = glGetUniformLocation(shaders->corner_program, "u_view_mat");
     shaders->corner_screen_loc = glGetUniformLocation(shaders->corner_program, "u_screen");
-    shaders->corner_line_width_loc = glGetUniformLocation(shaders->corner_program, "u_line_width");
     shaders->corner_col_loc = glGetUniformLocation(shaders->corner_program, "u_col");
 
+    glUseProgram(shaders->curve_program);
+    shaders->curve_view_mat_loc = glGetUniformLocation(shaders->curve_program, "u_view_mat");
+    shaders->curve_pixels_per_unit_loc = glGetUniformLocation(shaders->curve_program, "u_pixels_per_unit");
+    shaders->curve_tolerance_loc = glGetUniformLocation(shaders->curve_program, "u_tolerance");
+    shaders->curve_col_loc = glGetUniformLocation(shaders->curve_program, "u_col");
+
+    glUseProgram(shaders->joint_program);
+    shaders->joint_view_mat_loc = glGetUniformLocation(shaders->joint_program, "u_view_mat");
+    shaders->joint_col_loc = glGetUniformLocation(shaders->joint_program, "u_col");
+
     glUseProgram(0);
 
     return shaders;
@@ -92,6 +178,8 @@ void draw_lines_shaders_destroy(draw_lines_shaders* shaders) {
 
     glDeleteProgram(shaders->line_program);
     glDeleteProgram(shaders->corner_program);
+    glDeleteProgram(shaders->curve_program);
+    glDeleteProgram(shaders->joint_program);
 }
 
 b32 _is_corner(vec2f p0, vec2f p1, vec2f p2) {
@@ -115,6 +203,66 @@ b32 _is_corner(vec2f p0, vec2f p1, vec2f p2) {
     return miter_scale >= MITER_LIMIT || vec2f_sqr_len(vec2f_add(l1, l2)) <= TANGENT_EPSILON;
 }
 
+// CPU side of building lines from a full set of points
+// These do not touch OpenGL or the point allocator, so they can run on any thread
+
+// Copies the points into the allocated buckets and computes the bounding box, geometry sizes and last points
+// The width has to be set beforehand, widths can be NULL
+static void _lines_prepare(draw_lines* lines, const vec2f* points, const f32* widths, u32 num_points);
+static void _lines_compute_bounds(draw_lines* lines, const vec2f* points, u32 num_points);
+static void _lines_set_last_points(draw_lines* lines, const vec2f* points, const f32* widths, u32 num_points);
+static void _lines_count_geometry(const vec2f* points, u32 num_points, u32* num_verts, u32* num_indices, u32* num_corners);
+// indices needs room for (num_points - 1) * 6 elements
+static void _lines_build_indices(const vec2f* points, u32 num_points, u32* indices);
+// verts and corners need room for the sizes from _lines_count_geometry
+// With widths, corner_widths needs the same room as corners. Without them, both are NULL and width is used everywhere
+static void _lines_tessellate(const vec2f* points, const f32* widths, u32 num_points, f32 width, line_vert* verts, line_corner* corners, f32* corner_widths);
+// Copies the points out of the buckets, out needs room for points.size
+// Returns false if the buckets do not have all the points
+static b32 _lines_gather_points(const draw_lines* lines, vec2f* out);
+// Same for the widths of lines with point widths
+static void _lines_gather_widths(const draw_lines* lines, f32* out);
+
+// Geometry of one simplified level before it is uploaded
+typedef struct {
+    f32 tolerance;
+
+    u32 num_verts;
+    u32 num_indices;
+    u32 num_corners;
+
+    line_vert* verts;
+    u32* indices;
+    line_corner* corners;
+} _lines_lod_geometry;
+
+// Simplifies and tessellates every level that removes enough points, everything is pushed onto arena
+// lods needs room for DRAW_LINES_MAX_LODS, returns the number of levels
+static u32 _lines_compute_lods(mg_arena* arena, const vec2f* points, u32 num_points, f32 width, _lines_lod_geometry* lods);
+
+// Allocates the buckets for num_points, the allocator is not thread safe
+static void _lines_alloc_points(draw_lines* lines, u32 num_points);
+// Creates the OpenGL objects with the initial geometry, the capacities are set to the current sizes
+// corner_widths is only used for lines with point widths
+static void _lines_create_objects(draw_lines* lines, u32 arrays[2], u32 buffers[3], const line_vert* verts, const u32* indices, const line_corner* corners, const f32* corner_widths);
+static void _lines_create_buffers(draw_lines* lines, u32 vert_capacity, u32 index_capacity, u32 corner_capacity);
+// Replaces the simplified levels of the lines
+static void _lines_upload_lods(draw_lines* lines, const _lines_lod_geometry* lods, u32 num_lods);
+static void _lines_free_lods(draw_lines* lines);
+// Creates the curve objects for the segments of the spline, if it has any
+static void _lines_upload_curves(draw_lines* lines, const draw_spline* spline);
+static void _lines_free_curves(draw_lines* lines);
+static void _lines_rebuild_geometry(draw_lines* lines);
+// Deletes the segments, corners and LODs, the LODs are marked to be built again with the geometry
+static void _lines_free_geometry(draw_lines* lines);
+// Builds the geometry and LODs again, does nothing for evicted lines and lines with curves
+static void _lines_restore_geometry(draw_lines* lines);
+// Drops the LODs and curves and brings back the geometry, for changes that only write part of it
+static void _lines_begin_edit(draw_lines* lines);
+static void _lines_unshare(draw_lines* lines, b32 keep_points);
+static f32 _lines_transform_scale(const mat3f* transform);
+static void _lines_draw_curves(const draw_lines* lines, const draw_lines_shaders* shaders, const mat3f* view_mat, f32 pixels_per_unit);
+
 draw_lines* draw_lines_from_points(mg_arena* arena, draw_point_allocator* allocator, vec2f* points, u32 num_points, vec4f col, f32 line_width) {
     if (num_points == 0) {
         fprintf(stderr, "Cannot create lines with zero points\n");
@@ -125,158 +273,893 @@ draw_lines* draw_lines_from_points(mg_arena* arena, draw_point_allocator* alloca
     lines->points = (draw_point_list){ .allocator = allocator };
     lines->backend = MGA_PUSH_ZERO_STRUCT(arena, draw_lines_backend);
 
-    vec2f min_pos = points[0];
-    vec2f max_pos = points[0];
+    lines->color = col;
+    lines->width = line_width;
+
+    lines->allocator = allocator;
+
+    _lines_alloc_points(lines, num_points);
+    _lines_prepare(lines, points, NULL, num_points);
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    line_vert* verts = MGA_PUSH_ZERO_ARRAY(scratch.arena, line_vert, lines->backend->num_verts);
+    u32* indices = MGA_PUSH_ZERO_ARRAY(scratch.arena, u32, lines->backend->num_indices);
+    line_corner* corners = MGA_PUSH_ZERO_ARRAY(scratch.arena, line_corner, lines->backend->num_corners);
+
+    _lines_build_indices(points, num_points, indices);
+    _lines_tessellate(points, NULL, num_points, line_width, verts, corners, NULL);
+
+    u32 arrays[2] = { 0 };
+    u32 buffers[3] = { 0 };
+    glGenVertexArrays(2, arrays);
+    glGenBuffers(3, buffers);
+
+    _lines_create_objects(lines, arrays, buffers, verts, indices, corners, NULL);
+
+    mga_scratch_release(scratch);
+
+    return lines;
+}
+
+typedef struct {
+    jobs_system* jobs;
+
+    const draw_lines_desc* descs;
+    draw_lines** lines;
+
+    // Simplified levels and curves are pushed onto the arena of the thread that computes them
+    mg_arena** thread_arenas;
+
+    // 0 if no curves are fit
+    f32 curve_tolerance;
+
+    // Staging geometry of the current chunk, indexed from chunk_start
+    u32 chunk_start;
+    line_vert** verts;
+    u32** indices;
+    line_corner** corners;
+    // NULL for lines without point widths
+    f32** corner_widths;
+
+    // DRAW_LINES_MAX_LODS levels per lines object
+    _lines_lod_geometry* lods;
+    u32* num_lods;
+
+    // Lines with segments here are drawn as curves and are not tessellated
+    draw_spline* splines;
+} _lines_load_ctx;
+
+static void _lines_load_prepare_range(void* ctx_ptr, u32 start, u32 end) {
+    _lines_load_ctx* ctx = (_lines_load_ctx*)ctx_ptr;
+
+    for (u32 i = start; i < end; i++) {
+        _lines_prepare(ctx->lines[i], ctx->descs[i].points, ctx->descs[i].widths, ctx->descs[i].num_points);
+    }
+}
+
+static void _lines_load_tessellate_range(void* ctx_ptr, u32 start, u32 end) {
+    _lines_load_ctx* ctx = (_lines_load_ctx*)ctx_ptr;
+
+    mg_arena* arena = ctx->thread_arenas[jobs_thread_index(ctx->jobs)];
+
+    for (u32 i = start; i < end; i++) {
+        const draw_lines_desc* desc = &ctx->descs[ctx->chunk_start + i];
+
+        // Single points keep their circle
+        if (ctx->curve_tolerance > 0.0f && desc->num_points > 1) {
+            ctx->splines[i] = draw_spline_fit(arena, &ctx->lines[ctx->chunk_start + i]->points, ctx->curve_tolerance);
+
+            if (ctx->splines[i].num_segments > 0) {
+                continue;
+            }
+        }
+
+        _lines_build_indices(desc->points, desc->num_points, ctx->indices[i]);
+        _lines_tessellate(
+            desc->points, desc->widths, desc->num_points, desc->width,
+            ctx->verts[i], ctx->corners[i], ctx->corner_widths[i]
+        );
+
+        // Simplifying does not keep track of the widths
+        if (desc->widths == NULL) {
+            ctx->num_lods[i] = _lines_compute_lods(
+                arena, desc->points, desc->num_points, desc->width, ctx->lods + i * DRAW_LINES_MAX_LODS
+            );
+        }
+    }
+}
+
+static u64 _lines_staging_size(const draw_lines* lines) {
+    u64 corner_size = sizeof(line_corner) + (lines->points.has_widths ? sizeof(f32) : 0);
+
+    return sizeof(line_vert) * lines->backend->num_verts +
+        sizeof(u32) * lines->backend->num_indices +
+        corner_size * lines->backend->num_corners;
+}
+
+b32 draw_lines_load(mg_arena* arena, draw_point_allocator* allocator, jobs_system* jobs, const draw_lines_desc* descs, u32 num_lines, f32 curve_tolerance, draw_lines** out) {
+    for (u32 i = 0; i < num_lines; i++) {
+        if (descs[i].num_points == 0) {
+            fprintf(stderr, "Cannot load lines with zero points\n");
+            return false;
+        }
+    }
+
+    mga_desc staging_desc = {
+        .desired_max_size = MGA_GiB(1),
+        .desired_block_size = MGA_MiB(1)
+    };
+    mg_arena* staging = mga_create(&staging_desc);
+    if (staging == NULL) {
+        fprintf(stderr, "Cannot load lines: failed to create staging arena\n");
+        return false;
+    }
+
+    u32 num_threads = jobs_num_threads(jobs);
+    mg_arena** thread_arenas = MGA_PUSH_ARRAY(staging, mg_arena*, num_threads);
+
+    mga_desc thread_desc = {
+        .desired_max_size = MGA_MiB(256),
+        .desired_block_size = MGA_MiB(1)
+    };
+    for (u32 i = 0; i < num_threads; i++) {
+        thread_arenas[i] = mga_create(&thread_desc);
+
+        if (thread_arenas[i] == NULL) {
+            fprintf(stderr, "Cannot load lines: failed to create thread arena\n");
+
+            for (u32 j = 0; j < i; j++) {
+                mga_destroy(thread_arenas[j]);
+            }
+            mga_destroy(staging);
+
+            return false;
+        }
+    }
+
+    // Objects and buckets come from shared allocators, so they are created up front on this thread
+    for (u32 i = 0; i < num_lines; i++) {
+        draw_lines* lines = MGA_PUSH_ZERO_STRUCT(arena, draw_lines);
+        lines->points = (draw_point_list){ .allocator = allocator };
+        lines->backend = MGA_PUSH_ZERO_STRUCT(arena, draw_lines_backend);
+
+        lines->color = descs[i].color;
+        lines->width = descs[i].width;
+
+        lines->allocator = allocator;
+        lines->points.has_widths = descs[i].widths != NULL;
+
+        _lines_alloc_points(lines, descs[i].num_points);
+
+        out[i] = lines;
+    }
+
+    _lines_load_ctx ctx = {
+        .jobs = jobs,
+        .descs = descs,
+        .lines = out,
+        .thread_arenas = thread_arenas,
+        .curve_tolerance = curve_tolerance
+    };
+
+    // Copying points, bounding boxes and geometry sizes
+    jobs_parallel_for(jobs, num_lines, 0, _lines_load_prepare_range, &ctx);
+
+    // Geometry is tessellated and uploaded in chunks to keep the staging memory bounded
+    u32 chunk_start = 0;
+    while (chunk_start < num_lines) {
+        u32 chunk_end = chunk_start;
+        u64 chunk_size = 0;
+
+        // A single lines object bigger than the budget still gets its own chunk
+        while (chunk_end < num_lines) {
+            u64 size = _lines_staging_size(out[chunk_end]);
+            if (chunk_end > chunk_start && chunk_size + size > LOAD_STAGING_SIZE) {
+                break;
+            }
+
+            chunk_size += size;
+            chunk_end++;
+        }
+
+        u32 chunk_len = chunk_end - chunk_start;
+
+        mga_temp temp = mga_temp_begin(staging);
+
+        ctx.chunk_start = chunk_start;
+        ctx.verts = MGA_PUSH_ARRAY(staging, line_vert*, chunk_len);
+        ctx.indices = MGA_PUSH_ARRAY(staging, u32*, chunk_len);
+        ctx.corners = MGA_PUSH_ARRAY(staging, line_corner*, chunk_len);
+        ctx.corner_widths = MGA_PUSH_ZERO_ARRAY(staging, f32*, chunk_len);
+        ctx.lods = MGA_PUSH_ARRAY(staging, _lines_lod_geometry, chunk_len * DRAW_LINES_MAX_LODS);
+        ctx.num_lods = MGA_PUSH_ZERO_ARRAY(staging, u32, chunk_len);
+        ctx.splines = MGA_PUSH_ZERO_ARRAY(staging, draw_spline, chunk_len);
+
+        for (u32 i = 0; i < chunk_len; i++) {
+            draw_lines_backend* backend = out[chunk_start + i]->backend;
+
+            ctx.verts[i] = MGA_PUSH_ARRAY(staging, line_vert, backend->num_verts);
+            ctx.indices[i] = MGA_PUSH_ARRAY(staging, u32, backend->num_indices);
+            ctx.corners[i] = MGA_PUSH_ARRAY(staging, line_corner, backend->num_corners);
+
+            if (out[chunk_start + i]->points.has_widths) {
+                ctx.corner_widths[i] = MGA_PUSH_ARRAY(staging, f32, backend->num_corners);
+            }
+        }
+
+        jobs_parallel_for(jobs, chunk_len, 0, _lines_load_tessellate_range, &ctx);
+
+        u32 num_tessellated = 0;
+        for (u32 i = 0; i < chunk_len; i++) {
+            num_tessellated += ctx.splines[i].num_segments == 0;
+        }
+
+        // Uploading the whole chunk from this thread
+        u32* arrays = MGA_PUSH_ARRAY(staging, u32, num_tessellated * 2);
+        u32* buffers = MGA_PUSH_ARRAY(staging, u32, num_tessellated * 3);
+        glGenVertexArrays(num_tessellated * 2, arrays);
+        glGenBuffers(num_tessellated * 3, buffers);
+
+        u32 num_created = 0;
+        for (u32 i = 0; i < chunk_len; i++) {
+            draw_lines* lines = out[chunk_start + i];
+
+            // Same state as lines that dropped their geometry for the curves,
+            // so the geometry and LODs are only built if the curves go away
+            if (ctx.splines[i].num_segments > 0) {
+                _lines_upload_curves(lines, &ctx.splines[i]);
+
+                lines->backend->curve_tolerance = curve_tolerance;
+                lines->backend->geometry_dropped = true;
+                lines->backend->evicted_lods = !lines->points.has_widths;
+
+                continue;
+            }
+
+            _lines_create_objects(
+                lines, arrays + num_created * 2, buffers + num_created * 3,
+                ctx.verts[i], ctx.indices[i], ctx.corners[i], ctx.corner_widths[i]
+            );
+            num_created++;
+
+            _lines_upload_lods(lines, ctx.lods + i * DRAW_LINES_MAX_LODS, ctx.num_lods[i]);
+        }
+
+        mga_temp_end(temp);
+        for (u32 i = 0; i < num_threads; i++) {
+            mga_reset(thread_arenas[i]);
+        }
+
+        chunk_start = chunk_end;
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    for (u32 i = 0; i < num_threads; i++) {
+        mga_destroy(thread_arenas[i]);
+    }
+    mga_destroy(staging);
+
+    return true;
+}
+
+void draw_lines_build_lods(draw_lines* lines) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot build LODs of NULL lines\n");
+        return;
+    }
+
+    // Simplifying does not keep track of the widths
+    if (lines->points.has_widths) {
+        return;
+    }
+    // Built when the geometry is restored
+    if (lines->backend->evicted || lines->backend->geometry_dropped) {
+        lines->backend->evicted_lods = true;
+        return;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    vec2f* points = MGA_PUSH_ARRAY(scratch.arena, vec2f, lines->points.size);
+
+    if (_lines_gather_points(lines, points)) {
+        _lines_lod_geometry lods[DRAW_LINES_MAX_LODS] = { 0 };
+        u32 num_lods = _lines_compute_lods(scratch.arena, points, lines->points.size, lines->width, lods);
+
+        _lines_upload_lods(lines, lods, num_lods);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    mga_scratch_release(scratch);
+}
+void draw_lines_build_curves(draw_lines* lines, f32 tolerance) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot build curves of NULL lines\n");
+        return;
+    }
+
+    _lines_free_curves(lines);
+
+    // Single points keep their circle
+    if (lines->points.size < 2) {
+        _lines_restore_geometry(lines);
+        return;
+    }
+
+    lines->backend->curve_tolerance = tolerance;
+    if (lines->backend->evicted) {
+        lines->backend->evicted_curves = true;
+        return;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    draw_spline spline = draw_spline_fit(scratch.arena, &lines->points, tolerance);
+    _lines_upload_curves(lines, &spline);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    mga_scratch_release(scratch);
+
+    // Nothing else is drawn while there are curves
+    if (lines->backend->num_curves > 0) {
+        _lines_free_geometry(lines);
+    } else {
+        _lines_restore_geometry(lines);
+    }
+}
+
+b32 draw_lines_refit_curves(draw_lines* lines, const gfx_window* win, viewf view) {
+    if (lines == NULL || win == NULL) {
+        fprintf(stderr, "Cannot refit curves: lines or win is NULL\n");
+        return false;
+    }
+
+    draw_lines_backend* backend = lines->backend;
+
+    // Same scale as draw_lines_draw, the curves are fit to the points before the transform
+    f32 pixels_per_unit = (f32)win->width / view.width;
+    if (lines->has_transform) {
+        pixels_per_unit *= _lines_transform_scale(&lines->transform);
+    }
+
+    if (backend->curve_tolerance * pixels_per_unit <= DRAW_LINES_CURVE_FIT_PIXELS * DRAW_LINES_CURVE_REFIT_RATIO) {
+        return false;
+    }
+
+    // Evicted lines are fit with the new tolerance when they are restored
+    if (backend->evicted) {
+        if (backend->evicted_curves) {
+            backend->curve_tolerance = DRAW_LINES_CURVE_FIT_PIXELS / pixels_per_unit;
+        }
+        return false;
+    }
+    if (backend->num_curves == 0) {
+        return false;
+    }
+
+    draw_lines_build_curves(lines, DRAW_LINES_CURVE_FIT_PIXELS / pixels_per_unit);
+
+    return true;
+}
+
+u64 draw_lines_gpu_size(const draw_lines* lines) {
+    if (lines == NULL || lines->backend->evicted) {
+        return 0;
+    }
+
+    const draw_lines_backend* backend = lines->backend;
+
+    u64 size = sizeof(line_vert) * backend->vert_capacity +
+        sizeof(u32) * backend->index_capacity +
+        sizeof(line_corner) * backend->corner_capacity +
+        sizeof(f32) * backend->corner_width_capacity;
+
+    for (u32 i = 0; i < backend->num_lods; i++) {
+        const _draw_lines_lod* lod = &backend->lods[i];
+
+        size += sizeof(line_vert) * lod->num_verts +
+            sizeof(u32) * lod->num_indices +
+            sizeof(line_corner) * lod->num_corners;
+    }
+
+    size += sizeof(cubic_bezier) * backend->num_curves;
+    if (backend->curve_width_buffer != 0) {
+        size += sizeof(f32) * (backend->num_curves + 1);
+    }
+
+    return size;
+}
+b32 draw_lines_is_evicted(const draw_lines* lines) {
+    return lines != NULL && lines->backend->evicted;
+}
+void draw_lines_evict(draw_lines* lines) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot evict NULL lines\n");
+        return;
+    }
+
+    draw_lines_backend* backend = lines->backend;
+
+    if (backend->evicted) {
+        return;
+    }
+
+    backend->evicted_curves = backend->num_curves > 0;
+
+    _lines_free_curves(lines);
+    _lines_free_geometry(lines);
+
+    backend->evicted = true;
+}
+void draw_lines_restore(draw_lines* lines) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot restore NULL lines\n");
+        return;
+    }
+
+    draw_lines_backend* backend = lines->backend;
+
+    if (!backend->evicted) {
+        return;
+    }
+
+    backend->evicted = false;
+
+    // The curves are fit first, so the geometry is only built if there are none
+    if (backend->evicted_curves) {
+        backend->evicted_curves = false;
+        draw_lines_build_curves(lines, backend->curve_tolerance);
+    }
+
+    _lines_restore_geometry(lines);
+}
+
+static void _lines_alloc_points(draw_lines* lines, u32 num_points) {
+    u32 num_buckets = (num_points + DRAW_POINT_BUCKET_SIZE - 1) / DRAW_POINT_BUCKET_SIZE;
+    for (u32 i = 0; i < num_buckets; i++) {
+        draw_point_bucket* bucket = draw_point_alloc_alloc(lines->allocator);
+
+        u32 size = i == num_buckets - 1 ? 
+            num_points - (DRAW_POINT_BUCKET_SIZE * (num_buckets - 1)) : DRAW_POINT_BUCKET_SIZE;
+
+        bucket->size = size;
+
+        if (lines->points.has_widths) {
+            bucket->widths = draw_point_alloc_alloc_widths(lines->allocator);
+        }
+
+        draw_point_list_push(&lines->points, bucket);
+    }
+}
+
+static void _lines_prepare(draw_lines* lines, const vec2f* points, const f32* widths, u32 num_points) {
+    _lines_compute_bounds(lines, points, num_points);
+
+    u32 bucket_index = 0;
+    for (draw_point_node* node = lines->points.first; node != NULL; node = node->next) {
+        draw_point_bucket* bucket = node->bucket;
+
+        memcpy(bucket->points, points + bucket_index * DRAW_POINT_BUCKET_SIZE, sizeof(vec2f) * bucket->size);
+        draw_point_bucket_update_bounds(bucket);
+
+        if (widths != NULL && bucket->widths != NULL) {
+            memcpy(bucket->widths->widths, widths + bucket_index * DRAW_POINT_BUCKET_SIZE, sizeof(f32) * bucket->size);
+        }
+
+        bucket_index++;
+    }
+
+    _lines_count_geometry(
+        points, num_points,
+        &lines->backend->num_verts, &lines->backend->num_indices, &lines->backend->num_corners
+    );
+
+    _lines_set_last_points(lines, points, widths, num_points);
+}
+
+static void _lines_compute_bounds(draw_lines* lines, const vec2f* points, u32 num_points) {
+    if (num_points == 0) {
+        lines->bounding_box = (rectf){ 0 };
+        return;
+    }
+
+    vec2f min_pos = points[0];
+    vec2f max_pos = points[0];
+
+    for (u32 i = 0; i < num_points; i++) {
+        if (points[i].x > max_pos.x) {
+            max_pos.x = points[i].x;
+        }
+        if (points[i].y > max_pos.y) {
+            max_pos.y = points[i].y;
+        }
+        if (points[i].x < min_pos.x) {
+            min_pos.x = points[i].x;
+        }
+        if (points[i].y < min_pos.y) {
+            min_pos.y = points[i].y;
+        }
+    }
+
+    lines->bounding_box = (rectf){
+        min_pos.x - lines->width,
+        min_pos.y - lines->width,
+        (max_pos.x - min_pos.x) + lines->width * 2.0f,
+        (max_pos.y - min_pos.y) + lines->width * 2.0f
+    };
+}
+
+static void _lines_set_last_points(draw_lines* lines, const vec2f* points, const f32* widths, u32 num_points) {
+    for (u32 i = 0; i < 3; i++) {
+        lines->backend->last_points[i] = (vec2f){ 0 };
+        lines->backend->last_widths[i] = 0.0f;
+    }
+
+    if (num_points == 0) {
+        return;
+    } else if (num_points == 1) {
+        lines->backend->last_points[2] = points[0];
+    } else if (num_points == 2) {
+        lines->backend->last_points[2] = points[1];
+        lines->backend->last_points[1] = points[0];
+    } else {
+        lines->backend->last_points[2] = points[num_points - 1];
+        lines->backend->last_points[1] = points[num_points - 2];
+        lines->backend->last_points[0] = points[num_points - 3];
+    }
+
+    if (widths != NULL) {
+        for (u32 i = 0; i < 3 && i < num_points; i++) {
+            lines->backend->last_widths[2 - i] = widths[num_points - 1 - i];
+        }
+    }
+}
+
+static void _lines_count_geometry(const vec2f* points, u32 num_points, u32* num_verts, u32* num_indices, u32* num_corners) {
+    *num_indices = (num_points - 1) * 6;
+
+    if (num_points == 1) {
+        // Two corners will make a circle
+        *num_corners = 2;
+        *num_verts = 0;
+
+        return;
+    }
+
+    // At least two for end caps
+    *num_corners = 2;
+    // At least two for first segment
+    *num_verts = 2;
+
+    for (u32 i = 1; i < num_points - 1; i++) {
+        vec2f p0 = points[i - 1];
+        vec2f p1 = points[i];
+        vec2f p2 = points[i + 1];
+
+        if (_is_corner(p0, p1, p2)) {
+            (*num_corners)++;
+            *num_verts += 4;
+        } else {
+            *num_verts += 2;
+        }
+    }
+
+    // End of last line segment
+    *num_verts += 2;
+}
+
+static void _lines_build_indices(const vec2f* points, u32 num_points, u32* indices) {
+    if (num_points < 2) {
+        return;
+    }
+
+    u32 num_indices = 0;
+    u32 num_verts = 2;
+
+    for (u32 i = 1; i < num_points - 1; i++) {
+        vec2f p0 = points[i - 1];
+        vec2f p1 = points[i];
+        vec2f p2 = points[i + 1];
+
+        if (_is_corner(p0, p1, p2)) {
+            num_verts += 4;
+
+            indices[num_indices++] = num_verts - 6;
+            indices[num_indices++] = num_verts - 5;
+            indices[num_indices++] = num_verts - 4;
+
+            indices[num_indices++] = num_verts - 5;
+            indices[num_indices++] = num_verts - 3;
+            indices[num_indices++] = num_verts - 4;
+        } else {
+            num_verts += 2;
+
+            indices[num_indices++] = num_verts - 4;
+            indices[num_indices++] = num_verts - 3;
+            indices[num_indices++] = num_verts - 2;
+
+            indices[num_indices++] = num_verts - 3;
+            indices[num_indices++] = num_verts - 1;
+            indices[num_indices++] = num_verts - 2;
+        }
+    }
+
+    num_verts += 2;
+
+    indices[num_indices++] = num_verts - 4;
+    indices[num_indices++] = num_verts - 3;
+    indices[num_indices++] = num_verts - 2;
+
+    indices[num_indices++] = num_verts - 3;
+    indices[num_indices++] = num_verts - 1;
+    indices[num_indices++] = num_verts - 2;
+}
+
+static void _lines_create_objects(draw_lines* lines, u32 arrays[2], u32 buffers[3], const line_vert* verts, const u32* indices, const line_corner* corners, const f32* corner_widths) {
+    draw_lines_backend* backend = lines->backend;
+
+    backend->vert_capacity = backend->num_verts;
+    backend->index_capacity = backend->num_indices;
+    backend->corner_capacity = backend->num_corners;
+
+    backend->segment_array = arrays[0];
+    backend->corner_array = arrays[1];
+
+    backend->vert_buffer = buffers[0];
+    backend->index_buffer = buffers[1];
+    backend->corner_buffer = buffers[2];
+
+    glBindVertexArray(backend->segment_array);
+
+    glBindBuffer(GL_ARRAY_BUFFER, backend->vert_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(line_vert) * backend->num_verts, verts, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, backend->index_buffer);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(u32) * backend->num_indices, indices, GL_STATIC_DRAW);
+
+    glBindVertexArray(backend->corner_array);
+
+    glBindBuffer(GL_ARRAY_BUFFER, backend->corner_buffer);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(line_corner) * backend->num_corners, corners, GL_DYNAMIC_DRAW);
+
+    if (lines->points.has_widths) {
+        backend->corner_width_capacity = backend->num_corners;
+
+        glGenBuffers(1, &backend->corner_width_buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, backend->corner_width_buffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(f32) * backend->num_corners, corner_widths, GL_DYNAMIC_DRAW);
+    }
+}
+
+static b32 _lines_gather_points(const draw_lines* lines, vec2f* out) {
+    u32 num_points = 0;
+
+    for (const draw_point_node* node = lines->points.first; node != NULL; node = node->next) {
+        const draw_point_bucket* bucket = node->bucket;
+
+        if (num_points + bucket->size > lines->points.size) {
+            break;
+        }
+
+        memcpy(out + num_points, bucket->points, sizeof(vec2f) * bucket->size);
+        num_points += bucket->size;
+    }
+
+    if (num_points != lines->points.size) {
+        fprintf(stderr, "Cannot gather lines points, buckets do not match the size\n");
+        return false;
+    }
+
+    return true;
+}
+
+static void _lines_gather_widths(const draw_lines* lines, f32* out) {
+    u32 num_points = 0;
+
+    for (const draw_point_node* node = lines->points.first; node != NULL; node = node->next) {
+        const draw_point_bucket* bucket = node->bucket;
+
+        if (num_points + bucket->size > lines->points.size || bucket->widths == NULL) {
+            break;
+        }
+
+        memcpy(out + num_points, bucket->widths->widths, sizeof(f32) * bucket->size);
+        num_points += bucket->size;
+    }
+}
+
+static u32 _lines_compute_lods(mg_arena* arena, const vec2f* points, u32 num_points, f32 width, _lines_lod_geometry* lods) {
+    if (num_points <= 2) {
+        return 0;
+    }
+
+    vec2f* simplified = MGA_PUSH_ARRAY(arena, vec2f, num_points);
+
+    u32 prev_num_points = num_points;
+    u32 num_lods = 0;
 
-    for (u32 i = 0; i < num_points; i++) {
-        if (points[i].x > max_pos.x) {
-            max_pos.x = points[i].x;
-        }
-        if (points[i].y > max_pos.y) {
-            max_pos.y = points[i].y;
-        }
-        if (points[i].x < min_pos.x) {
-            min_pos.x = points[i].x;
+    // Every level is simplified from the full points, so the error never adds up between levels
+    f32 tolerance = width * DRAW_LINES_LOD_BASE_TOLERANCE;
+    for (u32 i = 0; i < DRAW_LINES_MAX_LODS; i++, tolerance *= DRAW_LINES_LOD_STEP) {
+        u32 num_simplified = draw_simplify_rdp(points, num_points, tolerance, simplified);
+
+        if ((f32)num_simplified > (f32)prev_num_points * DRAW_LINES_LOD_MIN_REDUCTION) {
+            continue;
         }
-        if (points[i].y < min_pos.y) {
-            min_pos.y = points[i].y;
+
+        _lines_lod_geometry* lod = &lods[num_lods++];
+        lod->tolerance = tolerance;
+
+        _lines_count_geometry(simplified, num_simplified, &lod->num_verts, &lod->num_indices, &lod->num_corners);
+
+        lod->verts = MGA_PUSH_ARRAY(arena, line_vert, lod->num_verts);
+        lod->indices = MGA_PUSH_ARRAY(arena, u32, lod->num_indices);
+        lod->corners = MGA_PUSH_ARRAY(arena, line_corner, lod->num_corners);
+
+        _lines_build_indices(simplified, num_simplified, lod->indices);
+        _lines_tessellate(simplified, NULL, num_simplified, width, lod->verts, lod->corners, NULL);
+
+        prev_num_points = num_simplified;
+
+        // Nothing is left to remove
+        if (num_simplified <= 2) {
+            break;
         }
     }
 
-    lines->bounding_box = (rectf){
-        min_pos.x - lines->width,
-        min_pos.y - lines->width,
-        (max_pos.x - min_pos.x) + lines->width * 2.0f,
-        (max_pos.y - min_pos.y) + lines->width * 2.0f
-    };
+    return num_lods;
+}
 
-    lines->color = col;
-    lines->width = line_width;
+static void _lines_upload_lods(draw_lines* lines, const _lines_lod_geometry* lods, u32 num_lods) {
+    _lines_free_lods(lines);
 
-    lines->allocator = allocator;
+    for (u32 i = 0; i < num_lods; i++) {
+        _draw_lines_lod* lod = &lines->backend->lods[i];
 
-    lines->points.size = num_points;
-    u32 num_buckets = (num_points + DRAW_POINT_BUCKET_SIZE - 1) / DRAW_POINT_BUCKET_SIZE;
-    for (u32 i = 0; i < num_buckets; i++) {
-        draw_point_bucket* bucket = draw_point_alloc_alloc(allocator);
+        lod->tolerance = lods[i].tolerance;
+        lod->num_verts = lods[i].num_verts;
+        lod->num_indices = lods[i].num_indices;
+        lod->num_corners = lods[i].num_corners;
 
-        u32 size = i == num_buckets - 1 ? 
-            num_points - (DRAW_POINT_BUCKET_SIZE * (num_buckets - 1)) : DRAW_POINT_BUCKET_SIZE;
+        glGenVertexArrays(1, &lod->segment_array);
+        glGenVertexArrays(1, &lod->corner_array);
 
-        bucket->size = size;
-        memcpy(bucket->points, points + i * DRAW_POINT_BUCKET_SIZE, sizeof(vec2f) * size);
+        glBindVertexArray(lod->segment_array);
+        lod->vert_buffer = glh_create_buffer(
+            GL_ARRAY_BUFFER, sizeof(line_vert) * lods[i].num_verts, lods[i].verts, GL_STATIC_DRAW
+        );
+        lod->index_buffer = glh_create_buffer(
+            GL_ELEMENT_ARRAY_BUFFER, sizeof(u32) * lods[i].num_indices, lods[i].indices, GL_STATIC_DRAW
+        );
 
-        SLL_PUSH_BACK(lines->points.first, lines->points.last, bucket);
+        glBindVertexArray(lod->corner_array);
+        lod->corner_buffer = glh_create_buffer(
+            GL_ARRAY_BUFFER, sizeof(line_corner) * lods[i].num_corners, lods[i].corners, GL_STATIC_DRAW
+        );
     }
 
-    lines->backend->num_indices = (num_points - 1) * 6;
-    if (num_points == 1) {
-        // Two corners will make a circle
-        lines->backend->num_corners = 2;
+    lines->backend->num_lods = num_lods;
+}
 
-        lines->backend->last_points[2] = points[0];
-    } else {
-        // At least two for end caps
-        lines->backend->num_corners = 2;
-        // At least two for first segment
-        lines->backend->num_verts = 2;
+static void _lines_free_lods(draw_lines* lines) {
+    for (u32 i = 0; i < lines->backend->num_lods; i++) {
+        _draw_lines_lod* lod = &lines->backend->lods[i];
 
-        for (u32 i = 1; i < num_points - 1; i++) {
-            vec2f p0 = points[i - 1];
-            vec2f p1 = points[i];
-            vec2f p2 = points[i + 1];
+        glDeleteVertexArrays(1, &lod->segment_array);
+        glDeleteVertexArrays(1, &lod->corner_array);
 
-            if (_is_corner(p0, p1, p2)) {
-                lines->backend->num_corners++;
-                lines->backend->num_verts += 4;
-            } else {
-                lines->backend->num_verts += 2;
-            }
-        }
+        glDeleteBuffers(1, &lod->vert_buffer);
+        glDeleteBuffers(1, &lod->index_buffer);
+        glDeleteBuffers(1, &lod->corner_buffer);
+    }
 
-        // End of last line segment
-        lines->backend->num_verts += 2;
+    lines->backend->num_lods = 0;
+}
 
-        if (num_points == 2) {
-            lines->backend->last_points[2] = points[1];
-            lines->backend->last_points[1] = points[0];
-        } else {
-            lines->backend->last_points[2] = points[num_points - 1];
-            lines->backend->last_points[1] = points[num_points - 2];
-            lines->backend->last_points[0] = points[num_points - 3];
-        }
+static void _lines_upload_curves(draw_lines* lines, const draw_spline* spline) {
+    if (spline->num_segments == 0) {
+        return;
     }
 
-    // Indices do not change here, so they can be computed beforehand
-    mga_temp scratch = mga_scratch_get(NULL, 0);
-    u32* indices = MGA_PUSH_ZERO_ARRAY(scratch.arena, u32, lines->backend->num_indices);
+    draw_lines_backend* backend = lines->backend;
 
-    if (num_points > 1) {
-        u32 num_indices = 0;
-        u32 num_verts = 2;
+    backend->num_curves = spline->num_segments;
 
-        for (u32 i = 1; i < num_points - 1; i++) {
-            vec2f p0 = points[i - 1];
-            vec2f p1 = points[i];
-            vec2f p2 = points[i + 1];
+    glGenVertexArrays(1, &backend->curve_array);
+    glBindVertexArray(backend->curve_array);
+    backend->curve_buffer = glh_create_buffer(
+        GL_ARRAY_BUFFER, sizeof(cubic_bezier) * spline->num_segments, spline->segments, GL_STATIC_DRAW
+    );
 
-            if (_is_corner(p0, p1, p2)) {
-                num_verts += 4;
+    if (spline->widths != NULL) {
+        backend->curve_width_buffer = glh_create_buffer(
+            GL_ARRAY_BUFFER, sizeof(f32) * (spline->num_segments + 1), spline->widths, GL_STATIC_DRAW
+        );
+    }
+}
+static void _lines_free_curves(draw_lines* lines) {
+    if (lines->backend->num_curves == 0) {
+        return;
+    }
 
-                indices[num_indices++] = num_verts - 6;
-                indices[num_indices++] = num_verts - 5;
-                indices[num_indices++] = num_verts - 4;
+    glDeleteVertexArrays(1, &lines->backend->curve_array);
+    glDeleteBuffers(1, &lines->backend->curve_buffer);
 
-                indices[num_indices++] = num_verts - 5;
-                indices[num_indices++] = num_verts - 3;
-                indices[num_indices++] = num_verts - 4;
-            } else {
-                num_verts += 2;
+    if (lines->backend->curve_width_buffer != 0) {
+        glDeleteBuffers(1, &lines->backend->curve_width_buffer);
+        lines->backend->curve_width_buffer = 0;
+    }
 
-                indices[num_indices++] = num_verts - 4;
-                indices[num_indices++] = num_verts - 3;
-                indices[num_indices++] = num_verts - 2;
+    lines->backend->num_curves = 0;
+}
 
-                indices[num_indices++] = num_verts - 3;
-                indices[num_indices++] = num_verts - 1;
-                indices[num_indices++] = num_verts - 2;
-            }
-        }
+static void _lines_free_geometry(draw_lines* lines) {
+    draw_lines_backend* backend = lines->backend;
 
-        num_verts += 2;
+    if (backend->geometry_dropped) {
+        return;
+    }
 
-        indices[num_indices++] = num_verts - 4;
-        indices[num_indices++] = num_verts - 3;
-        indices[num_indices++] = num_verts - 2;
+    backend->evicted_lods = backend->num_lods > 0;
+    _lines_free_lods(lines);
 
-        indices[num_indices++] = num_verts - 3;
-        indices[num_indices++] = num_verts - 1;
-        indices[num_indices++] = num_verts - 2;
-    }
+    glDeleteVertexArrays(1, &backend->segment_array);
+    glDeleteVertexArrays(1, &backend->corner_array);
 
-    lines->backend->vert_capacity = lines->backend->num_verts;
-    lines->backend->index_capacity = lines->backend->num_indices;
-    lines->backend->corner_capacity = lines->backend->num_corners;
+    glDeleteBuffers(1, &backend->vert_buffer);
+    glDeleteBuffers(1, &backend->index_buffer);
+    glDeleteBuffers(1, &backend->corner_buffer);
 
-    // OpenGL stuff
-    glGenVertexArrays(1, &lines->backend->segment_array);
-    glBindVertexArray(lines->backend->segment_array);
+    if (backend->corner_width_buffer != 0) {
+        glDeleteBuffers(1, &backend->corner_width_buffer);
+    }
 
-    lines->backend->vert_buffer = glh_create_buffer(GL_ARRAY_BUFFER, sizeof(line_vert) * lines->backend->num_verts, NULL, GL_DYNAMIC_DRAW);
-    lines->backend->index_buffer = glh_create_buffer(GL_ELEMENT_ARRAY_BUFFER, sizeof(u32) * lines->backend->num_indices, indices, GL_STATIC_DRAW);
+    backend->segment_array = 0;
+    backend->corner_array = 0;
+    backend->vert_buffer = 0;
+    backend->index_buffer = 0;
+    backend->corner_buffer = 0;
+    backend->corner_width_buffer = 0;
 
-    mga_scratch_release(scratch);
+    backend->vert_capacity = 0;
+    backend->index_capacity = 0;
+    backend->corner_capacity = 0;
+    backend->corner_width_capacity = 0;
 
-    glGenVertexArrays(1, &lines->backend->corner_array);
-    glBindVertexArray(lines->backend->corner_array);
+    backend->geometry_dropped = true;
+}
+static void _lines_restore_geometry(draw_lines* lines) {
+    draw_lines_backend* backend = lines->backend;
 
-    lines->backend->corner_buffer = glh_create_buffer(GL_ARRAY_BUFFER, sizeof(line_corner) * lines->backend->num_corners, NULL, GL_DYNAMIC_DRAW);
+    if (!backend->geometry_dropped || backend->evicted || backend->num_curves > 0) {
+        return;
+    }
 
-    // Computing the initial geometry
-    draw_lines_update(lines, col, line_width);
+    // Creates the buffers before tessellating
+    _lines_rebuild_geometry(lines);
 
-    return lines;
+    if (backend->evicted_lods) {
+        backend->evicted_lods = false;
+        draw_lines_build_lods(lines);
+    }
 }
+static void _lines_begin_edit(draw_lines* lines) {
+    // The simplified levels and curves no longer match the points
+    _lines_free_lods(lines);
+    _lines_free_curves(lines);
+    lines->backend->evicted_lods = false;
+    lines->backend->evicted_curves = false;
+
+    draw_lines_restore(lines);
+    _lines_restore_geometry(lines);
+}
+
 draw_lines* draw_lines_create(mg_arena* arena, draw_point_allocator* allocator, vec4f col, f32 line_width) {
     draw_lines* lines = MGA_PUSH_ZERO_STRUCT(arena, draw_lines);
 
@@ -288,29 +1171,34 @@ draw_lines* draw_lines_create(mg_arena* arena, draw_point_allocator* allocator,
 
     lines->backend = MGA_PUSH_ZERO_STRUCT(arena, draw_lines_backend);
 
-    lines->backend->vert_capacity = DRAW_POINT_BUCKET_SIZE * 2;
-    lines->backend->index_capacity = (DRAW_POINT_BUCKET_SIZE - 1) * 6;
-    // TODO: is there a better starting value?
-    // how often are corners?
-    lines->backend->corner_capacity = 8;
+    _lines_create_buffers(lines, LINES_START_VERTS, LINES_START_INDICES, LINES_START_CORNERS);
 
-    glGenVertexArrays(1, &lines->backend->segment_array);
-    glGenVertexArrays(1, &lines->backend->corner_array);
+    return lines;
+}
+
+// Creates the vertex arrays and empty buffers with the given capacities
+static void _lines_create_buffers(draw_lines* lines, u32 vert_capacity, u32 index_capacity, u32 corner_capacity) {
+    draw_lines_backend* backend = lines->backend;
+
+    backend->vert_capacity = vert_capacity;
+    backend->index_capacity = index_capacity;
+    backend->corner_capacity = corner_capacity;
 
-    glBindVertexArray(lines->backend->segment_array);
-    lines->backend->vert_buffer = glh_create_buffer(
-        GL_ARRAY_BUFFER, sizeof(line_vert) * lines->backend->vert_capacity, NULL, GL_DYNAMIC_DRAW
+    glGenVertexArrays(1, &backend->segment_array);
+    glGenVertexArrays(1, &backend->corner_array);
+
+    glBindVertexArray(backend->segment_array);
+    backend->vert_buffer = glh_create_buffer(
+        GL_ARRAY_BUFFER, sizeof(line_vert) * backend->vert_capacity, NULL, GL_DYNAMIC_DRAW
     );
-    lines->backend->index_buffer = glh_create_buffer(
-        GL_ELEMENT_ARRAY_BUFFER, sizeof(u32) * lines->backend->index_capacity, NULL, GL_DYNAMIC_DRAW
+    backend->index_buffer = glh_create_buffer(
+        GL_ELEMENT_ARRAY_BUFFER, sizeof(u32) * backend->index_capacity, NULL, GL_DYNAMIC_DRAW
     );
 
-    glBindVertexArray(lines->backend->corner_array);
-    lines->backend->corner_buffer = glh_create_buffer(
-        GL_ARRAY_BUFFER, sizeof(line_corner) * lines->backend->corner_capacity, NULL, GL_DYNAMIC_DRAW
+    glBindVertexArray(backend->corner_array);
+    backend->corner_buffer = glh_create_buffer(
+        GL_ARRAY_BUFFER, sizeof(line_corner) * backend->corner_capacity, NULL, GL_DYNAMIC_DRAW
     );
-
-    return lines;
 }
 void draw_lines_destroy(draw_lines* lines) {
     if (lines == NULL) {
@@ -318,14 +1206,22 @@ void draw_lines_destroy(draw_lines* lines) {
         return;
     }
 
+    _lines_unshare(lines, false);
     draw_point_list_clear(&lines->points);
 
+    _lines_free_lods(lines);
+    _lines_free_curves(lines);
+
     glDeleteVertexArrays(1, &lines->backend->segment_array);
     glDeleteVertexArrays(1, &lines->backend->corner_array);
 
     glDeleteBuffers(1, &lines->backend->vert_buffer);
     glDeleteBuffers(1, &lines->backend->index_buffer);
     glDeleteBuffers(1, &lines->backend->corner_buffer);
+
+    if (lines->backend->corner_width_buffer != 0) {
+        glDeleteBuffers(1, &lines->backend->corner_width_buffer);
+    }
 }
 
 void draw_lines_clear(draw_lines* lines) {
@@ -334,9 +1230,18 @@ void draw_lines_clear(draw_lines* lines) {
         return;
     }
 
+    _lines_unshare(lines, false);
     draw_point_list_clear(&lines->points);
 
+    _lines_free_lods(lines);
+    _lines_free_curves(lines);
+
+    lines->id = 0;
     lines->bounding_box = (rectf){ 0 };
+    lines->has_transform = false;
+
+    lines->backend->evicted_lods = false;
+    lines->backend->evicted_curves = false;
 
     lines->backend->num_verts = 0;
     lines->backend->num_indices = 0;
@@ -345,6 +1250,10 @@ void draw_lines_clear(draw_lines* lines) {
     lines->backend->last_points[0] = (vec2f){ 0 };
     lines->backend->last_points[1] = (vec2f){ 0 };
     lines->backend->last_points[2] = (vec2f){ 0 };
+
+    lines->backend->last_widths[0] = 0.0f;
+    lines->backend->last_widths[1] = 0.0f;
+    lines->backend->last_widths[2] = 0.0f;
 }
 void draw_lines_reinit(draw_lines* lines, vec4f col, f32 width) {
     if (lines == NULL) {
@@ -355,33 +1264,223 @@ void draw_lines_reinit(draw_lines* lines, vec4f col, f32 width) {
     lines->color = col;
     lines->width = width;
 }
+void draw_lines_use_point_widths(draw_lines* lines, b32 enabled) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot change point widths of NULL lines\n");
+        return;
+    }
+    if (lines->points.size != 0) {
+        fprintf(stderr, "Cannot change point widths of lines that have points\n");
+        return;
+    }
+
+    lines->points.has_widths = enabled;
+
+    // Lines without geometry get the buffer when it is restored
+    if (enabled && !lines->backend->geometry_dropped && lines->backend->corner_width_buffer == 0) {
+        lines->backend->corner_width_capacity = lines->backend->corner_capacity;
+        lines->backend->corner_width_buffer = glh_create_buffer(
+            GL_ARRAY_BUFFER, sizeof(f32) * lines->backend->corner_width_capacity, NULL, GL_DYNAMIC_DRAW
+        );
+    }
+}
+
+void draw_lines_copy(draw_lines* lines, const draw_lines* src) {
+    if (lines == NULL || src == NULL) {
+        fprintf(stderr, "Cannot copy lines: lines or src is NULL\n");
+        return;
+    }
+
+    draw_lines_clear(lines);
+    draw_lines_reinit(lines, src->color, src->width);
+    draw_lines_use_point_widths(lines, src->points.has_widths);
+
+    draw_point_list_share(&lines->points, &src->points);
+
+    _lines_rebuild_geometry(lines);
+}
+void draw_lines_take(draw_lines* lines, draw_lines* src) {
+    if (lines == NULL || src == NULL) {
+        fprintf(stderr, "Cannot take lines: lines or src is NULL\n");
+        return;
+    }
+    if (lines->allocator != src->allocator) {
+        fprintf(stderr, "Cannot take lines with a different point allocator\n");
+        return;
+    }
+
+    draw_lines_clear(lines);
+    draw_lines_reinit(lines, src->color, src->width);
+
+    lines->points.has_widths = src->points.has_widths;
+    draw_point_list_share(&lines->points, &src->points);
+
+    lines->bounding_box = src->bounding_box;
+    lines->has_transform = src->has_transform;
+    lines->transform = src->transform;
+    lines->last_seen_frame = src->last_seen_frame;
+
+    // The geometry matches the points of both, so the backends trade places
+    draw_lines_backend* backend = lines->backend;
+    lines->backend = src->backend;
+    src->backend = backend;
+
+    // The sizes, last points and buffers are rebuilt from the points when src is restored
+    draw_lines_evict(src);
+
+    backend->evicted_lods = lines->backend->num_lods > 0 || lines->backend->evicted_lods;
+    backend->evicted_curves = lines->backend->num_curves > 0 || lines->backend->evicted_curves;
+    backend->curve_tolerance = lines->backend->curve_tolerance;
+}
+
+// Called before the points of lines change
+// A snapshot that shares the list keeps its nodes, and the lines continue with nodes of their own
+// if keep_points is set. The buckets stay shared until one of them changes them
+static void _lines_unshare(draw_lines* lines, b32 keep_points) {
+    if (lines->snapshot == NULL) {
+        return;
+    }
+
+    draw_point_list shared = lines->points;
+
+    lines->snapshot->lines = NULL;
+    lines->snapshot = NULL;
+
+    lines->points = (draw_point_list){
+        .has_widths = shared.has_widths,
+        .allocator = shared.allocator
+    };
+
+    if (keep_points) {
+        draw_point_list_share(&lines->points, &shared);
+    }
+}
+
+// How much the transform scales lengths by, exact for transforms without skew
+static f32 _lines_transform_scale(const mat3f* transform) {
+    const f32* m = transform->m;
+
+    return sqrtf(fabsf(m[0] * m[4] - m[1] * m[3]));
+}
+
+void draw_lines_set_transform(draw_lines* lines, const mat3f* transform) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot set transform of NULL lines\n");
+        return;
+    }
+
+    lines->has_transform = transform != NULL;
+    if (transform != NULL) {
+        lines->transform = *transform;
+    }
+}
+void draw_lines_apply_transform(draw_lines* lines) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot apply transform of NULL lines\n");
+        return;
+    }
+    if (!lines->has_transform) {
+        return;
+    }
+
+    _lines_unshare(lines, true);
+
+    lines->has_transform = false;
+
+    f32 scale = _lines_transform_scale(&lines->transform);
+
+    for (draw_point_node* node = lines->points.first; node != NULL; node = node->next) {
+        draw_point_bucket* bucket = draw_point_list_own(&lines->points, node);
+
+        for (u32 i = 0; i < bucket->size; i++) {
+            bucket->points[i] = mat3f_mul_vec2f(&lines->transform, bucket->points[i]);
+        }
+        draw_point_bucket_update_bounds(bucket);
+
+        if (bucket->widths != NULL) {
+            for (u32 i = 0; i < bucket->size; i++) {
+                bucket->widths->widths[i] *= scale;
+            }
+        }
+    }
+
+    lines->width *= scale;
+
+    // These were built from the old points
+    _lines_free_lods(lines);
+    _lines_free_curves(lines);
+    lines->backend->evicted_lods = false;
+    lines->backend->evicted_curves = false;
+
+    _lines_rebuild_geometry(lines);
+}
 
 void draw_lines_draw(const draw_lines* lines, const draw_lines_shaders* shaders, const gfx_window* win, viewf view) {
     if (lines == NULL) {
         fprintf(stderr, "Cannot draw lines: lines is NULL\n");
         return;
     }
-    if (lines->points.size == 0) {
+    // Evicted lines have nothing to draw until draw_lines_restore
+    if (lines->points.size == 0 || lines->backend->evicted) {
         return;
     }
 
     mat3f view_mat = { 0 };
     mat3f_from_view(&view_mat, view);
 
+    f32 pixels_per_unit = (f32)win->width / view.width;
+
+    if (lines->has_transform) {
+        mat3f world_mat = view_mat;
+        mat3f_mul(&view_mat, &world_mat, &lines->transform);
+
+        pixels_per_unit *= _lines_transform_scale(&lines->transform);
+    }
+
+    if (lines->backend->num_curves > 0) {
+        _lines_draw_curves(lines, shaders, &view_mat, pixels_per_unit);
+        return;
+    }
+
+    u32 segment_array = lines->backend->segment_array;
+    u32 corner_array = lines->backend->corner_array;
+    u32 vert_buffer = lines->backend->vert_buffer;
+    u32 index_buffer = lines->backend->index_buffer;
+    u32 corner_buffer = lines->backend->corner_buffer;
+    u32 num_indices = lines->backend->num_indices;
+    u32 num_corners = lines->backend->num_corners;
+
+    // Most simplified level whose error stays under the pixel tolerance
+    for (u32 i = lines->backend->num_lods; i > 0; i--) {
+        const _draw_lines_lod* lod = &lines->backend->lods[i - 1];
+
+        if (lod->tolerance * pixels_per_unit <= DRAW_LINES_LOD_PIXEL_TOLERANCE) {
+            segment_array = lod->segment_array;
+            corner_array = lod->corner_array;
+            vert_buffer = lod->vert_buffer;
+            index_buffer = lod->index_buffer;
+            corner_buffer = lod->corner_buffer;
+            num_indices = lod->num_indices;
+            num_corners = lod->num_corners;
+
+            break;
+        }
+    }
+
     // Drawing line segments
     glUseProgram(shaders->line_program);
     glUniformMatrix3fv(shaders->line_view_mat_loc, 1, GL_FALSE, view_mat.m);
     glUniform4f(shaders->line_col_loc, lines->color.x, lines->color.y, lines->color.z, lines->color.w);
 
-    glBindVertexArray(lines->backend->segment_array);
-    glBindBuffer(GL_ARRAY_BUFFER, lines->backend->vert_buffer);
+    glBindVertexArray(segment_array);
+    glBindBuffer(GL_ARRAY_BUFFER, vert_buffer);
 
     glEnableVertexAttribArray(0);
 
     glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(line_vert), (void*)(offsetof(line_vert, pos)));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, lines->backend->index_buffer);
-    glDrawElements(GL_TRIANGLES, lines->backend->num_indices, GL_UNSIGNED_INT, NULL);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
+    glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_INT, NULL);
 
     glDisableVertexAttribArray(0);
 
@@ -391,10 +1490,21 @@ void draw_lines_draw(const draw_lines* lines, const draw_lines_shaders* shaders,
     glUniform4f(shaders->corner_col_loc, lines->color.x, lines->color.y, lines->color.z, lines->color.w);
     //glUniform4f(shaders->corner_col_loc, 1, 0, 0, 1);
     glUniform2f(shaders->corner_screen_loc, win->width, win->height);
-    glUniform1f(shaders->corner_line_width_loc, lines->width);
 
-    glBindVertexArray(lines->backend->corner_array);
-    glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_buffer);
+    glBindVertexArray(corner_array);
+
+    if (lines->points.has_widths) {
+        glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_width_buffer);
+
+        glEnableVertexAttribArray(3);
+        glVertexAttribDivisor(3, 1);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(f32), NULL);
+    } else {
+        // Every corner has the same width
+        glVertexAttrib1f(3, lines->width);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, corner_buffer);
 
     glEnableVertexAttribArray(0);
     glEnableVertexAttribArray(1);
@@ -408,7 +1518,7 @@ void draw_lines_draw(const draw_lines* lines, const draw_lines_shaders* shaders,
     glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(line_corner), (void*)offsetof(line_corner, p1));
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(line_corner), (void*)offsetof(line_corner, p2));
 
-    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 5, lines->backend->num_corners);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 5, num_corners);
 
     glVertexAttribDivisor(0, 0);
     glVertexAttribDivisor(1, 0);
@@ -418,40 +1528,182 @@ void draw_lines_draw(const draw_lines* lines, const draw_lines_shaders* shaders,
     glDisableVertexAttribArray(1);
     glDisableVertexAttribArray(2);
 
+    if (lines->points.has_widths) {
+        glVertexAttribDivisor(3, 0);
+        glDisableVertexAttribArray(3);
+    }
+
+    glUseProgram(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+static void _lines_draw_curves(const draw_lines* lines, const draw_lines_shaders* shaders, const mat3f* view_mat, f32 pixels_per_unit) {
+    glBindVertexArray(lines->backend->curve_array);
+    glBindBuffer(GL_ARRAY_BUFFER, lines->backend->curve_buffer);
+
+    // Every instance is one segment, both programs read the same coefficients
+    for (u32 i = 0; i < 4; i++) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(cubic_bezier), (void*)offsetof(cubic_bezier, a));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(cubic_bezier), (void*)offsetof(cubic_bezier, b));
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(cubic_bezier), (void*)offsetof(cubic_bezier, c));
+    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(cubic_bezier), (void*)offsetof(cubic_bezier, d));
+
+    // Widths at the start and end of every segment, the end of one segment is the start of the next
+    if (lines->backend->curve_width_buffer != 0) {
+        glBindBuffer(GL_ARRAY_BUFFER, lines->backend->curve_width_buffer);
+
+        for (u32 i = 4; i < 6; i++) {
+            glEnableVertexAttribArray(i);
+            glVertexAttribDivisor(i, 1);
+        }
+
+        glVertexAttribPointer(4, 1, GL_FLOAT, GL_FALSE, sizeof(f32), NULL);
+        glVertexAttribPointer(5, 1, GL_FLOAT, GL_FALSE, sizeof(f32), (void*)sizeof(f32));
+    } else {
+        // Every segment has the same width
+        glVertexAttrib1f(4, lines->width);
+        glVertexAttrib1f(5, lines->width);
+    }
+
+    // Drawing segments
+    glUseProgram(shaders->curve_program);
+    glUniformMatrix3fv(shaders->curve_view_mat_loc, 1, GL_FALSE, view_mat->m);
+    glUniform1f(shaders->curve_pixels_per_unit_loc, pixels_per_unit);
+    glUniform1f(shaders->curve_tolerance_loc, DRAW_LINES_CURVE_PIXEL_TOLERANCE);
+    glUniform4f(shaders->curve_col_loc, lines->color.x, lines->color.y, lines->color.z, lines->color.w);
+
+    // Two vertices per piece boundary, the shader collapses the ones a segment does not need
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, (DRAW_LINES_CURVE_MAX_PIECES + 1) * 2, lines->backend->num_curves);
+
+    // Drawing round joints and caps at both ends of every segment
+    glUseProgram(shaders->joint_program);
+    glUniformMatrix3fv(shaders->joint_view_mat_loc, 1, GL_FALSE, view_mat->m);
+    glUniform4f(shaders->joint_col_loc, lines->color.x, lines->color.y, lines->color.z, lines->color.w);
+
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 12, lines->backend->num_curves);
+
+    u32 num_attribs = lines->backend->curve_width_buffer != 0 ? 6 : 4;
+    for (u32 i = 0; i < num_attribs; i++) {
+        glVertexAttribDivisor(i, 0);
+        glDisableVertexAttribArray(i);
+    }
+
     glUseProgram(0);
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
+
 void draw_lines_update(draw_lines* lines, vec4f col, f32 line_width) {
     if (lines == NULL || lines->points.size == 0) {
         fprintf(stderr, "Cannot update lines: invalid lines object\n");
         return;
     }
 
+    // Point widths keep their size relative to the largest width
+    if (lines->points.has_widths && lines->width > 0.0f) {
+        _lines_unshare(lines, true);
+
+        f32 scale = line_width / lines->width;
+
+        for (draw_point_node* node = lines->points.first; node != NULL; node = node->next) {
+            draw_point_bucket* bucket = draw_point_list_own(&lines->points, node);
+
+            for (u32 i = 0; i < bucket->size; i++) {
+                bucket->widths->widths[i] *= scale;
+            }
+        }
+        for (u32 i = 0; i < 3; i++) {
+            lines->backend->last_widths[i] *= scale;
+        }
+    }
+
     lines->color = col;
     lines->width = line_width;
 
+    // The curves keep their own copy of the point widths
+    if (lines->points.has_widths && lines->backend->num_curves > 0) {
+        draw_lines_build_curves(lines, lines->backend->curve_tolerance);
+    }
+
+    // Tessellated with the new width when the geometry is restored
+    if (lines->backend->geometry_dropped) {
+        return;
+    }
+
     mga_temp scratch = mga_scratch_get(NULL, 0);
 
+    vec2f* points = MGA_PUSH_ARRAY(scratch.arena, vec2f, lines->points.size);
     line_vert* verts = MGA_PUSH_ZERO_ARRAY(scratch.arena, line_vert, lines->backend->num_verts);
     line_corner* corners = MGA_PUSH_ZERO_ARRAY(scratch.arena, line_corner, lines->backend->num_corners);
-    
+
+    f32* widths = NULL;
+    f32* corner_widths = NULL;
+    if (lines->points.has_widths) {
+        widths = MGA_PUSH_ARRAY(scratch.arena, f32, lines->points.size);
+        corner_widths = MGA_PUSH_ARRAY(scratch.arena, f32, lines->backend->num_corners);
+
+        _lines_gather_widths(lines, widths);
+    }
+
+    if (_lines_gather_points(lines, points)) {
+        _lines_tessellate(points, widths, lines->points.size, line_width, verts, corners, corner_widths);
+
+        glBindBuffer(GL_ARRAY_BUFFER, lines->backend->vert_buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(line_vert) * lines->backend->num_verts, verts);
+        glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(line_corner) * lines->backend->num_corners, corners);
+
+        if (corner_widths != NULL) {
+            glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_width_buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(f32) * lines->backend->num_corners, corner_widths);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        // The simplified levels were tessellated with the old width
+        if (lines->backend->num_lods > 0) {
+            _lines_lod_geometry lods[DRAW_LINES_MAX_LODS] = { 0 };
+            u32 num_lods = _lines_compute_lods(scratch.arena, points, lines->points.size, line_width, lods);
+
+            _lines_upload_lods(lines, lods, num_lods);
+        }
+    }
+
+    mga_scratch_release(scratch);
+}
+
+static f32 _lines_half_width(const f32* widths, u32 index, f32 width) {
+    return (widths == NULL ? width : widths[index]) * 0.5f;
+}
+
+static void _lines_tessellate(const vec2f* points, const f32* widths, u32 num_points, f32 width, line_vert* verts, line_corner* corners, f32* corner_widths) {
     u32 num_verts = 0;
     u32 num_corners = 0;
 
-    if (lines->points.size == 1) {
-        vec2f point = lines->points.first->points[0];
+    if (num_points == 1) {
+        vec2f point = points[0];
+        f32 point_width = _lines_half_width(widths, 0, width) * 2.0f;
+
+        if (corner_widths != NULL) {
+            corner_widths[0] = point_width;
+            corner_widths[1] = point_width;
+        }
 
         // Two corners form a circle here
         corners[num_corners++] = (line_corner){
-            vec2f_add(point, (vec2f){ line_width * 1.1f, 0.0f }),
+            vec2f_add(point, (vec2f){ point_width * 1.1f, 0.0f }),
             point,
-            vec2f_add(point, (vec2f){ line_width * 1.1f, 0.0f }),
+            vec2f_add(point, (vec2f){ point_width * 1.1f, 0.0f }),
         };
         corners[num_corners++] = (line_corner){
-            vec2f_sub(point, (vec2f){ line_width * 1.1f, 0.0f }),
+            vec2f_sub(point, (vec2f){ point_width * 1.1f, 0.0f }),
             point,
-            vec2f_sub(point, (vec2f){ line_width * 1.1f, 0.0f }),
+            vec2f_sub(point, (vec2f){ point_width * 1.1f, 0.0f }),
         };
     } else {
         // Points
@@ -459,42 +1711,33 @@ void draw_lines_update(draw_lines* lines, vec4f col, f32 line_width) {
         // Lines and normals
         vec2f l1, n1, l2, n2;
 
-        f32 half_w = lines->width * 0.5f;
-
-        draw_point_bucket* cur_bucket = lines->points.first;
-        u32 cur_num_buckets = 0;
+        // Half width at the point the vertices are placed around
+        f32 half_w = _lines_half_width(widths, 0, width);
 
-        p0 = cur_bucket->points[0];
-        p1 = cur_bucket->points[1];
+        p0 = points[0];
+        p1 = points[1];
 
         l1 = vec2f_nrm(vec2f_sub(p1, p0));
         n1 = vec2f_prp(l1);
 
         // Corner for rounded line cap
+        if (corner_widths != NULL) {
+            corner_widths[num_corners] = half_w * 2.0f;
+        }
         corners[num_corners++] = (line_corner){ p1, p0, p1 };
 
         verts[num_verts++] = (line_vert){ vec2f_sub(p0, vec2f_scl(n1, half_w)) };
         verts[num_verts++] = (line_vert){ vec2f_add(p0, vec2f_scl(n1, half_w)) };
 
         // This is to get the correct p0 and p1 values in the first iteration of the for loop
-        p1 = cur_bucket->points[0];
-        p2 = cur_bucket->points[1];
-        for (u32 i = 1; i < lines->points.size - 1; i++) {
+        p1 = points[0];
+        p2 = points[1];
+        for (u32 i = 1; i < num_points - 1; i++) {
             p0 = p1;
             p1 = p2;
+            p2 = points[i + 1];
 
-            if (i + 1 >= (cur_num_buckets + 1) * DRAW_POINT_BUCKET_SIZE) {
-                if (cur_bucket->next == NULL) {
-                    fprintf(stderr, "Cannot update lines, not enough point buckets\n");
-
-                    // So that scratch arena gets released
-                    goto end;
-                }
-
-                cur_bucket = cur_bucket->next;
-                cur_num_buckets++;
-            }
-            p2 = cur_bucket->points[i + 1 - cur_num_buckets * DRAW_POINT_BUCKET_SIZE];
+            half_w = _lines_half_width(widths, i, width);
 
             l1 = vec2f_nrm(vec2f_sub(p1, p0));
             n1 = vec2f_prp(l1);
@@ -523,6 +1766,9 @@ void draw_lines_update(draw_lines* lines, vec4f col, f32 line_width) {
                 verts[num_verts++] = (line_vert){ vec2f_sub(p1, vec2f_scl(miter, half_w * miter_scale)) };
                 verts[num_verts++] = (line_vert){ vec2f_add(p1, vec2f_scl(miter, half_w * miter_scale)) };
             } else {
+                if (corner_widths != NULL) {
+                    corner_widths[num_corners] = half_w * 2.0f;
+                }
                 corners[num_corners++] = (line_corner){ p0, p1, p2 };
 
                 // Point in the middle of line 1
@@ -564,32 +1810,34 @@ void draw_lines_update(draw_lines* lines, vec4f col, f32 line_width) {
         l2 = vec2f_nrm(vec2f_sub(p2, p1));
         n2 = vec2f_prp(l2);
 
-        corners[num_corners++] = (line_corner){ p1, p2, p1 };
-
-        verts[num_verts++] = (line_vert){ vec2f_sub(p2, vec2f_scl(n2, half_w)) };
-        verts[num_verts++] = (line_vert){ vec2f_add(p2, vec2f_scl(n2, half_w)) };
-    }
-
-    glBindBuffer(GL_ARRAY_BUFFER, lines->backend->vert_buffer);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(line_vert) * lines->backend->num_verts, verts);
-    glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_buffer);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(line_corner) * lines->backend->num_corners, corners);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+        half_w = _lines_half_width(widths, num_points - 1, width);
 
-end: 
+        if (corner_widths != NULL) {
+            corner_widths[num_corners] = half_w * 2.0f;
+        }
+        corners[num_corners++] = (line_corner){ p1, p2, p1 };
 
-    mga_scratch_release(scratch);
+        verts[num_verts++] = (line_vert){ vec2f_sub(p2, vec2f_scl(n2, half_w)) };
+        verts[num_verts++] = (line_vert){ vec2f_add(p2, vec2f_scl(n2, half_w)) };
+    }
 }
 
 void _maybe_resize_buffer(u32 type, u32 elem_size, u32 size, u32* capacity, u32* buffer);
 
-void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
+void draw_lines_add_point_internal(draw_lines* lines, vec2f point, f32 width, b32 new) {
     if (lines == NULL) {
         fprintf(stderr, "Cannot add point to NULL lines\n");
         return;
     }
 
+    _lines_unshare(lines, true);
+    // Only the end of the geometry is written, so the rest has to be there
+    _lines_begin_edit(lines);
+
+    b32 has_widths = lines->points.has_widths;
+    // Keeping every point inside the bounding box
+    width = MIN(width, lines->width);
+
     if (point.x - lines->width < lines->bounding_box.x) {
         lines->bounding_box.w += lines->bounding_box.x - (point.x - lines->width);
         lines->bounding_box.x = point.x - lines->width;
@@ -606,20 +1854,33 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
     }
 
     vec2f* last_points = lines->backend->last_points;
+    f32* last_widths = lines->backend->last_widths;
 
     vec2f prev_point = last_points[2];
 
     if (new && lines->points.size > 3) {
         last_points[2] = point;
-        lines->points.last->points[lines->points.last->size -1] = point;
+        last_widths[2] = width;
+
+        draw_point_bucket* last = draw_point_list_own(&lines->points, lines->points.last);
+        last->points[last->size - 1] = point;
+        draw_point_bucket_expand_bounds(last, point);
+
+        if (has_widths) {
+            last->widths->widths[last->size - 1] = width;
+        }
     } else {
         new = false;
 
-        draw_point_list_add(&lines->points, point);
+        draw_point_list_add_width(&lines->points, point, width);
 
         last_points[0] = last_points[1];
         last_points[1] = last_points[2];
         last_points[2] = point;
+
+        last_widths[0] = last_widths[1];
+        last_widths[1] = last_widths[2];
+        last_widths[2] = width;
     }
 
     if (lines->points.size == 1) {
@@ -630,27 +1891,34 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
             lines->width * 2.0f,
         };
 
-        vec2f point = lines->points.first->points[0];
+        vec2f point = lines->points.first->bucket->points[0];
 
         lines->backend->num_corners = 2;
         line_corner corners[2] = { 
             {
-                vec2f_add(point, (vec2f){ lines->width * 1.1f, 0.0f }),
+                vec2f_add(point, (vec2f){ width * 1.1f, 0.0f }),
                 point,
-                vec2f_add(point, (vec2f){ lines->width * 1.1f, 0.0f }),
+                vec2f_add(point, (vec2f){ width * 1.1f, 0.0f }),
             },
             {
-                vec2f_sub(point, (vec2f){ lines->width * 1.1f, 0.0f }),
+                vec2f_sub(point, (vec2f){ width * 1.1f, 0.0f }),
                 point,
-                vec2f_sub(point, (vec2f){ lines->width * 1.1f, 0.0f }),
+                vec2f_sub(point, (vec2f){ width * 1.1f, 0.0f }),
             }
         };
 
         glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_buffer);
         glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(corners), corners);
+
+        if (has_widths) {
+            f32 corner_widths[2] = { width, width };
+
+            glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_width_buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(corner_widths), corner_widths);
+        }
     } else if (lines->points.size == 2) {
-        vec2f p0 = lines->points.first->points[0];
-        vec2f p1 = lines->points.first->points[1];
+        vec2f p0 = lines->points.first->bucket->points[0];
+        vec2f p1 = lines->points.first->bucket->points[1];
 
         lines->backend->num_corners = 2;
         lines->backend->num_verts = 4;
@@ -661,17 +1929,25 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
             { p0, p1, p0 }
         };
 
-        f32 half_w = lines->width * 0.5f;
+        f32 half_w0 = (has_widths ? last_widths[1] : lines->width) * 0.5f;
+        f32 half_w1 = (has_widths ? last_widths[2] : lines->width) * 0.5f;
         vec2f line = vec2f_nrm(vec2f_sub(p1, p0));
         vec2f norm = vec2f_prp(line);
 
         line_vert verts[4] = {
-            { vec2f_sub(p0, vec2f_scl(norm, half_w)) },
-            { vec2f_add(p0, vec2f_scl(norm, half_w)) },
-            { vec2f_sub(p1, vec2f_scl(norm, half_w)) },
-            { vec2f_add(p1, vec2f_scl(norm, half_w)) },
+            { vec2f_sub(p0, vec2f_scl(norm, half_w0)) },
+            { vec2f_add(p0, vec2f_scl(norm, half_w0)) },
+            { vec2f_sub(p1, vec2f_scl(norm, half_w1)) },
+            { vec2f_add(p1, vec2f_scl(norm, half_w1)) },
         };
 
+        if (has_widths) {
+            f32 corner_widths[2] = { half_w0 * 2.0f, half_w1 * 2.0f };
+
+            glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_width_buffer);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(corner_widths), corner_widths);
+        }
+
         u32 indices[6] = {
             0, 1, 2,
             1, 3, 2
@@ -717,13 +1993,16 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
         line_vert new_verts[6];
         u32 new_indices[6];
         line_corner new_corners[2];
+        f32 new_corner_widths[2];
 
         // Points
         vec2f p0, p1, p2;
         // Lines and normals
         vec2f l1, n1, l2, n2;
 
-        f32 half_w = lines->width * 0.5f;
+        // Half widths at p1 and p2
+        f32 half_w = (has_widths ? last_widths[1] : lines->width) * 0.5f;
+        f32 end_half_w = (has_widths ? last_widths[2] : lines->width) * 0.5f;
 
         p0 = last_points[0];
         p1 = last_points[1];
@@ -768,6 +2047,7 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
             new_indices[4] = start_verts + 3;
             new_indices[5] = start_verts + 2;
         } else {
+            new_corner_widths[lines->backend->num_corners - start_corners] = half_w * 2.0f;
             new_corners[lines->backend->num_corners++ - start_corners] = (line_corner){
                 p0, p1, p2
             };
@@ -816,12 +2096,13 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
             new_indices[5] = start_verts + 4;
         }
 
+        new_corner_widths[lines->backend->num_corners - start_corners] = end_half_w * 2.0f;
         new_corners[lines->backend->num_corners++ - start_corners] = (line_corner){
             p1, p2, p1
         };
 
-        new_verts[(*num_verts)++ - start_verts] = (line_vert){ vec2f_sub(p2, vec2f_scl(n2, half_w)) };
-        new_verts[(*num_verts)++ - start_verts] = (line_vert){ vec2f_add(p2, vec2f_scl(n2, half_w)) };
+        new_verts[(*num_verts)++ - start_verts] = (line_vert){ vec2f_sub(p2, vec2f_scl(n2, end_half_w)) };
+        new_verts[(*num_verts)++ - start_verts] = (line_vert){ vec2f_add(p2, vec2f_scl(n2, end_half_w)) };
 
         _maybe_resize_buffer(
             GL_ARRAY_BUFFER, sizeof(line_vert), lines->backend->num_verts,
@@ -835,6 +2116,12 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
             GL_ARRAY_BUFFER, sizeof(line_corner), lines->backend->num_corners,
             &lines->backend->corner_capacity, &lines->backend->corner_buffer
         );
+        if (has_widths) {
+            _maybe_resize_buffer(
+                GL_ARRAY_BUFFER, sizeof(f32), lines->backend->num_corners,
+                &lines->backend->corner_width_capacity, &lines->backend->corner_width_buffer
+            );
+        }
 
         glBindBuffer(GL_ARRAY_BUFFER, lines->backend->vert_buffer);
         glBufferSubData(
@@ -853,6 +2140,14 @@ void draw_lines_add_point_internal(draw_lines* lines, vec2f point, b32 new) {
             GL_ARRAY_BUFFER, sizeof(line_corner) * start_corners,
             sizeof(line_corner) * (lines->backend->num_corners - start_corners), new_corners
         );
+
+        if (has_widths) {
+            glBindBuffer(GL_ARRAY_BUFFER, lines->backend->corner_width_buffer);
+            glBufferSubData(
+                GL_ARRAY_BUFFER, sizeof(f32) * start_corners,
+                sizeof(f32) * (lines->backend->num_corners - start_corners), new_corner_widths
+            );
+        }
     }
 }
 
@@ -875,64 +2170,538 @@ void _maybe_resize_buffer(u32 type, u32 elem_size, u32 size, u32* capacity, u32*
     }
 }
 
+// Points without a width get the full width of the lines
 void draw_lines_add_point(draw_lines* lines, vec2f point) {
-    draw_lines_add_point_internal(lines, point, false);
+    draw_lines_add_point_internal(lines, point, INFINITY, false);
 }
 void draw_lines_change_last(draw_lines* lines, vec2f new_last) {
-    draw_lines_add_point_internal(lines, new_last, true);
+    draw_lines_add_point_internal(lines, new_last, INFINITY, true);
+}
+void draw_lines_add_point_width(draw_lines* lines, vec2f point, f32 width) {
+    draw_lines_add_point_internal(lines, point, width, false);
+}
+void draw_lines_change_last_width(draw_lines* lines, vec2f new_last, f32 width) {
+    draw_lines_add_point_internal(lines, new_last, width, true);
 }
 
 b32 draw_lines_collide_circle(draw_lines* lines, circlef circle) {
+    return draw_lines_collide_capsule(lines, (capsulef){ circle.pos, circle.pos, circle.r });
+}
+b32 draw_lines_collide_capsule(draw_lines* lines, capsulef capsule) {
     if (lines == NULL || lines->points.size == 0) {
-        fprintf(stderr, "Cannot collide circle with lines: lines is NULL or has zero points\n");
+        fprintf(stderr, "Cannot collide capsule with lines: lines is NULL or has zero points\n");
+        return false;
+    }
+
+    if (!rectf_collide_capsulef(lines->bounding_box, capsule)) {
+        return false;
+    }
+
+    return draw_query_capsule(&lines->points, capsule, lines->width * 0.5f);
+}
+
+// Range [t0, t1] of the line p0 + d * t that is closer than r to center
+static b32 _lines_line_circle_range(vec2f p0, vec2f d, vec2f center, f32 r, f32* t0, f32* t1) {
+    vec2f f = vec2f_sub(p0, center);
+
+    f32 a = vec2f_dot(d, d);
+    f32 b = 2.0f * vec2f_dot(f, d);
+    f32 c = vec2f_dot(f, f) - r * r;
+
+    f32 disc = b * b - 4.0f * a * c;
+    if (disc <= 0.0f) {
         return false;
     }
 
-    if (!rectf_collide_circlef(lines->bounding_box, circle)) {
+    disc = sqrtf(disc);
+    *t0 = (-b - disc) / (2.0f * a);
+    *t1 = (-b + disc) / (2.0f * a);
+
+    return true;
+}
+
+// Narrows [t0, t1] down to where f0 + f1 * t is between lo and hi
+static void _lines_clip_range(f32 f0, f32 f1, f32 lo, f32 hi, f32* t0, f32* t1) {
+    if (f1 == 0.0f) {
+        if (f0 < lo || f0 > hi) {
+            *t0 = INFINITY;
+            *t1 = -INFINITY;
+        }
+
+        return;
+    }
+
+    f32 ta = (lo - f0) / f1;
+    f32 tb = (hi - f0) / f1;
+
+    *t0 = MAX(*t0, MIN(ta, tb));
+    *t1 = MIN(*t1, MAX(ta, tb));
+}
+
+// Range [t_enter, t_exit] of the segment that is inside the capsule
+// Returns false if none of it is, or if it only touches the capsule
+// Pieces left by an erase start on the capsule, so they have to count as missed
+static b32 _lines_segment_capsule_range(vec2f p0, vec2f p1, capsulef capsule, f32* t_enter, f32* t_exit) {
+    f32 r = capsule.r;
+    vec2f d = vec2f_sub(p1, p0);
+    f32 a = vec2f_dot(d, d);
+
+    if (a < 1e-12f) {
+        *t_enter = 0.0f;
+        *t_exit = 1.0f;
+
+        return vec2f_segment_sqr_dist(p0, capsule.p0, capsule.p1) < r * r;
+    }
+
+    // The capsule is made of the circles at its ends and the rectangle between them
+    // It is convex, so the ranges of the three parts join up into one range
+    f32 t0 = INFINITY;
+    f32 t1 = -INFINITY;
+    f32 s0, s1;
+
+    if (_lines_line_circle_range(p0, d, capsule.p0, r, &s0, &s1)) {
+        t0 = MIN(t0, s0);
+        t1 = MAX(t1, s1);
+    }
+    if (_lines_line_circle_range(p0, d, capsule.p1, r, &s0, &s1)) {
+        t0 = MIN(t0, s0);
+        t1 = MAX(t1, s1);
+    }
+
+    vec2f axis = vec2f_sub(capsule.p1, capsule.p0);
+    f32 axis_len = vec2f_len(axis);
+
+    if (axis_len > 1e-6f) {
+        vec2f u = vec2f_scl(axis, 1.0f / axis_len);
+        vec2f f = vec2f_sub(p0, capsule.p0);
+
+        s0 = -INFINITY;
+        s1 = INFINITY;
+        // Along the axis, then across it
+        _lines_clip_range(vec2f_dot(f, u), vec2f_dot(d, u), 0.0f, axis_len, &s0, &s1);
+        _lines_clip_range(vec2f_crs(u, f), vec2f_crs(u, d), -r, r, &s0, &s1);
+
+        if (s0 < s1) {
+            t0 = MIN(t0, s0);
+            t1 = MAX(t1, s1);
+        }
+    }
+
+    t0 = MAX(t0, 0.0f);
+    t1 = MIN(t1, 1.0f);
+
+    if (t1 <= t0 || (t1 - t0) * sqrtf(a) <= r * ERASE_TOUCH_EPSILON) {
         return false;
     }
 
-    if (lines->points.size == 1 &&
-        vec2f_dist(lines->points.first->points[0], circle.pos) < lines->width + circle.r) {
-            return true;
+    *t_enter = t0;
+    *t_exit = t1;
+
+    return true;
+}
+
+static vec2f _lines_lerp(vec2f a, vec2f b, f32 t) {
+    return vec2f_add(a, vec2f_scl(vec2f_sub(b, a), t));
+}
+
+// Keeps the first num_points points and releases the buckets after them
+// The bounds, last points and geometry sizes are set for the shorter lines,
+// but the geometry of the new last point is still the inner point geometry,
+// so a point has to be added right after this to rewrite the end of the lines
+static void _lines_truncate(draw_lines* lines, const vec2f* points, const f32* widths, u32 num_points) {
+    _lines_free_lods(lines);
+    _lines_free_curves(lines);
+
+    draw_point_list* list = &lines->points;
+
+    u32 num_kept = 0;
+    draw_point_node* last = NULL;
+    draw_point_node* node = list->first;
+
+    while (node != NULL && num_kept < num_points) {
+        // Only the bucket that is cut has to be copied if it is shared
+        if (node->bucket->size > num_points - num_kept) {
+            draw_point_list_own(list, node)->size = num_points - num_kept;
+        }
+        num_kept += node->bucket->size;
+
+        last = node;
+        node = node->next;
+    }
+
+    while (node != NULL) {
+        draw_point_node* next = node->next;
+
+        draw_point_bucket_release(list->allocator, node->bucket);
+        draw_point_alloc_free_node(list->allocator, node);
+
+        node = next;
+    }
+
+    if (last == NULL) {
+        list->first = NULL;
+    } else {
+        last->next = NULL;
+    }
+    list->last = last;
+    list->size = num_kept;
+
+    _lines_compute_bounds(lines, points, num_kept);
+    _lines_set_last_points(lines, points, widths, num_kept);
+
+    if (num_kept > 0) {
+        _lines_count_geometry(
+            points, num_kept,
+            &lines->backend->num_verts, &lines->backend->num_indices, &lines->backend->num_corners
+        );
+    } else {
+        lines->backend->num_verts = 0;
+        lines->backend->num_indices = 0;
+        lines->backend->num_corners = 0;
+    }
+}
+
+// Uploads all the geometry, growing the buffers if they are too small
+static void _lines_fill_buffer(u32 type, u32 elem_size, u32 size, const void* data, u32* capacity, u32 buffer) {
+    glBindBuffer(type, buffer);
+
+    if (size > *capacity) {
+        glBufferData(type, (u64)elem_size * size, data, GL_DYNAMIC_DRAW);
+        *capacity = size;
+    } else {
+        glBufferSubData(type, 0, (u64)elem_size * size, data);
+    }
+}
+static void _lines_replace_geometry(draw_lines* lines, const line_vert* verts, const u32* indices, const line_corner* corners, const f32* corner_widths) {
+    draw_lines_backend* backend = lines->backend;
+
+    glBindVertexArray(backend->segment_array);
+    _lines_fill_buffer(
+        GL_ARRAY_BUFFER, sizeof(line_vert), backend->num_verts, verts,
+        &backend->vert_capacity, backend->vert_buffer
+    );
+    _lines_fill_buffer(
+        GL_ELEMENT_ARRAY_BUFFER, sizeof(u32), backend->num_indices, indices,
+        &backend->index_capacity, backend->index_buffer
+    );
+
+    glBindVertexArray(backend->corner_array);
+    _lines_fill_buffer(
+        GL_ARRAY_BUFFER, sizeof(line_corner), backend->num_corners, corners,
+        &backend->corner_capacity, backend->corner_buffer
+    );
+
+    if (corner_widths != NULL) {
+        _lines_fill_buffer(
+            GL_ARRAY_BUFFER, sizeof(f32), backend->num_corners, corner_widths,
+            &backend->corner_width_capacity, backend->corner_width_buffer
+        );
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Tessellates all the points again, for when more than the end of the lines changed
+static void _lines_rebuild_geometry(draw_lines* lines) {
+    u32 num_points = lines->points.size;
+    b32 has_widths = lines->points.has_widths;
+
+    draw_lines_backend* backend = lines->backend;
+
+    // Lines that lost their curves get their buffers back,
+    // big enough for the geometry and for new points if the lines are empty
+    if (backend->geometry_dropped && !backend->evicted && backend->num_curves == 0) {
+        _lines_create_buffers(
+            lines, MAX(backend->num_verts, LINES_START_VERTS),
+            MAX(backend->num_indices, LINES_START_INDICES), MAX(backend->num_corners, LINES_START_CORNERS)
+        );
+
+        if (has_widths) {
+            backend->corner_width_capacity = backend->corner_capacity;
+            backend->corner_width_buffer = glh_create_buffer(
+                GL_ARRAY_BUFFER, sizeof(f32) * backend->corner_width_capacity, NULL, GL_DYNAMIC_DRAW
+            );
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        backend->geometry_dropped = false;
+    }
+
+    if (num_points == 0) {
+        return;
+    }
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    vec2f* points = MGA_PUSH_ARRAY(scratch.arena, vec2f, num_points);
+    f32* widths = has_widths ? MGA_PUSH_ARRAY(scratch.arena, f32, num_points) : NULL;
+
+    _lines_gather_points(lines, points);
+    if (has_widths) {
+        _lines_gather_widths(lines, widths);
+    }
+
+    _lines_compute_bounds(lines, points, num_points);
+    _lines_set_last_points(lines, points, widths, num_points);
+    _lines_count_geometry(points, num_points, &backend->num_verts, &backend->num_indices, &backend->num_corners);
+
+    // The geometry is built when it is restored
+    if (backend->geometry_dropped) {
+        mga_scratch_release(scratch);
+        return;
+    }
+
+    line_vert* verts = MGA_PUSH_ARRAY(scratch.arena, line_vert, backend->num_verts);
+    u32* indices = MGA_PUSH_ARRAY(scratch.arena, u32, backend->num_indices);
+    line_corner* corners = MGA_PUSH_ARRAY(scratch.arena, line_corner, backend->num_corners);
+    f32* corner_widths = has_widths ? MGA_PUSH_ARRAY(scratch.arena, f32, backend->num_corners) : NULL;
+
+    _lines_build_indices(points, num_points, indices);
+    _lines_tessellate(points, widths, num_points, lines->width, verts, corners, corner_widths);
+
+    _lines_replace_geometry(lines, verts, indices, corners, corner_widths);
+
+    mga_scratch_release(scratch);
+}
+
+// Moves the buckets from index start on over to rest, with first_point in front of them
+// Buckets the lines still need are split by copying the rest of their points to a new bucket
+static void _lines_split_buckets(draw_lines* lines, u32 start, u32 num_kept, b32 has_first, vec2f first_point, f32 first_width, draw_lines* rest) {
+    draw_point_list* list = &lines->points;
+    draw_point_list* rest_list = &rest->points;
+    draw_point_allocator* allocator = list->allocator;
+
+    draw_point_node* prev = NULL;
+    draw_point_node* node = list->first;
+    u32 bucket_start = 0;
+
+    while (node != NULL && bucket_start + node->bucket->size <= start) {
+        bucket_start += node->bucket->size;
+        prev = node;
+        node = node->next;
+    }
+
+    if (node == NULL) {
+        return;
     }
 
-    f32 dist_threshold = (lines->width * 0.5f + circle.r) * (lines->width * 0.5f + circle.r);
+    u32 offset = start - bucket_start;
+    b32 split = num_kept > bucket_start;
+
+    draw_point_node* head = node;
+
+    if (split) {
+        // The lines keep this bucket
+        const draw_point_bucket* bucket = node->bucket;
 
-    vec2f p0, p1;
-    p1 = lines->points.first->points[0];
+        draw_point_bucket* head_bucket = draw_point_alloc_alloc(allocator);
+        head_bucket->size = bucket->size - offset;
+        memcpy(head_bucket->points, bucket->points + offset, sizeof(vec2f) * head_bucket->size);
+        draw_point_bucket_update_bounds(head_bucket);
+
+        if (bucket->widths != NULL) {
+            head_bucket->widths = draw_point_alloc_alloc_widths(allocator);
+            memcpy(head_bucket->widths->widths, bucket->widths->widths + offset, sizeof(f32) * head_bucket->size);
+        }
+
+        head = draw_point_alloc_alloc_node(allocator);
+        head->bucket = head_bucket;
+
+        head->next = node->next;
+        node->next = NULL;
+        list->last = node;
+    } else {
+        if (offset > 0) {
+            draw_point_bucket* bucket = draw_point_list_own(list, node);
+
+            bucket->size -= offset;
+            memmove(bucket->points, bucket->points + offset, sizeof(vec2f) * bucket->size);
+            draw_point_bucket_update_bounds(bucket);
+
+            if (bucket->widths != NULL) {
+                memmove(bucket->widths->widths, bucket->widths->widths + offset, sizeof(f32) * bucket->size);
+            }
+        }
 
-    draw_point_bucket* cur_bucket = lines->points.first;
-    u32 cur_num_buckets = 0;
+        if (prev == NULL) {
+            list->first = NULL;
+        } else {
+            prev->next = NULL;
+        }
+        list->last = prev;
+    }
 
-    for (u32 i = 0; i < lines->points.size - 1; i++) {
-        p0 = p1;
+    if (has_first) {
+        if (head->bucket->size < DRAW_POINT_BUCKET_SIZE) {
+            draw_point_bucket* bucket = draw_point_list_own(rest_list, head);
 
-        if (i + 1 >= (cur_num_buckets + 1) * DRAW_POINT_BUCKET_SIZE) {
-            if (cur_bucket->next == NULL) {
-                fprintf(stderr, "Cannot collide lines, not enough point buckets\n");
+            memmove(bucket->points + 1, bucket->points, sizeof(vec2f) * bucket->size);
+            if (bucket->widths != NULL) {
+                memmove(bucket->widths->widths + 1, bucket->widths->widths, sizeof(f32) * bucket->size);
+            }
 
-                return false;
+            bucket->size++;
+        } else {
+            draw_point_bucket* bucket = draw_point_alloc_alloc(allocator);
+            if (head->bucket->widths != NULL) {
+                bucket->widths = draw_point_alloc_alloc_widths(allocator);
             }
+            bucket->size = 1;
+
+            draw_point_node* new_head = draw_point_alloc_alloc_node(allocator);
+            new_head->bucket = bucket;
+            new_head->next = head;
+            head = new_head;
+        }
 
-            cur_bucket = cur_bucket->next;
-            cur_num_buckets++;
+        draw_point_bucket* bucket = head->bucket;
+
+        bucket->points[0] = first_point;
+        draw_point_bucket_expand_bounds(bucket, first_point);
+        if (bucket->widths != NULL) {
+            bucket->widths->widths[0] = first_width;
         }
-        p1 = cur_bucket->points[i + 1 - cur_num_buckets * DRAW_POINT_BUCKET_SIZE];
+    }
+
+    rest_list->first = head;
+    rest_list->size = 0;
+
+    for (draw_point_node* n = head; n != NULL; n = n->next) {
+        rest_list->size += n->bucket->size;
+        rest_list->last = n;
+    }
+}
+
+b32 draw_lines_erase_circle(draw_lines* lines, circlef circle, draw_lines* rest) {
+    return draw_lines_erase_capsule(lines, (capsulef){ circle.pos, circle.pos, circle.r }, rest);
+}
+b32 draw_lines_erase_capsule(draw_lines* lines, capsulef capsule, draw_lines* rest) {
+    if (lines == NULL) {
+        fprintf(stderr, "Cannot erase from NULL lines\n");
+        return false;
+    }
+    if (rest != NULL && (rest->points.size != 0 || rest->allocator != lines->allocator)) {
+        fprintf(stderr, "Cannot erase lines: rest has to be empty and use the same point allocator\n");
+        return false;
+    }
+
+    // The query kernel rules out most lines before any points are copied
+    if (lines->points.size == 0 || !draw_lines_collide_capsule(lines, capsule)) {
+        return false;
+    }
+
+    _lines_unshare(lines, true);
+
+    u32 num_points = lines->points.size;
+    b32 has_widths = lines->points.has_widths;
+
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    vec2f* points = MGA_PUSH_ARRAY(scratch.arena, vec2f, num_points);
+    f32* widths = has_widths ? MGA_PUSH_ARRAY(scratch.arena, f32, num_points) : NULL;
+
+    if (!_lines_gather_points(lines, points)) {
+        mga_scratch_release(scratch);
+        return false;
+    }
+    if (has_widths) {
+        _lines_gather_widths(lines, widths);
+    }
+
+    // Same reach as draw_lines_collide_capsule
+    capsule.r += lines->width * 0.5f;
 
-        vec2f line_vec = vec2f_sub(p1, p0);
-        vec2f point_vec = vec2f_sub(circle.pos, p0);
-        f32 t = vec2f_dot(point_vec, line_vec) / vec2f_dot(line_vec, line_vec);
-        t = CLAMP(t, 0, 1);
+    f32 t_enter = 0.0f;
+    f32 t_exit = 0.0f;
+    f32 unused = 0.0f;
 
-        f32 sqr_dist = vec2f_sqr_dist(point_vec, vec2f_scl(line_vec, t));
+    u32 first = num_points;
+    b32 hit = false;
 
-        if (sqr_dist < dist_threshold) {
-            return true;
+    if (num_points == 1) {
+        hit = vec2f_segment_sqr_dist(points[0], capsule.p0, capsule.p1) < capsule.r * capsule.r;
+        first = 0;
+    } else {
+        for (u32 i = 0; i + 1 < num_points && !hit; i++) {
+            if (_lines_segment_capsule_range(points[i], points[i + 1], capsule, &t_enter, &unused)) {
+                hit = true;
+                first = i;
+            }
         }
     }
 
-    return false;
+    if (!hit) {
+        mga_scratch_release(scratch);
+        return false;
+    }
+
+    // The kept part is rewritten in place
+    _lines_begin_edit(lines);
+
+    if (num_points == 1) {
+        draw_lines_clear(lines);
+
+        mga_scratch_release(scratch);
+        return true;
+    }
+
+    // The erased part goes on until a segment is clear of the capsule
+    // Later parts that come back into the capsule are left for the next call on rest
+    u32 last = first;
+    _lines_segment_capsule_range(points[first], points[first + 1], capsule, &unused, &t_exit);
+    while (last + 2 < num_points &&
+        _lines_segment_capsule_range(points[last + 1], points[last + 2], capsule, &unused, &t_exit)) {
+        last++;
+    }
+
+    // Points where the lines enter and leave the capsule
+    vec2f enter = _lines_lerp(points[first], points[first + 1], t_enter);
+    vec2f exit = _lines_lerp(points[last], points[last + 1], t_exit);
+
+    f32 enter_width = 0.0f;
+    f32 exit_width = 0.0f;
+    if (has_widths) {
+        enter_width = widths[first] + (widths[first + 1] - widths[first]) * t_enter;
+        exit_width = widths[last] + (widths[last + 1] - widths[last]) * t_exit;
+    }
+
+    // Points before the erased part
+    // Segments before first miss the capsule, so only the very first point can be inside of it
+    u32 num_kept = (first > 0 || t_enter > 0.0f) ? first + 1 : 0;
+    b32 has_enter = num_kept > 0 && !vec2f_eq(enter, points[first]);
+
+    // Points after it, the same goes for the very last point
+    u32 rest_start = last + 1;
+    b32 has_rest = t_exit < 1.0f || rest_start + 1 < num_points;
+    b32 has_exit = t_exit < 1.0f && !vec2f_eq(exit, points[rest_start]);
+
+    if (has_rest && rest != NULL) {
+        draw_lines_reinit(rest, lines->color, lines->width);
+        draw_lines_use_point_widths(rest, has_widths);
+
+        // The buckets are moved over before the lines free what they no longer need
+        _lines_split_buckets(lines, rest_start, num_kept, has_exit, exit, exit_width, rest);
+
+        _lines_rebuild_geometry(rest);
+    }
+
+    // Only the end of the kept part is rewritten, the geometry before it stays in place
+    if (num_kept == 0) {
+        draw_lines_clear(lines);
+    } else if (has_enter) {
+        _lines_truncate(lines, points, widths, num_kept);
+        draw_lines_add_point_width(lines, enter, has_widths ? enter_width : INFINITY);
+    } else {
+        _lines_truncate(lines, points, widths, num_kept - 1);
+        draw_lines_add_point_width(lines, points[first], has_widths ? widths[first] : INFINITY);
+    }
+
+    mga_scratch_release(scratch);
+
+    return true;
 }
 
 static const char* line_seg_vert = GLSL_SOURCE(
@@ -975,13 +2744,15 @@ static const char* corner_vert = GLSL_SOURCE(
     layout (location = 0) in vec2 a_p0;
     layout (location = 1) in vec2 a_p1;
     layout (location = 2) in vec2 a_p2;
+    // Width at p1
+    layout (location = 3) in float a_width;
 
     out vec2 pos;
     flat out vec2 p0;
     flat out vec2 p1;
     flat out vec2 p2;
+    flat out float line_width;
 
-    uniform float u_line_width;
     uniform mat3 u_view_mat;
     uniform vec2 u_screen;
 
@@ -994,6 +2765,7 @@ static const char* corner_vert = GLSL_SOURCE(
         p0 = a_p0;
         p1 = a_p1;
         p2 = a_p2;
+        line_width = a_width;
 
         vec2 l1 = normalize(p1 - p0);
         vec2 n1 = vec2(-l1.y, l1.x);
@@ -1015,7 +2787,7 @@ static const char* corner_vert = GLSL_SOURCE(
         }
 
 
-        float half_w = u_line_width * 0.5;
+        float half_w = line_width * 0.5;
         float s = -sign(crs(p1 - p0, p2 - p1));
         // TODO: Is this line necessary?
         if (s == 0.0) { s = 1.0; }
@@ -1041,15 +2813,15 @@ static const char* corner_vert = GLSL_SOURCE(
         if ((gl_VertexID % 2) == 1) {
             if (dot(line_sum, line_sum) < TANGENT_EPSILON) {
                 pos = gl_VertexID == 1 ?
-                    p1 + n1 * s * half_w + l1 * u_line_width :
-                    p1 - n1 * s * half_w + l1 * u_line_width;
+                    p1 + n1 * s * half_w + l1 * line_width :
+                    p1 - n1 * s * half_w + l1 * line_width;
             } else {
                 // Points for line cap calculations
                 // (i1, i2) and (i3, i4) define two lines
                 // These verts sit at the intersection of those lines
                 vec2 i1 = p1 + miter * (s * half_w);
                 vec2 i2 = i1 - tangent;
-                vec2 i3 = (p1 - miter * (s * half_w * miter_scale)) + (n1 * s * u_line_width);
+                vec2 i3 = (p1 - miter * (s * half_w * miter_scale)) + (n1 * s * line_width);
                 vec2 i4 = i3 + l1;
 
                 vec2 c1 = (l1 * -crs(i1, i2) - tangent * crs(i3, i4)) / crs(tangent, -l1);
@@ -1078,8 +2850,8 @@ static const char* corner_frag = GLSL_SOURCE(
     flat in vec2 p0;
     flat in vec2 p1;
     flat in vec2 p2;
+    flat in float line_width;
 
-    uniform float u_line_width;
     uniform vec4 u_col;
 
     float line_seg_sdf(vec2 p, vec2 a, vec2 b) {
@@ -1090,8 +2862,107 @@ static const char* corner_frag = GLSL_SOURCE(
     }
 
     void main() {
-        float dist = min(line_seg_sdf(pos, p0, p1), line_seg_sdf(pos, p1, p2)) - u_line_width * 0.5;
-        dist /= u_line_width;
+        float dist = min(line_seg_sdf(pos, p0, p1), line_seg_sdf(pos, p1, p2)) - line_width * 0.5;
+        dist /= line_width;
+        float blending = fwidth(dist);
+        float alpha = smoothstep(0.0, -blending, dist);
+        vec4 col = vec4(u_col.xyz, u_col.w * alpha);
+
+        out_col = col;
+    }
+);
+
+static const char* curve_vert = GLSL_SOURCE(
+    330,
+
+    layout (location = 0) in vec2 a_a;
+    layout (location = 1) in vec2 a_b;
+    layout (location = 2) in vec2 a_c;
+    layout (location = 3) in vec2 a_d;
+    layout (location = 4) in float a_width0;
+    layout (location = 5) in float a_width1;
+
+    out float side;
+
+    uniform mat3 u_view_mat;
+    uniform float u_pixels_per_unit;
+    uniform float u_tolerance;
+
+    void main() {
+        side = (float(gl_VertexID % 2) - 0.5) * 2.0;
+
+        // Same bound as draw_spline_subdivisions, with the tolerance converted to world units
+        float max_second = 6.0 * max(length(a_b), length(a_a + a_b));
+        float tolerance = u_tolerance / u_pixels_per_unit;
+        float pieces = clamp(ceil(sqrt(max_second / (8.0 * tolerance))), 1.0, float(DRAW_LINES_CURVE_MAX_PIECES));
+
+        // Vertices past the last piece collapse onto the end of the segment
+        float t = min(float(gl_VertexID / 2), pieces) / pieces;
+
+        vec2 pos = a_d + t * (3.0 * a_c + t * (3.0 * a_b + t * a_a));
+        vec2 tangent = 3.0 * a_c + t * (6.0 * a_b + t * 3.0 * a_a);
+
+        // The derivative vanishes where control points sit on top of the ends
+        if (dot(tangent, tangent) < TANGENT_EPSILON) {
+            tangent = 3.0 * (a_a + a_b + a_c);
+        }
+        if (dot(tangent, tangent) < TANGENT_EPSILON) {
+            tangent = vec2(1.0, 0.0);
+        }
+
+        tangent = normalize(tangent);
+        vec2 norm = vec2(-tangent.y, tangent.x);
+
+        pos += norm * (side * mix(a_width0, a_width1, t) * 0.5);
+
+        gl_Position = vec4((u_view_mat * vec3(pos, 1.0)).xy, 0.0, 1.0);
+    }
+);
+
+static const char* joint_vert = GLSL_SOURCE(
+    330,
+
+    layout (location = 0) in vec2 a_a;
+    layout (location = 1) in vec2 a_b;
+    layout (location = 2) in vec2 a_c;
+    layout (location = 3) in vec2 a_d;
+    layout (location = 4) in float a_width0;
+    layout (location = 5) in float a_width1;
+
+    // Position relative to the joint center, in half line widths
+    out vec2 local;
+
+    uniform mat3 u_view_mat;
+
+    const vec2 quad[6] = vec2[6](
+        vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(-1.0, 1.0),
+        vec2(1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+    );
+
+    void main() {
+        // The first six vertices are the start of the segment, the others are the end
+        vec2 center = gl_VertexID < 6 ? a_d : a_a + 3.0 * (a_b + a_c) + a_d;
+        float width = gl_VertexID < 6 ? a_width0 : a_width1;
+
+        // Some room around the circle for antialiasing
+        local = quad[gl_VertexID % 6] * 1.1;
+
+        vec2 pos = center + local * (width * 0.5);
+
+        gl_Position = vec4((u_view_mat * vec3(pos, 1.0)).xy, 0.0, 1.0);
+    }
+);
+
+static const char* joint_frag = GLSL_SOURCE(
+    330,
+    layout (location = 0) out vec4 out_col;
+
+    in vec2 local;
+
+    uniform vec4 u_col;
+
+    void main() {
+        float dist = length(local) - 1.0;
         float blending = fwidth(dist);
         float alpha = smoothstep(0.0, -blending, dist);
         vec4 col = vec4(u_col.xyz, u_col.w * alpha);
@@ -5,6 +5,22 @@
 
 #define GFX_NUM_KEYS          256
 #define GFX_NUM_MOUSE_BUTTONS 5
+#define GFX_MAX_POINTER_SAMPLES 64
+
+typedef struct {
+    vec2f pos;
+    f32 pressure;
+    u64 time_usec;
+} gfx_pointer_sample;
+
+// Time between input events being received and being processed
+// Only measured when the input thread is running
+typedef struct {
+    u64 num_events;
+    u64 total_latency_usec;
+    u64 max_latency_usec;
+    u64 num_dropped;
+} gfx_input_stats;
 
 typedef struct {
     string8 title;
@@ -13,6 +29,10 @@ typedef struct {
     b32 should_close;
 
     vec2f mouse_pos;
+    // Pen pressure in [0, 1], always 1 for devices without pressure
+    f32 pressure;
+    // True while the pointer is a pen that reports pressure
+    b32 pen;
     i32 mouse_scroll;
     b8 mouse_buttons[GFX_NUM_MOUSE_BUTTONS];
     b8 prev_mouse_buttons[GFX_NUM_MOUSE_BUTTONS];
@@ -20,6 +40,12 @@ typedef struct {
     b8 keys[GFX_NUM_KEYS];
     b8 prev_keys[GFX_NUM_KEYS];
 
+    // Every pointer position received since the last gfx_win_process_events, oldest first
+    gfx_pointer_sample pointer_samples[GFX_MAX_POINTER_SAMPLES];
+    u32 num_pointer_samples;
+
+    gfx_input_stats input_stats;
+
     struct _gfx_win_backend* backend;
 } gfx_window;
 
@@ -27,10 +53,20 @@ gfx_window* gfx_win_create(mg_arena* arena, u32 width, u32 height, string8 title
 void gfx_win_destroy(gfx_window* win);
 
 void gfx_win_process_events(gfx_window* win);
+// Blocks until there are events to process or timeout_ms runs out
+// Returns true if there are events waiting
+b32 gfx_win_wait_events(gfx_window* win, u32 timeout_ms);
+// Moves input capture to a separate thread so slow frames do not delay or merge input events
+// Events are still applied to the window in gfx_win_process_events
+// Returns false if the platform does not support it
+b32 gfx_win_start_input_thread(mg_arena* arena, gfx_window* win);
 
 void gfx_win_make_current(gfx_window* win);
 void gfx_win_clear(gfx_window* win);
 void gfx_win_swap_buffers(gfx_window* win);
+// Sets how many vertical blanks gfx_win_swap_buffers waits for, 0 disables vsync
+// Returns false if the platform does not support changing it
+b32 gfx_win_set_swap_interval(gfx_window* win, i32 interval);
 
 #define GFX_IS_MOUSE_DOWN(win, mb) ( win->mouse_buttons[mb])
 #define GFX_IS_MOUSE_UP(win, mb)   (!win->mouse_buttons[mb])
@@ -0,0 +1,81 @@
+#include "gfx_events.h"
+
+#include <stdio.h>
+
+#include "os/os.h"
+
+b32 gfx_event_queue_push(gfx_event_queue* queue, const gfx_event* event) {
+    u64 write_pos = queue->write_pos;
+    u64 read_pos = OS_ATOMIC_LOAD_ACQUIRE(&queue->read_pos);
+
+    if (write_pos - read_pos >= GFX_EVENT_QUEUE_SIZE) {
+        OS_ATOMIC_STORE_RELAXED(&queue->num_dropped, queue->num_dropped + 1);
+        return false;
+    }
+
+    queue->events[write_pos & (GFX_EVENT_QUEUE_SIZE - 1)] = *event;
+
+    // The event has to be visible before the consumer can see the new position
+    OS_ATOMIC_STORE_RELEASE(&queue->write_pos, write_pos + 1);
+
+    return true;
+}
+
+b32 gfx_event_queue_pop(gfx_event_queue* queue, gfx_event* out) {
+    u64 read_pos = queue->read_pos;
+    u64 write_pos = OS_ATOMIC_LOAD_ACQUIRE(&queue->write_pos);
+
+    if (read_pos == write_pos) {
+        return false;
+    }
+
+    *out = queue->events[read_pos & (GFX_EVENT_QUEUE_SIZE - 1)];
+
+    // The slot can only be reused after the event has been copied out
+    OS_ATOMIC_STORE_RELEASE(&queue->read_pos, read_pos + 1);
+
+    return true;
+}
+
+b32 gfx_event_queue_empty(gfx_event_queue* queue) {
+    return OS_ATOMIC_LOAD_ACQUIRE(&queue->read_pos) == OS_ATOMIC_LOAD_ACQUIRE(&queue->write_pos);
+}
+
+void gfx_win_apply_event(gfx_window* win, const gfx_event* event) {
+    switch (event->type) {
+        case GFX_EVENT_MOUSE_MOVE: {
+            win->mouse_pos = event->pos;
+            win->pressure = event->pressure;
+            gfx_win_add_pointer_sample(win, event->pos, event->time_usec);
+        } break;
+        case GFX_EVENT_MOUSE_DOWN: {
+            if (event->value >= 0 && event->value < GFX_NUM_MOUSE_BUTTONS) {
+                win->mouse_buttons[event->value] = true;
+            }
+        } break;
+        case GFX_EVENT_MOUSE_UP: {
+            if (event->value >= 0 && event->value < GFX_NUM_MOUSE_BUTTONS) {
+                win->mouse_buttons[event->value] = false;
+            }
+        } break;
+        case GFX_EVENT_SCROLL: {
+            win->mouse_scroll = event->value;
+        } break;
+        case GFX_EVENT_KEY_DOWN: {
+            win->keys[event->value] = true;
+        } break;
+        case GFX_EVENT_KEY_UP: {
+            win->keys[event->value] = false;
+        } break;
+        default: break;
+    }
+}
+
+void gfx_win_add_pointer_sample(gfx_window* win, vec2f pos, u64 time_usec) {
+    // When there are too many, the newest sample replaces the last one so the final position stays correct
+    if (win->num_pointer_samples == GFX_MAX_POINTER_SAMPLES) {
+        win->num_pointer_samples--;
+    }
+
+    win->pointer_samples[win->num_pointer_samples++] = (gfx_pointer_sample){ pos, win->pressure, time_usec };
+}
@@ -0,0 +1,60 @@
+#ifndef GFX_EVENTS_H
+#define GFX_EVENTS_H
+
+#include "base/base.h"
+#include "gfx.h"
+
+// Must be a power of two
+#define GFX_EVENT_QUEUE_SIZE 1024
+#define GFX_CACHE_LINE 64
+
+typedef enum {
+    GFX_EVENT_NONE,
+    GFX_EVENT_MOUSE_MOVE,
+    GFX_EVENT_MOUSE_DOWN,
+    GFX_EVENT_MOUSE_UP,
+    GFX_EVENT_SCROLL,
+    GFX_EVENT_KEY_DOWN,
+    GFX_EVENT_KEY_UP,
+} gfx_event_type;
+
+// Input event captured with the time it was received
+typedef struct {
+    gfx_event_type type;
+    u64 time_usec;
+
+    vec2f pos;
+    // Only set for mouse moves
+    f32 pressure;
+    // Mouse button, key or scroll direction depending on the type
+    i32 value;
+} gfx_event;
+
+// Lock-free ring buffer between exactly one producer thread and one consumer thread
+// Each position is only written by one side, so they are kept on separate cache lines
+typedef struct {
+    gfx_event events[GFX_EVENT_QUEUE_SIZE];
+
+    u64 write_pos;
+    u8 _write_pad[GFX_CACHE_LINE - sizeof(u64)];
+
+    u64 read_pos;
+    u8 _read_pad[GFX_CACHE_LINE - sizeof(u64)];
+
+    // Events lost because the queue was full, only written by the producer
+    u64 num_dropped;
+} gfx_event_queue;
+
+// Producer side, returns false and drops the event if the queue is full
+b32 gfx_event_queue_push(gfx_event_queue* queue, const gfx_event* event);
+// Consumer side, returns false if the queue is empty
+b32 gfx_event_queue_pop(gfx_event_queue* queue, gfx_event* out);
+b32 gfx_event_queue_empty(gfx_event_queue* queue);
+
+// Updates the window input state with the event
+// Used by backends that convert native events to gfx_events
+void gfx_win_apply_event(gfx_window* win, const gfx_event* event);
+// Records a pointer position for this frame, with the current pressure of the window
+void gfx_win_add_pointer_sample(gfx_window* win, vec2f pos, u64 time_usec);
+
+#endif // GFX_EVENTS_H
@@ -0,0 +1,120 @@
+#include "gfx_pacer.h"
+
+#include <stdio.h>
+#include <math.h>
+
+#include "os/os.h"
+
+void gfx_pacer_init(gfx_pacer* pacer, u64 refresh_usec, u64 margin_usec, b32 vsync) {
+    if (pacer == NULL) {
+        fprintf(stderr, "Cannot init pacer: pacer is NULL\n");
+        return;
+    }
+
+    *pacer = (gfx_pacer){
+        .refresh_usec = refresh_usec,
+        .margin_usec = margin_usec,
+        .vsync = vsync
+    };
+}
+
+void gfx_pacer_wait(gfx_pacer* pacer) {
+    u64 now = os_now_usec();
+
+    if (pacer->last_present == 0) {
+        pacer->frame_start = now;
+        return;
+    }
+
+    // After the loop was idle the next vblank is projected forward from the last present
+    u64 next_vblank = pacer->last_present + pacer->refresh_usec;
+    if (next_vblank < now) {
+        u64 periods = (now - next_vblank) / pacer->refresh_usec + 1;
+        next_vblank += periods * pacer->refresh_usec;
+    }
+
+    u64 lead = pacer->work_usec + pacer->margin_usec;
+    u64 target = next_vblank > lead ? next_vblank - lead : 0;
+
+    // Waiting never takes more than one refresh, even if the projection drifted during a long idle
+    target = MIN(target, now + pacer->refresh_usec);
+
+    if (target > now + GFX_PACER_SPIN_USEC) {
+        os_sleep_usec(target - now - GFX_PACER_SPIN_USEC);
+    }
+
+    while ((now = os_now_usec()) < target) { }
+
+    pacer->frame_start = now;
+}
+
+void gfx_pacer_present(gfx_pacer* pacer, gfx_window* win) {
+    u64 submit = os_now_usec();
+
+    gfx_win_swap_buffers(win);
+
+    u64 present = os_now_usec();
+
+    // Rising quickly and falling slowly keeps one slow frame from causing a string of missed vblanks
+    u64 work = submit - pacer->frame_start;
+    if (work > pacer->work_usec) {
+        pacer->work_usec = work;
+    } else {
+        pacer->work_usec -= (pacer->work_usec - work) / 16;
+    }
+
+    if (pacer->last_present != 0) {
+        u64 interval = present - pacer->last_present;
+
+        // Only intervals close to one period say anything about the refresh rate
+        if (pacer->vsync && interval > pacer->refresh_usec / 2 && interval < pacer->refresh_usec * 3 / 2) {
+            pacer->refresh_usec = (pacer->refresh_usec * 31 + interval) / 32;
+        }
+
+        // Longer gaps are from the main loop being idle, not from slow frames
+        if (interval < pacer->refresh_usec * GFX_PACER_IDLE_PERIODS) {
+            pacer->frame_times[pacer->frame_index] = (f32)interval / 1000.0f;
+            pacer->frame_index = (pacer->frame_index + 1) % GFX_PACER_HISTORY;
+            pacer->num_frame_times = MIN(pacer->num_frame_times + 1, GFX_PACER_HISTORY);
+        }
+    }
+
+    pacer->last_present = present;
+}
+
+gfx_pacer_stats gfx_pacer_get_stats(const gfx_pacer* pacer) {
+    gfx_pacer_stats stats = { 0 };
+
+    if (pacer->num_frame_times == 0) {
+        return stats;
+    }
+
+    f32 refresh_ms = (f32)pacer->refresh_usec / 1000.0f;
+
+    stats.num_frames = pacer->num_frame_times;
+    stats.min_ms = pacer->frame_times[0];
+    stats.max_ms = pacer->frame_times[0];
+
+    f32 sum = 0.0f;
+    for (u32 i = 0; i < pacer->num_frame_times; i++) {
+        f32 t = pacer->frame_times[i];
+
+        sum += t;
+        stats.min_ms = MIN(stats.min_ms, t);
+        stats.max_ms = MAX(stats.max_ms, t);
+
+        if (t > refresh_ms * 1.5f) {
+            stats.num_missed++;
+        }
+    }
+    stats.mean_ms = sum / (f32)stats.num_frames;
+
+    f32 sqr_sum = 0.0f;
+    for (u32 i = 0; i < pacer->num_frame_times; i++) {
+        f32 diff = pacer->frame_times[i] - stats.mean_ms;
+        sqr_sum += diff * diff;
+    }
+    stats.std_dev_ms = sqrtf(sqr_sum / (f32)stats.num_frames);
+
+    return stats;
+}
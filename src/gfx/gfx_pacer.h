@@ -0,0 +1,60 @@
+#ifndef GFX_PACER_H
+#define GFX_PACER_H
+
+#include "base/base.h"
+#include "gfx.h"
+
+// Number of frame times kept for the jitter statistics
+#define GFX_PACER_HISTORY 256
+// The last part of a wait is spent spinning, sleeps can overshoot by a scheduler tick
+#define GFX_PACER_SPIN_USEC 200
+// Gaps between presents longer than this many refresh periods are not counted as frames
+#define GFX_PACER_IDLE_PERIODS 8
+
+// Schedules frames so that input is sampled as late as possible before the next vblank
+// The time from sampling input to the swap is measured every frame,
+// and the wait before the next frame is shortened or lengthened to match.
+typedef struct {
+    // Estimated time between vblanks
+    u64 refresh_usec;
+    // Estimated time from sampling input to submitting the frame
+    u64 work_usec;
+    // Extra time left before the deadline to absorb slower frames
+    u64 margin_usec;
+
+    // Without vsync, refresh_usec is only a frame rate cap and is never adjusted
+    b32 vsync;
+
+    u64 frame_start;
+    u64 last_present;
+
+    // Time between presents, in milliseconds
+    f32 frame_times[GFX_PACER_HISTORY];
+    u32 frame_index;
+    u32 num_frame_times;
+} gfx_pacer;
+
+typedef struct {
+    u32 num_frames;
+
+    f32 mean_ms;
+    f32 std_dev_ms;
+    f32 min_ms;
+    f32 max_ms;
+
+    // Frames that took more than one and a half refresh periods
+    u32 num_missed;
+} gfx_pacer_stats;
+
+// refresh_usec is the starting guess for the vblank period
+void gfx_pacer_init(gfx_pacer* pacer, u64 refresh_usec, u64 margin_usec, b32 vsync);
+
+// Sleeps until the latest point where input can be sampled and the frame still makes the next vblank
+// Marks the start of the frame
+void gfx_pacer_wait(gfx_pacer* pacer);
+// Swaps the window buffers and updates the timing estimates
+void gfx_pacer_present(gfx_pacer* pacer, gfx_window* win);
+
+gfx_pacer_stats gfx_pacer_get_stats(const gfx_pacer* pacer);
+
+#endif // GFX_PACER_H
@@ -67,3 +67,13 @@ u32 glh_create_buffer(u32 buffer_type, u64 size, void* data, u32 draw_type) {
 
     return buffer;
 }
+
+void glh_check_errors(const char* label) {
+#ifdef DEBUG
+    for (u32 err = glGetError(); err != GL_NO_ERROR; err = glGetError()) {
+        fprintf(stderr, "OpenGL error 0x%x in %s\n", err, label);
+    }
+#else
+    UNUSED(label);
+#endif
+}
@@ -5,5 +5,7 @@
 
 u32 glh_create_shader(const char* vertex_source, const char* fragment_source);
 u32 glh_create_buffer(u32 buffer_type, u64 size, void* data, u32 draw_type);
+// Prints every OpenGL error that came up since the last check, only in debug builds
+void glh_check_errors(const char* label);
 
 #endif // OPENGL_HELPERS_H
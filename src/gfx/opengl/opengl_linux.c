@@ -3,10 +3,17 @@
 #ifdef PLATFORM_LINUX
 
 #include "gfx/gfx.h"
+#include "gfx/gfx_events.h"
+#include "os/os.h"
 #include "opengl.h"
 
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/eventfd.h>
 
 #include <X11/Xlib.h>
 #include <X11/Xutil.h>
@@ -21,15 +28,32 @@ typedef struct _gfx_win_backend {
     Window window;
     GLXContext gl_context;
     Atom del_atom;
+
+    // Input thread, it has its own connection because Xlib connections are not thread safe
+    b32 input_thread_running;
+    Display* input_display;
+    os_thread* input_thread;
+    gfx_event_queue input_queue;
+    // Written by the input thread after pushing events
+    i32 wake_fd;
+    // Written by the main thread to stop the input thread
+    i32 quit_fd;
 } _gfx_win_backend;
 
+#define X11_INPUT_EVENT_MASK (ButtonPressMask | ButtonReleaseMask | PointerMotionMask | KeyPressMask | KeyReleaseMask)
+
 typedef GLXContext (*glXCreateContextAttribsARBProc) (Display*, GLXFBConfig, GLXContext, Bool, const int*);
+typedef void (*glXSwapIntervalEXTProc) (Display*, GLXDrawable, int);
+typedef int (*glXSwapIntervalMESAProc) (unsigned int);
 
 #define X(ret, name, args) gl_##name##_func name = NULL;
 #   include "opengl_funcs.h"
 #undef X
 
 static gfx_key x11_translate_key(XKeyEvent* e);
+static b32 x11_translate_event(XEvent* e, gfx_event* out);
+static void x11_input_thread(void* win_ptr);
+static b32 glx_has_extension(gfx_window* win, const char* name);
 
 gfx_window* gfx_win_create(mg_arena* arena, u32 width, u32 height, string8 title) {
     gfx_window* win = MGA_PUSH_ZERO_STRUCT(arena, gfx_window);
@@ -38,6 +62,7 @@ gfx_window* gfx_win_create(mg_arena* arena, u32 width, u32 height, string8 title
         .title = title,
         .width = width,
         .height = height,
+        .pressure = 1.0f,
         .backend = MGA_PUSH_ZERO_STRUCT(arena, _gfx_win_backend)
     };
 
@@ -122,7 +147,7 @@ gfx_window* gfx_win_create(mg_arena* arena, u32 width, u32 height, string8 title
         .background_pixel = WhitePixel(win->backend->display, win->backend->screen),
         .override_redirect = True,
         .colormap = XCreateColormap(win->backend->display, RootWindow(win->backend->display, win->backend->screen), visual->visual, AllocNone),
-        .event_mask = ExposureMask | ButtonPressMask | ButtonReleaseMask | PointerMotionMask | KeyPressMask | KeyReleaseMask
+        .event_mask = ExposureMask | X11_INPUT_EVENT_MASK
     };
 
     win->backend->window = XCreateWindow(
@@ -174,6 +199,19 @@ gfx_window* gfx_win_create(mg_arena* arena, u32 width, u32 height, string8 title
     return win;
 }
 void gfx_win_destroy(gfx_window* win) {
+    if (win->backend->input_thread_running) {
+        u64 one = 1;
+        if (write(win->backend->quit_fd, &one, sizeof(one)) == sizeof(one)) {
+            os_thread_join(win->backend->input_thread);
+        } else {
+            fprintf(stderr, "Cannot stop input thread: failed to write quit eventfd\n");
+        }
+
+        XCloseDisplay(win->backend->input_display);
+        close(win->backend->wake_fd);
+        close(win->backend->quit_fd);
+    }
+
     glXMakeCurrent(win->backend->display, 0, 0);
     glXDestroyContext(win->backend->display, win->backend->gl_context);
 
@@ -185,6 +223,7 @@ void gfx_win_process_events(gfx_window* win) {
     memcpy(win->prev_mouse_buttons, win->mouse_buttons, GFX_NUM_MOUSE_BUTTONS);
     memcpy(win->prev_keys, win->keys, GFX_NUM_KEYS);
     win->mouse_scroll = 0;
+    win->num_pointer_samples = 0;
     
     while (XPending(win->backend->display)) {
         XEvent e = { 0 };
@@ -196,42 +235,135 @@ void gfx_win_process_events(gfx_window* win) {
                 win->width = e.xexpose.width;
                 win->height = e.xexpose.height;
             } break;
-            case ButtonPress: {
-                if (e.xbutton.button == 4) {
-                    // Scroll up
-                    win->mouse_scroll = 1;
-                } else if (e.xbutton.button == 5) {
-                    // Scroll down
-                    win->mouse_scroll = -1;
-                } else {
-                    win->mouse_buttons[e.xbutton.button - 1] = true;
-                }
-            } break;
-            case ButtonRelease: {
-                if (e.xbutton.button != 4 && e.xbutton.button != 5)
-                    win->mouse_buttons[e.xbutton.button - 1] = false;
-            } break;
-            case MotionNotify: {
-                win->mouse_pos.x = (f32)e.xmotion.x;
-                win->mouse_pos.y = (f32)e.xmotion.y;
-            } break;
-            case KeyPress: {
-                gfx_key keydown = x11_translate_key(&e.xkey);
-                win->keys[keydown] = true;
-            } break;
-            case KeyRelease: {
-                gfx_key keyup = x11_translate_key(&e.xkey);
-                win->keys[keyup] = false;
-            } break;
             case ClientMessage: {
                 if ((i64)e.xclient.data.l[0] == (i64)win->backend->del_atom) {
                     win->should_close = true;
                 }
             } break;
+            default: {
+                gfx_event event = { 0 };
+                if (x11_translate_event(&e, &event)) {
+                    gfx_win_apply_event(win, &event);
+                }
+            } break;
+        }
+    }
+
+    if (win->backend->input_thread_running) {
+        // Clearing the wake up counter, the read fails with EAGAIN when there was no wake up
+        u64 count = 0;
+        if (read(win->backend->wake_fd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+            fprintf(stderr, "Cannot clear input wake up: failed to read eventfd\n");
+        }
+
+        gfx_event event = { 0 };
+        while (gfx_event_queue_pop(&win->backend->input_queue, &event)) {
+            u64 latency = os_now_usec() - event.time_usec;
+
+            win->input_stats.num_events++;
+            win->input_stats.total_latency_usec += latency;
+            win->input_stats.max_latency_usec = MAX(win->input_stats.max_latency_usec, latency);
+
+            gfx_win_apply_event(win, &event);
         }
+
+        win->input_stats.num_dropped = OS_ATOMIC_LOAD_RELAXED(&win->backend->input_queue.num_dropped);
     }
 }
 
+b32 gfx_win_wait_events(gfx_window* win, u32 timeout_ms) {
+    Display* display = win->backend->display;
+    b32 threaded = win->backend->input_thread_running;
+
+    // Requests need to be sent before waiting on a response
+    XFlush(display);
+
+    if (XPending(display) || (threaded && !gfx_event_queue_empty(&win->backend->input_queue))) {
+        return true;
+    }
+
+    i32 fd = ConnectionNumber(display);
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(fd, &fds);
+
+    if (threaded) {
+        FD_SET(win->backend->wake_fd, &fds);
+        fd = MAX(fd, win->backend->wake_fd);
+    }
+
+    struct timeval timeout = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000
+    };
+
+    if (select(fd + 1, &fds, NULL, NULL, &timeout) <= 0) {
+        return false;
+    }
+
+    if (threaded && FD_ISSET(win->backend->wake_fd, &fds)) {
+        return true;
+    }
+
+    // The connection can be readable without there being a full event
+    return XPending(display) > 0;
+}
+
+b32 gfx_win_start_input_thread(mg_arena* arena, gfx_window* win) {
+    _gfx_win_backend* backend = win->backend;
+
+    if (backend->input_thread_running) {
+        fprintf(stderr, "Cannot start input thread: thread is already running\n");
+        return false;
+    }
+
+    backend->input_display = XOpenDisplay(NULL);
+    if (backend->input_display == NULL) {
+        fprintf(stderr, "Cannot start input thread: failed to open X11 display\n");
+        return false;
+    }
+
+    backend->wake_fd = eventfd(0, EFD_NONBLOCK);
+    backend->quit_fd = eventfd(0, EFD_NONBLOCK);
+    if (backend->wake_fd < 0 || backend->quit_fd < 0) {
+        fprintf(stderr, "Cannot start input thread: failed to create eventfd\n");
+
+        if (backend->wake_fd >= 0) {
+            close(backend->wake_fd);
+        }
+        if (backend->quit_fd >= 0) {
+            close(backend->quit_fd);
+        }
+        XCloseDisplay(backend->input_display);
+
+        return false;
+    }
+
+    // Only one client can select button presses on a window, so the main connection has to give them up
+    XSelectInput(backend->display, backend->window, ExposureMask);
+    XSync(backend->display, false);
+
+    XSelectInput(backend->input_display, backend->window, X11_INPUT_EVENT_MASK);
+    XFlush(backend->input_display);
+
+    backend->input_thread = os_thread_create(arena, x11_input_thread, win);
+    if (backend->input_thread == NULL) {
+        fprintf(stderr, "Cannot start input thread: failed to create thread\n");
+
+        XCloseDisplay(backend->input_display);
+        close(backend->wake_fd);
+        close(backend->quit_fd);
+
+        XSelectInput(backend->display, backend->window, ExposureMask | X11_INPUT_EVENT_MASK);
+
+        return false;
+    }
+
+    backend->input_thread_running = true;
+
+    return true;
+}
+
 void gfx_win_make_current(gfx_window* win) {
     glXMakeCurrent(win->backend->display, win->backend->window, win->backend->gl_context);
 }
@@ -243,6 +375,144 @@ void gfx_win_clear(gfx_window* win) {
 void gfx_win_swap_buffers(gfx_window* win) {
     glXSwapBuffers(win->backend->display, win->backend->window);
 }
+b32 gfx_win_set_swap_interval(gfx_window* win, i32 interval) {
+    if (glx_has_extension(win, "GLX_EXT_swap_control")) {
+        glXSwapIntervalEXTProc glXSwapIntervalEXT = (glXSwapIntervalEXTProc)glXGetProcAddress((const GLubyte*)"glXSwapIntervalEXT");
+
+        if (glXSwapIntervalEXT != NULL) {
+            glXSwapIntervalEXT(win->backend->display, win->backend->window, interval);
+            return true;
+        }
+    }
+
+    if (glx_has_extension(win, "GLX_MESA_swap_control") && interval >= 0) {
+        glXSwapIntervalMESAProc glXSwapIntervalMESA = (glXSwapIntervalMESAProc)glXGetProcAddress((const GLubyte*)"glXSwapIntervalMESA");
+
+        if (glXSwapIntervalMESA != NULL) {
+            return glXSwapIntervalMESA((u32)interval) == 0;
+        }
+    }
+
+    fprintf(stderr, "Cannot set swap interval: no swap control extension\n");
+    return false;
+}
+
+static b32 glx_has_extension(gfx_window* win, const char* name) {
+    const char* exts = glXQueryExtensionsString(win->backend->display, win->backend->screen);
+    if (exts == NULL) {
+        return false;
+    }
+
+    u64 name_len = strlen(name);
+
+    // Names have to match whole, GLX_EXT_swap_control is a prefix of GLX_EXT_swap_control_tear
+    for (const char* cur = strstr(exts, name); cur != NULL; cur = strstr(cur + name_len, name)) {
+        b32 start_ok = cur == exts || cur[-1] == ' ';
+        b32 end_ok = cur[name_len] == ' ' || cur[name_len] == '\0';
+
+        if (start_ok && end_ok) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void x11_input_thread(void* win_ptr) {
+    gfx_window* win = (gfx_window*)win_ptr;
+    _gfx_win_backend* backend = win->backend;
+
+    Display* display = backend->input_display;
+    i32 x11_fd = ConnectionNumber(display);
+    i32 max_fd = MAX(x11_fd, backend->quit_fd);
+
+    while (true) {
+        b32 pushed = false;
+
+        while (XPending(display)) {
+            XEvent e = { 0 };
+            XNextEvent(display, &e);
+
+            gfx_event event = { 0 };
+            if (x11_translate_event(&e, &event)) {
+                gfx_event_queue_push(&backend->input_queue, &event);
+                pushed = true;
+            }
+        }
+
+        if (pushed) {
+            // EAGAIN means the counter is full, and then the main thread is already woken up
+            u64 one = 1;
+            if (write(backend->wake_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+                fprintf(stderr, "Input thread failed to write wake up eventfd\n");
+            }
+        }
+
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(x11_fd, &fds);
+        FD_SET(backend->quit_fd, &fds);
+
+        if (select(max_fd + 1, &fds, NULL, NULL, NULL) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+
+            fprintf(stderr, "Input thread failed to wait for events\n");
+            break;
+        }
+
+        if (FD_ISSET(backend->quit_fd, &fds)) {
+            break;
+        }
+    }
+}
+
+static b32 x11_translate_event(XEvent* e, gfx_event* out) {
+    out->time_usec = os_now_usec();
+
+    switch (e->type) {
+        case ButtonPress: {
+            if (e->xbutton.button == 4) {
+                // Scroll up
+                out->type = GFX_EVENT_SCROLL;
+                out->value = 1;
+            } else if (e->xbutton.button == 5) {
+                // Scroll down
+                out->type = GFX_EVENT_SCROLL;
+                out->value = -1;
+            } else {
+                out->type = GFX_EVENT_MOUSE_DOWN;
+                out->value = e->xbutton.button - 1;
+            }
+        } break;
+        case ButtonRelease: {
+            if (e->xbutton.button == 4 || e->xbutton.button == 5) {
+                return false;
+            }
+
+            out->type = GFX_EVENT_MOUSE_UP;
+            out->value = e->xbutton.button - 1;
+        } break;
+        case MotionNotify: {
+            out->type = GFX_EVENT_MOUSE_MOVE;
+            out->pos = (vec2f){ (f32)e->xmotion.x, (f32)e->xmotion.y };
+            // Core X11 events do not report pressure
+            out->pressure = 1.0f;
+        } break;
+        case KeyPress: {
+            out->type = GFX_EVENT_KEY_DOWN;
+            out->value = x11_translate_key(&e->xkey);
+        } break;
+        case KeyRelease: {
+            out->type = GFX_EVENT_KEY_UP;
+            out->value = x11_translate_key(&e->xkey);
+        } break;
+        default: return false;
+    }
+
+    return true;
+}
 
 // Adapted from sokol_app.h
 // https://github.com/floooh/sokol/blob/master/sokol_app.h#L10175 
@@ -5,7 +5,9 @@
 
 #include "base/base.h"
 #include "gfx/gfx.h"
+#include "gfx/gfx_events.h"
 #include "gfx/opengl/opengl.h"
+#include "os/os.h"
 
 #include <emscripten.h>
 #include <emscripten/html5.h>
@@ -14,6 +16,8 @@
 typedef struct _gfx_win_backend {
     EMSCRIPTEN_WEBGL_CONTEXT_HANDLE ctx;
     b32 new_scroll;
+    // Set by the event callbacks, reset in gfx_win_process_events
+    b32 new_events;
 } _gfx_win_backend;
 
 static EM_BOOL on_mouse_event(int event_type, const EmscriptenMouseEvent* e, void* win_ptr);
@@ -30,6 +34,8 @@ gfx_window* gfx_win_create(mg_arena* arena, u32 width, u32 height, string8 title
 
     gfx_window* win = MGA_PUSH_ZERO_STRUCT(arena, gfx_window);
     win->backend = MGA_PUSH_ZERO_STRUCT(arena, _gfx_win_backend);
+    // Emscripten mouse and touch events do not report pressure
+    win->pressure = 1.0f;
 
     EmscriptenWebGLContextAttributes attr;
     emscripten_webgl_init_context_attributes(&attr);
@@ -83,6 +89,13 @@ void gfx_win_swap_buffers(gfx_window* win) {
     
     emscripten_webgl_commit_frame();
 }
+b32 gfx_win_set_swap_interval(gfx_window* win, i32 interval) {
+    UNUSED(win);
+    UNUSED(interval);
+
+    // The browser decides when frames are presented
+    return false;
+}
 void gfx_win_process_events(gfx_window* win) {
     memcpy(win->prev_mouse_buttons, win->mouse_buttons, GFX_NUM_MOUSE_BUTTONS);
     memcpy(win->prev_keys, win->keys, GFX_NUM_KEYS);
@@ -91,6 +104,28 @@ void gfx_win_process_events(gfx_window* win) {
         win->mouse_scroll = 0;
     }
     win->backend->new_scroll = 0;
+    win->backend->new_events = false;
+
+    // Callbacks run between frames, so samples from here on belong to the next frame
+    win->num_pointer_samples = 0;
+}
+b32 gfx_win_wait_events(gfx_window* win, u32 timeout_ms) {
+    // Event callbacks can only run while the main loop yields to the browser
+    f64 end_time = emscripten_get_now() + timeout_ms;
+    while (!win->backend->new_events && emscripten_get_now() < end_time) {
+        emscripten_sleep(1);
+    }
+
+    return win->backend->new_events;
+}
+
+b32 gfx_win_start_input_thread(mg_arena* arena, gfx_window* win) {
+    UNUSED(arena);
+    UNUSED(win);
+
+    // Browser events are only delivered on the main thread
+    fprintf(stderr, "Cannot start input thread: not supported on wasm\n");
+    return false;
 }
 
 void gfx_win_set_size(gfx_window* win, u32 width, u32 height) {
@@ -103,6 +138,7 @@ void gfx_win_set_size(gfx_window* win, u32 width, u32 height) {
 
 static EM_BOOL on_mouse_event(int event_type, const EmscriptenMouseEvent* e, void* win_ptr) {
     gfx_window* win = (gfx_window*)win_ptr;
+    win->backend->new_events = true;
 
     switch (event_type) { 
         case EMSCRIPTEN_EVENT_MOUSEDOWN: {
@@ -114,6 +150,8 @@ static EM_BOOL on_mouse_event(int event_type, const EmscriptenMouseEvent* e, voi
         case EMSCRIPTEN_EVENT_MOUSEMOVE: {
             win->mouse_pos.x = (f32)e->targetX;
             win->mouse_pos.y = (f32)e->targetY;
+
+            gfx_win_add_pointer_sample(win, win->mouse_pos, os_now_usec());
         } break;
         default: break;
     }
@@ -125,6 +163,7 @@ static EM_BOOL on_wheel_event(int event_type, const EmscriptenWheelEvent* e, voi
     UNUSED(event_type);
 
     gfx_window* win = (gfx_window*)win_ptr;
+    win->backend->new_events = true;
 
     win->mouse_scroll = -SIGN(e->deltaY);
     win->backend->new_scroll = true;
@@ -134,6 +173,7 @@ static EM_BOOL on_wheel_event(int event_type, const EmscriptenWheelEvent* e, voi
 
 static EM_BOOL on_touch_event(int event_type, const EmscriptenTouchEvent* e, void* win_ptr) {
     gfx_window* win = (gfx_window*)win_ptr;
+    win->backend->new_events = true;
 
     switch (event_type) {
         case EMSCRIPTEN_EVENT_TOUCHSTART: {
@@ -143,6 +183,8 @@ static EM_BOOL on_touch_event(int event_type, const EmscriptenTouchEvent* e, voi
             win->mouse_buttons[GFX_MB_LEFT] = true;
             win->mouse_pos.x = (f32)e->touches[0].targetX;
             win->mouse_pos.y = (f32)e->touches[0].targetY;
+
+            gfx_win_add_pointer_sample(win, win->mouse_pos, os_now_usec());
         } break;
         case EMSCRIPTEN_EVENT_TOUCHEND: // fallthrough
         case EMSCRIPTEN_EVENT_TOUCHCANCEL:{
@@ -157,6 +199,7 @@ static gfx_key em_translate_keycode(const char* code_str);
 
 static EM_BOOL on_key_event(int event_type, const EmscriptenKeyboardEvent* e, void* win_ptr) {
     gfx_window* win = (gfx_window*)win_ptr;
+    win->backend->new_events = true;
 
     switch(event_type) {
         case EMSCRIPTEN_EVENT_KEYDOWN: {
@@ -174,6 +217,7 @@ static EM_BOOL on_key_event(int event_type, const EmscriptenKeyboardEvent* e, vo
 
 static EM_BOOL on_ui_event(int event_type, const EmscriptenUiEvent *e, void *win_ptr) {
     gfx_window* win = (gfx_window*)win_ptr;
+    win->backend->new_events = true;
 
     switch (event_type) {
         case EMSCRIPTEN_EVENT_RESIZE: {
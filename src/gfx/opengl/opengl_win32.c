@@ -3,6 +3,8 @@
 #ifdef PLATFORM_WIN32
 
 #include "gfx/gfx.h"
+#include "gfx/gfx_events.h"
+#include "os/os.h"
 #include "opengl.h"
 
 #include <stdio.h>
@@ -59,6 +61,7 @@ static void* w32_gl_load(const char* name);
 
 typedef BOOL WINAPI (wglChoosePixelFormatARB_func)(HDC hdc, const int *piAttribIList, const FLOAT *pfAttribFList, UINT nMaxFormats, int *piFormats, UINT *nNumFormats);
 typedef HGLRC WINAPI (wglCreateContextAttribsARB_func)(HDC hdc, HGLRC hShareContext, const int *attribList);
+typedef BOOL WINAPI (wglSwapIntervalEXT_func)(int interval);
 
 static LRESULT CALLBACK w32_window_proc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam);
 
@@ -72,6 +75,7 @@ gfx_window* gfx_win_create(mg_arena* arena, u32 width, u32 height, string8 title
         .title = title,
         .width = width,
         .height = height,
+        .pressure = 1.0f,
         .backend = MGA_PUSH_ZERO_STRUCT(arena, _gfx_win_backend)
     };
 
@@ -217,6 +221,7 @@ void gfx_win_process_events(gfx_window* win) {
     memcpy(win->prev_mouse_buttons, win->mouse_buttons, GFX_NUM_MOUSE_BUTTONS);
     memcpy(win->prev_keys, win->keys, GFX_NUM_KEYS);
     win->mouse_scroll = 0;
+    win->num_pointer_samples = 0;
 
     MSG msg = { 0 };
     while (PeekMessageW(&msg, NULL, 0, 0, PM_REMOVE)) {
@@ -225,6 +230,23 @@ void gfx_win_process_events(gfx_window* win) {
     }
 }
 
+b32 gfx_win_wait_events(gfx_window* win, u32 timeout_ms) {
+    UNUSED(win);
+
+    DWORD res = MsgWaitForMultipleObjectsEx(0, NULL, timeout_ms, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+    return res == WAIT_OBJECT_0;
+}
+
+b32 gfx_win_start_input_thread(mg_arena* arena, gfx_window* win) {
+    UNUSED(arena);
+    UNUSED(win);
+
+    // Win32 messages go to the thread that created the window
+    fprintf(stderr, "Cannot start input thread: not supported on win32\n");
+    return false;
+}
+
 void gfx_win_make_current(gfx_window* win) {
     wglMakeCurrent(win->backend->device_context, win->backend->gl_context);
 }
@@ -236,6 +258,17 @@ void gfx_win_clear(gfx_window* win) {
 void gfx_win_swap_buffers(gfx_window* win) {
     SwapBuffers(win->backend->device_context);
 }
+b32 gfx_win_set_swap_interval(gfx_window* win, i32 interval) {
+    UNUSED(win);
+
+    wglSwapIntervalEXT_func* wglSwapIntervalEXT = (wglSwapIntervalEXT_func*)wglGetProcAddress("wglSwapIntervalEXT");
+    if (wglSwapIntervalEXT == NULL) {
+        fprintf(stderr, "Cannot set swap interval: wglSwapIntervalEXT not found\n");
+        return false;
+    }
+
+    return wglSwapIntervalEXT(interval);
+}
 
 static LRESULT CALLBACK w32_window_proc(HWND hWnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
     gfx_window* win = GetPropW(hWnd, L"gfx_win");
@@ -244,7 +277,25 @@ static LRESULT CALLBACK w32_window_proc(HWND hWnd, UINT uMsg, WPARAM wParam, LPA
         case WM_MOUSEMOVE: {
             win->mouse_pos.x = (f32)((lParam) & 0xffff);
             win->mouse_pos.y = (f32)((lParam >> 16) & 0xffff);
+
+            gfx_win_add_pointer_sample(win, win->mouse_pos, os_now_usec());
+        } break;
+
+#ifdef WM_POINTERUPDATE
+        // Pens still send the regular mouse messages afterwards, only the pressure is taken from here
+        case WM_POINTERUPDATE: {
+            POINTER_PEN_INFO pen_info;
+            if (GetPointerPenInfo(GET_POINTERID_WPARAM(wParam), &pen_info) && (pen_info.penMask & PEN_MASK_PRESSURE)) {
+                // Reported in [0, 1024]
+                win->pressure = (f32)pen_info.pressure / 1024.0f;
+                win->pen = true;
+            }
+        } break;
+        case WM_POINTERLEAVE: {
+            win->pressure = 1.0f;
+            win->pen = false;
         } break;
+#endif
 
         case WM_LBUTTONDOWN: {
             win->mouse_buttons[GFX_MB_LEFT] = true;
@@ -5,8 +5,10 @@
 #include <time.h>
 
 #include "base/base.h"
+#include "base/base_jobs.h"
 #include "os/os.h"
 #include "gfx/gfx.h"
+#include "gfx/gfx_pacer.h"
 #include "gfx/opengl/opengl.h"
 #include "gfx/opengl/opengl_helpers.h"
 
@@ -15,7 +17,60 @@
 #define WIDTH 1280
 #define HEIGHT 720
 
-#define INTERP_MARGIN 0.01f
+// Largest distance between the spline through the pen samples and the stroke points, in pixels
+#define STROKE_FLATNESS_PIXELS 0.25f
+// Centripetal splines do not overshoot when samples are unevenly spaced
+#define STROKE_SPLINE DRAW_STROKE_CENTRIPETAL
+#define STROKE_WIDTH 5.0f
+// Width of a pen stroke at zero pressure, as a fraction of STROKE_WIDTH
+#define MIN_PRESSURE_WIDTH 0.2f
+
+// How long the view has to stay still before the static layer is used again
+#define VIEW_SETTLE_USEC 150000
+
+// How long to block waiting for events when nothing is changing
+#define IDLE_WAIT_MS 500
+// Shorter wait while a save is being written, the lines share buckets with it until it is released
+#define SAVE_POLL_MS 20
+// Upper bound on the frame delta, the first frame after being idle would otherwise jump
+#define MAX_FRAME_DELTA (1.0f / 30.0f)
+
+// Starting guess for the refresh period, the pacer measures the real one
+#define REFRESH_USEC 16667
+// Time left between submitting a frame and the vblank
+#define PACER_MARGIN_USEC 1500
+
+// Furthest the predicted tail can reach past the pen, in pixels
+#define PREDICT_MAX_PIXELS 40.0f
+// Largest distance a dropped stroke point can be from the simplified stroke, in pixels
+#define SIMPLIFY_PIXELS 0.5f
+
+// Lines per job when checking which lines the eraser hits
+#define ERASE_BATCH_SIZE 64
+// Erasing splits strokes, so this is a limit on pieces and not on strokes drawn
+#define MAX_LINES 1024
+
+// Lasso points after this many are dropped
+#define LASSO_MAX_POINTS 1024
+// Lines per job when checking which lines are in the lasso
+#define LASSO_BATCH_SIZE 64
+
+// How far outside a stroke the pointer can be for the stroke to be highlighted, in pixels
+#define HOVER_PIXELS 6.0f
+
+// Point memory the undo history can keep alive for lines that are not in the document
+#define HISTORY_BUDGET MGA_MiB(4)
+
+// Every change to the document is appended here, it is replayed on startup
+#define JOURNAL_PATH "autosave.journal"
+// Ctrl+S writes the whole document here in the background
+#define SAVE_PATH "drawing.strokes"
+// Points built per frame while the document loads, the frame after gets the next ones
+#define LOAD_POINTS_PER_FRAME 100000
+// GPU memory for the geometry of the strokes, the ones away from the view the longest are evicted past it
+#define GPU_BUDGET MGA_MiB(256)
+// Points tessellated per frame for evicted strokes coming near the view, the ones in view are always done
+#define RESTORE_POINTS_PER_FRAME 100000
 
 static const char* basic_vert = GLSL_SOURCE(
     330,
@@ -42,6 +97,60 @@ static const char* basic_frag = GLSL_SOURCE(
     }
 );
 
+// Everything that is cached in the static layer and the tiles
+typedef struct {
+    const gfx_window* win;
+    const draw_lines_shaders* shaders;
+
+    u32 basic_program;
+    u32 basic_view_mat_loc;
+    u32 basic_col_loc;
+
+    u32 vertex_array;
+    u32 vertex_buffer;
+    u32 index_buffer;
+
+    draw_lines** lines;
+    u32 num_lines;
+} static_scene;
+
+// Lines hit by the eraser, filled in parallel
+typedef struct {
+    draw_lines** lines;
+    capsulef capsule;
+
+    b8* hits;
+} erase_sweep;
+
+// Lines with points inside the lasso, filled in parallel
+typedef struct {
+    draw_lines** lines;
+
+    const vec2f* polygon;
+    u32 num_polygon;
+    rectf bounds;
+
+    b8* hits;
+} lasso_sweep;
+
+static void draw_static_scene(void* scene_ptr, viewf view, rectf bounds);
+static void erase_sweep_range(void* sweep_ptr, u32 start, u32 end);
+static void lasso_sweep_range(void* sweep_ptr, u32 start, u32 end);
+static void invalidate_lines(draw_tiles* tiles, draw_lines** lines, u32 num_lines);
+static void update_slots(draw_lines** lines, u32 start, u32 num_lines);
+static void invalidate_history_set(draw_tiles* tiles, const draw_history_set* set);
+static void journal_entry(draw_journal* journal, const draw_history_entry* entry);
+static void journal_set(draw_journal* journal, const draw_history_set* set, b32 in_document);
+static draw_lines* new_lines(mg_arena* arena, draw_point_allocator* allocator, draw_history* history, vec4f col, f32 width);
+static rectf lines_bounds(draw_lines** lines, u32 num_lines);
+static void selection_transform(mat3f* out, vec2f pivot, vec2f offset, f32 rotation, f32 scale);
+static void draw_outline(const static_scene* scene, u32 outline_buffer, const mat3f* view_mat, const vec2f* points, u32 num_points, vec4f col);
+static void print_frame_stats(const gfx_pacer* pacer, const gfx_window* win);
+static b32 poll_save(draw_snapshot* snapshot);
+static vec2f screen_to_world(const gfx_window* win, const mat3f* inv_view_mat, vec2f pos);
+static void keep_stroke_point(draw_lines* stroke, b32* provisional_tail, vec2f point, f32 width);
+static f32 pressure_width(f32 pressure);
+
 void mga_err(mga_error err) {
     printf("MGA ERROR %d: %s", err.code, err.msg);
 }
@@ -53,9 +162,16 @@ int main(void) {
     };
     mg_arena* perm_arena = mga_create(&desc);
 
+    jobs_system* jobs = jobs_create(perm_arena, 0);
+
     gfx_window* win = gfx_win_create(perm_arena, WIDTH, HEIGHT, STR8("Line Render Test"));
     gfx_win_make_current(win);
 
+#ifdef PLATFORM_LINUX
+    // Input keeps being captured while a frame is slow
+    gfx_win_start_input_thread(perm_arena, win);
+#endif
+
     u32 basic_program = glh_create_shader(basic_vert, basic_frag);
 
     glUseProgram(basic_program);
@@ -64,6 +180,10 @@ int main(void) {
 
     draw_lines_shaders* shaders = draw_lines_shaders_create(perm_arena);
     draw_point_allocator* point_allocator = draw_point_alloc_create(perm_arena);
+    // Also keeps the lines objects that are not in use for reuse
+    draw_history* history = draw_history_create(perm_arena, HISTORY_BUDGET);
+    // Only manages the finished lines in the document, the others stay on the GPU
+    draw_residency* residency = draw_residency_create(perm_arena, GPU_BUDGET);
 
     /*u32 w = 500;
     u32 h = 400;
@@ -86,7 +206,7 @@ int main(void) {
     }*/
 
     u32 num_lines = 0;
-    draw_lines* lines[1024] = { 0 };
+    draw_lines* lines[MAX_LINES] = { 0 };
 
     vec2f rect_verts[] = {
         { -250.0f,  250.0f },
@@ -106,6 +226,8 @@ int main(void) {
 
     u32 vertex_buffer = glh_create_buffer(GL_ARRAY_BUFFER, sizeof(rect_verts), rect_verts, GL_DYNAMIC_DRAW);
     u32 index_buffer = glh_create_buffer(GL_ELEMENT_ARRAY_BUFFER, sizeof(rect_indices), rect_indices, GL_STATIC_DRAW);
+    // For the lasso and the selection box
+    u32 outline_buffer = glh_create_buffer(GL_ARRAY_BUFFER, sizeof(vec2f) * LASSO_MAX_POINTS, NULL, GL_DYNAMIC_DRAW);
 
     glClearColor(0.2f, 0.2f, 0.4f, 1.0f);
     glEnable(GL_BLEND);
@@ -122,21 +244,115 @@ int main(void) {
     mat3f_from_view(&view_mat, view);
     mat3f_inverse(&inv_view_mat, &view_mat);
 
-    gfx_win_process_events(win);
+    // The journal is the document, it loads over the first frames starting with what is in view
+    // NULL if there is no journal yet
+    draw_loader* loader = draw_loader_open(STR8(JOURNAL_PATH), view);
+
+    draw_journal* journal = NULL;
+    {
+        mga_temp scratch = mga_scratch_get(NULL, 0);
+
+        string8_list pending = { 0 };
+        if (loader != NULL) {
+            draw_loader_pending(loader, scratch.arena, &pending);
+        }
 
-    vec2f prev_mouse_pos = win->mouse_pos;
-    vec2f prev_point = prev_mouse_pos;
-    vec2f prev_prev_point = prev_mouse_pos;
+        // Rewritten with only the strokes that are left, then changes are appended to it
+        // NULL if the journal cannot be written, then nothing is saved
+        journal = draw_journal_open(perm_arena, STR8(JOURNAL_PATH), lines, num_lines, &pending);
+
+        mga_scratch_release(scratch);
+    }
+
+    draw_snapshot* snapshot = draw_snapshot_create(perm_arena);
+
+    gfx_win_process_events(win);
 
     b32 erase = false;
-    b32 extending_point = false;
+    // Where the eraser was last frame, everything it passed over since then gets erased
+    vec2f prev_erase_pos = { 0 };
+    // Everything erased until the mouse goes up is one history entry
+    draw_history_entry* erase_entry = NULL;
+    // True while lines[num_lines - 1] is still being drawn
+    b32 drawing = false;
+
+    b32 lassoing = false;
+    vec2f* lasso = MGA_PUSH_ARRAY(perm_arena, vec2f, LASSO_MAX_POINTS);
+    u32 num_lasso = 0;
+
+    // Selected lines are the last num_selected lines, so the static scene can leave them out
+    // While they are dragged, they are moved on the GPU and only get new points once the drag ends
+    u32 num_selected = 0;
+    rectf selection_bounds = { 0 };
+    b32 dragging = false;
+    vec2f drag_start = { 0 };
+    mat3f drag_transform = { 0 };
+
+    // The last point of the line being drawn is provisional when this is set,
+    // it ends the points held back by the simplifier or shows the prediction past them
+    // It gets replaced by the next kept point
+    draw_predictor predictor = { 0 };
+    draw_stroke_builder stroke_builder = { 0 };
+    draw_simplifier simplifier = { 0 };
+    b32 provisional_tail = false;
+
+    static_scene scene = {
+        .win = win,
+        .shaders = shaders,
+
+        .basic_program = basic_program,
+        .basic_view_mat_loc = basic_view_mat_loc,
+        .basic_col_loc = basic_col_loc,
+
+        .vertex_array = vertex_array,
+        .vertex_buffer = vertex_buffer,
+        .index_buffer = index_buffer,
+
+        .lines = lines,
+    };
+
+    // Finished lines are rendered into this layer and only redrawn when something changes
+    // Same number of samples as the window, so the cached lines look like the ones drawn directly
+    i32 window_samples = 0;
+    glGetIntegerv(GL_SAMPLES, &window_samples);
+    draw_layer* static_layer = draw_layer_create(perm_arena, win->width, win->height, (u32)window_samples);
+    viewf static_view = { 0 };
+    b32 static_dirty = true;
+
+    // While the view is moving, the finished lines come from the tile cache instead
+    draw_layer_shaders* layer_shaders = draw_layer_shaders_create(perm_arena);
+    draw_tiles* tiles = draw_tiles_create(perm_arena, 128, draw_static_scene, &scene);
+    viewf prev_view = view;
+    u64 last_view_change = 0;
 
     os_time_init();
 
+    b32 vsync = gfx_win_set_swap_interval(win, 1);
+
+    gfx_pacer pacer = { 0 };
+    gfx_pacer_init(&pacer, REFRESH_USEC, PACER_MARGIN_USEC, vsync);
+
+    // True when the next frame will be different even without new events
+    b32 animating = true;
+    // True from starting a save until its snapshot is released
+    b32 saving = false;
+
     u64 prev_frame = os_now_usec();
     while (!win->should_close) {
+        // Nothing can change until the next event, so there is no need for another frame
+        if (!animating && !gfx_win_wait_events(win, saving ? SAVE_POLL_MS : IDLE_WAIT_MS)) {
+            if (saving && poll_save(snapshot)) {
+                saving = false;
+            }
+            continue;
+        }
+
+        // Input is sampled as late as possible so it is fresh when the frame is shown
+        gfx_pacer_wait(&pacer);
+
         u64 cur_frame = os_now_usec();
         f32 delta = (f32)(cur_frame - prev_frame) / 1e6;
+        delta = MIN(delta, MAX_FRAME_DELTA);
         prev_frame = cur_frame;
 
 #ifndef PLATFORM_WASM
@@ -163,125 +379,542 @@ int main(void) {
             view.center.x += move_speed * delta;
         }
 
+        if (GFX_IS_KEY_JUST_DOWN(win, GFX_KEY_F3)) {
+            print_frame_stats(&pacer, win);
+        }
+
         mat3f_from_view(&view_mat, view);
 
         mat3f_inverse(&inv_view_mat, &view_mat);
 
-        vec2f mouse_pos = (vec2f){
-            2.0f * win->mouse_pos.x / win->width - 1.0f,
-            -(2.0f * win->mouse_pos.y / win->height - 1.0f),
-        };
-        mouse_pos = mat3f_mul_vec2f(&inv_view_mat, mouse_pos);
+        vec2f mouse_pos = screen_to_world(win, &inv_view_mat, win->mouse_pos);
+        // Width at the newest pressure, only used by strokes drawn with a pen
+        f32 point_width = pressure_width(win->pressure);
+
+        b32 ctrl = GFX_IS_KEY_DOWN(win, GFX_KEY_LCONTROL) || GFX_IS_KEY_DOWN(win, GFX_KEY_RCONTROL);
+        b32 undo = ctrl && GFX_IS_KEY_JUST_DOWN(win, GFX_KEY_Z);
+        b32 redo = ctrl && GFX_IS_KEY_JUST_DOWN(win, GFX_KEY_Y);
+
+        if (ctrl && GFX_IS_KEY_JUST_DOWN(win, GFX_KEY_S)) {
+            mga_temp scratch = mga_scratch_get(NULL, 0);
+
+            // The stroke being drawn is left for the next save
+            u32 num_saved = drawing ? num_lines - 1 : num_lines;
+
+            // Strokes that are not loaded yet are saved as the records they are
+            string8_list pending = { 0 };
+            if (loader != NULL) {
+                draw_loader_pending(loader, scratch.arena, &pending);
+            }
+
+            if (draw_snapshot_save(snapshot, STR8(SAVE_PATH), lines, num_saved, &pending)) {
+                saving = true;
+            } else {
+                fprintf(stderr, "Cannot save: the last save is still being written\n");
+            }
+
+            mga_scratch_release(scratch);
+        }
+
+        if (poll_save(snapshot)) {
+            saving = false;
+        }
+
+        // Nothing is undone in the middle of an operation
+        if ((undo || redo) && !drawing && !lassoing && !dragging && erase_entry == NULL) {
+            // Undoing changes which lines are in the document, so the selection is dropped first
+            if (num_selected > 0) {
+                invalidate_lines(tiles, lines + num_lines - num_selected, num_selected);
+                num_selected = 0;
+            }
+
+            const draw_history_entry* entry = undo ?
+                draw_history_undo(history, lines, &num_lines, MAX_LINES) :
+                draw_history_redo(history, lines, &num_lines, MAX_LINES);
+
+            if (entry != NULL) {
+                static_dirty = true;
+                journal_entry(journal, entry);
+
+                if (entry->type == DRAW_HISTORY_TRANSFORM) {
+                    // The bounding boxes from before the transform are gone
+                    draw_tiles_invalidate_all(tiles);
+
+                    f32 curve_tolerance = DRAW_LINES_CURVE_FIT_PIXELS * view.width / win->width;
+                    for (draw_history_chunk* chunk = entry->added.first; chunk != NULL; chunk = chunk->next) {
+                        for (u32 i = 0; i < chunk->size; i++) {
+                            draw_lines_build_curves(chunk->lines[i], curve_tolerance);
+                        }
+                    }
+                } else {
+                    invalidate_history_set(tiles, &entry->removed);
+                    invalidate_history_set(tiles, &entry->added);
+                }
+            }
+        }
 
         if (GFX_IS_MOUSE_JUST_DOWN(win, GFX_MB_LEFT)) {
-            if (GFX_IS_KEY_DOWN(win, GFX_KEY_E)) {
+            b32 on_selection = num_selected > 0 && vec2f_in_rectf(mouse_pos, selection_bounds) &&
+                !GFX_IS_KEY_DOWN(win, GFX_KEY_E) && !GFX_IS_KEY_DOWN(win, GFX_KEY_L);
+
+            // Anything else drops the selection, its lines go back into the static scene
+            if (num_selected > 0 && !on_selection) {
+                invalidate_lines(tiles, lines + num_lines - num_selected, num_selected);
+                static_dirty = true;
+                num_selected = 0;
+            }
+
+            if (on_selection) {
+                erase = false;
+                dragging = true;
+                drag_start = mouse_pos;
+            } else if (GFX_IS_KEY_DOWN(win, GFX_KEY_E)) {
                 erase = true;
-            } else {
+                prev_erase_pos = mouse_pos;
+            } else if (GFX_IS_KEY_DOWN(win, GFX_KEY_L)) {
+                erase = false;
+                lassoing = true;
+                num_lasso = 0;
+                lasso[num_lasso++] = mouse_pos;
+            } else if (num_lines < MAX_LINES) {
                 erase = false;
+                drawing = true;
 
-                num_lines++;
+                lines[num_lines++] = new_lines(perm_arena, point_allocator, history, (vec4f){ 1.0f, 1.0f, 1.0f, 1.0f }, STROKE_WIDTH);
+                update_slots(lines, num_lines - 1, num_lines);
 
-                if (lines[num_lines - 1] == NULL) {
-                    lines[num_lines - 1] = draw_lines_create(perm_arena, point_allocator, (vec4f){ 1.0f, 1.0f, 1.0f, 1.0f }, 5.0f);
-                } else {
-                    draw_lines_reinit(lines[num_lines - 1], (vec4f){ 1, 1, 1, 1}, 5.0f);
+                // Strokes without pressure keep the constant width path
+                draw_lines_use_point_widths(lines[num_lines - 1], win->pen);
+
+                draw_lines_add_point_width(lines[num_lines - 1], mouse_pos, point_width);
+
+                draw_stroke_begin(&stroke_builder, mouse_pos, point_width, STROKE_SPLINE, 0.0f);
+                draw_simplify_stream_begin(&simplifier, mouse_pos, point_width, 0.0f);
+                draw_predict_reset(&predictor);
+                provisional_tail = false;
+            }
+        } else if (lassoing && GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT)) {
+            for (u32 s = 0; s < win->num_pointer_samples && num_lasso < LASSO_MAX_POINTS; s++) {
+                vec2f point = screen_to_world(win, &inv_view_mat, win->pointer_samples[s].pos);
+
+                if (!vec2f_eq(point, lasso[num_lasso - 1])) {
+                    lasso[num_lasso++] = point;
                 }
+            }
+        } else if (!erase && drawing &&
+            (GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT) || GFX_IS_MOUSE_JUST_UP(win, GFX_MB_LEFT))) {
+
+            // The tolerances follow the zoom so they are never visible
+            f32 units_per_pixel = view.width / win->width;
+            stroke_builder.tolerance = STROKE_FLATNESS_PIXELS * units_per_pixel;
+            simplifier.tolerance = SIMPLIFY_PIXELS * units_per_pixel;
+
+            // Every sample since the last frame is used, so the stroke keeps its shape when frames are slow
+            mga_temp scratch = mga_scratch_get(NULL, 0);
+
+            // Every sample keeps the pressure it was taken with, so points kept later still get their own width
+            vec2f* samples = MGA_PUSH_ARRAY(scratch.arena, vec2f, win->num_pointer_samples);
+            f32* sample_widths = MGA_PUSH_ARRAY(scratch.arena, f32, win->num_pointer_samples);
+            for (u32 s = 0; s < win->num_pointer_samples; s++) {
+                samples[s] = screen_to_world(win, &inv_view_mat, win->pointer_samples[s].pos);
+                sample_widths[s] = pressure_width(win->pointer_samples[s].pressure);
+            }
 
-                draw_lines_add_point(lines[num_lines - 1], mouse_pos);
+            u32 max_points = win->num_pointer_samples * DRAW_STROKE_MAX_SPAN_POINTS;
+            vec2f* points = MGA_PUSH_ARRAY(scratch.arena, vec2f, max_points);
+            f32* widths = MGA_PUSH_ARRAY(scratch.arena, f32, max_points);
+            u32 num_points = draw_stroke_add_samples(
+                &stroke_builder, samples, sample_widths, win->num_pointer_samples, points, widths
+            );
+
+            for (u32 i = 0; i < num_points; i++) {
+                vec2f kept = { 0 };
+                f32 kept_width = 0.0f;
+                if (draw_simplify_stream_add(&simplifier, points[i], widths[i], &kept, &kept_width)) {
+                    keep_stroke_point(lines[num_lines - 1], &provisional_tail, kept, kept_width);
+                }
+            }
+
+            mga_scratch_release(scratch);
+        }
 
-                prev_point = mouse_pos;
-                prev_prev_point = prev_point;
+        b32 predicting = false;
+        if (drawing && GFX_IS_MOUSE_JUST_UP(win, GFX_MB_LEFT)) {
+            // The stroke ends where the pen was lifted, not where it was predicted to go
+            vec2f kept = { 0 };
+            f32 kept_width = 0.0f;
+            if (draw_simplify_stream_add(&simplifier, mouse_pos, point_width, &kept, &kept_width)) {
+                keep_stroke_point(lines[num_lines - 1], &provisional_tail, kept, kept_width);
             }
-        } else if (!erase &&
-            (GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT) || GFX_IS_MOUSE_JUST_UP(win, GFX_MB_LEFT)) &&
-            !vec2f_eq(mouse_pos, prev_mouse_pos)) {
+            if (draw_simplify_stream_flush(&simplifier, &kept, &kept_width)) {
+                keep_stroke_point(lines[num_lines - 1], &provisional_tail, kept, kept_width);
+            }
+        } else if (drawing) {
+            for (u32 s = 0; s < win->num_pointer_samples; s++) {
+                draw_predict_add_sample(&predictor, win->pointer_samples[s].pos, win->pointer_samples[s].time_usec);
+            }
+
+            // Without new samples the pen is still, which the predictor needs to know about
+            if (win->num_pointer_samples == 0) {
+                draw_predict_add_sample(&predictor, win->mouse_pos, cur_frame);
+            }
+
+            vec2f predicted = draw_predict_point(&predictor, pacer.refresh_usec, PREDICT_MAX_PIXELS);
+            predicting = !vec2f_eq(predicted, win->mouse_pos);
+
+            predicted = screen_to_world(win, &inv_view_mat, predicted);
+
+            // Short strokes cannot have a provisional tail yet,
+            // and a prediction that does not fit the held back points would cut their corner
+            // The tail is drawn with the newest pressure
+            vec2f kept = { 0 };
+            f32 kept_width = 0.0f;
+            if ((lines[num_lines - 1]->points.size < 3 || !draw_simplify_stream_fits(&simplifier, predicted, point_width)) &&
+                draw_simplify_stream_flush(&simplifier, &kept, &kept_width)) {
+                keep_stroke_point(lines[num_lines - 1], &provisional_tail, kept, kept_width);
+            }
+
+            if (provisional_tail) {
+                draw_lines_change_last_width(lines[num_lines - 1], predicted, point_width);
+            } else if (lines[num_lines - 1]->points.size >= 3 && !vec2f_eq(predicted, simplifier.anchor)) {
+                // change_last only replaces points once there are more than three
+                // A tail on top of the last kept point would be a zero length segment
+                draw_lines_add_point_width(lines[num_lines - 1], predicted, point_width);
+                provisional_tail = true;
+            }
+        }
+
+        if (drawing && GFX_IS_MOUSE_JUST_UP(win, GFX_MB_LEFT)) {
+            drawing = false;
+            static_dirty = true;
+
+            // The curves are evaluated on the GPU at whatever detail the zoom needs, so no LODs are built
+            draw_lines_build_curves(lines[num_lines - 1], DRAW_LINES_CURVE_FIT_PIXELS * view.width / win->width);
+
+            draw_tiles_invalidate(tiles, lines[num_lines - 1]->bounding_box);
+
+            draw_history_entry* entry = draw_history_begin(history, DRAW_HISTORY_ADD);
+            draw_history_added(history, entry, lines[num_lines - 1]);
+            journal_entry(journal, entry);
+            draw_history_end(history, entry);
+        }
 
-            if (!vec2f_eq(mouse_pos, prev_point)) {
-                f32 prev_dist = vec2f_dist(prev_point, mouse_pos);
-                u32 num_points = (u32)roundf(prev_dist / (view.width * INTERP_MARGIN)) + 1;
+        if (lassoing && GFX_IS_MOUSE_JUST_UP(win, GFX_MB_LEFT)) {
+            lassoing = false;
+
+            mga_temp scratch = mga_scratch_get(NULL, 0);
+
+            lasso_sweep sweep = {
+                .lines = lines,
+                .polygon = lasso,
+                .num_polygon = num_lasso,
+                .bounds = { lasso[0].x, lasso[0].y, 0.0f, 0.0f },
+                .hits = MGA_PUSH_ZERO_ARRAY(scratch.arena, b8, num_lines)
+            };
+
+            vec2f lasso_min = lasso[0];
+            vec2f lasso_max = lasso[0];
+            for (u32 i = 1; i < num_lasso; i++) {
+                lasso_min = (vec2f){ MIN(lasso_min.x, lasso[i].x), MIN(lasso_min.y, lasso[i].y) };
+                lasso_max = (vec2f){ MAX(lasso_max.x, lasso[i].x), MAX(lasso_max.y, lasso[i].y) };
+            }
+            sweep.bounds = (rectf){ lasso_min.x, lasso_min.y, lasso_max.x - lasso_min.x, lasso_max.y - lasso_min.y };
+
+            jobs_parallel_for(jobs, num_lines, LASSO_BATCH_SIZE, lasso_sweep_range, &sweep);
+
+            // Moving the selected lines to the end, keeping the order of both groups
+            draw_lines** selected = MGA_PUSH_ARRAY(scratch.arena, draw_lines*, num_lines);
+            u32 num_unselected = 0;
+
+            for (u32 i = 0; i < num_lines; i++) {
+                if (sweep.hits[i]) {
+                    selected[num_selected++] = lines[i];
+                } else {
+                    lines[num_unselected++] = lines[i];
+                }
+            }
+            for (u32 i = 0; i < num_selected; i++) {
+                lines[num_unselected + i] = selected[i];
+            }
+            update_slots(lines, 0, num_lines);
+
+            if (num_selected > 0) {
+                selection_bounds = lines_bounds(lines + num_unselected, num_selected);
+
+                invalidate_lines(tiles, lines + num_unselected, num_selected);
+                static_dirty = true;
+            }
 
-                extending_point = false;
+            mga_scratch_release(scratch);
+        }
 
-                // Catmull-Rom endpoint interpolation coefficients
-                // https://danceswithcode.net/engineeringnotes/interpolation/interpolation.html
-                vec2f c0 = prev_point;
-                vec2f c1 = vec2f_scl(vec2f_sub(mouse_pos, prev_prev_point), 0.5f);
-                vec2f c2 = vec2f_add(vec2f_sub(mouse_pos, vec2f_scl(prev_point, 2.0f)), prev_prev_point);
-                c2 = vec2f_scl(c2, 0.5f);
+        if (dragging) {
+            vec2f pivot = {
+                selection_bounds.x + selection_bounds.w * 0.5f,
+                selection_bounds.y + selection_bounds.h * 0.5f
+            };
+            vec2f from = vec2f_sub(drag_start, pivot);
+            vec2f to = vec2f_sub(mouse_pos, pivot);
+
+            vec2f offset = { 0 };
+            f32 rotation = 0.0f;
+            f32 scale = 1.0f;
+
+            // R rotates and T scales around the middle of the selection, otherwise it moves
+            if (GFX_IS_KEY_DOWN(win, GFX_KEY_R)) {
+                rotation = atan2f(vec2f_crs(from, to), vec2f_dot(from, to));
+            } else if (GFX_IS_KEY_DOWN(win, GFX_KEY_T) && vec2f_len(from) > 0.0f) {
+                scale = MAX(vec2f_len(to) / vec2f_len(from), 0.01f);
+            } else {
+                offset = vec2f_sub(mouse_pos, drag_start);
+            }
 
-                f32 t_interval = 1.0f / (f32)(num_points + 1);
-                f32 t = t_interval;
+            selection_transform(&drag_transform, pivot, offset, rotation, scale);
 
-                for (u32 i = 0; i < num_points; i++) {
-                    vec2f p = c0;
-                    p = vec2f_add(p, vec2f_scl(c1, t));
-                    p = vec2f_add(p, vec2f_scl(c2, t * t));
+            for (u32 i = num_lines - num_selected; i < num_lines; i++) {
+                draw_lines_set_transform(lines[i], &drag_transform);
+            }
 
-                    draw_lines_add_point(lines[num_lines - 1], p);
+            if (GFX_IS_MOUSE_JUST_UP(win, GFX_MB_LEFT)) {
+                dragging = false;
 
-                    t += t_interval;
+                // The points only move once, at the end of the drag
+                f32 curve_tolerance = DRAW_LINES_CURVE_FIT_PIXELS * view.width / win->width;
+                for (u32 i = num_lines - num_selected; i < num_lines; i++) {
+                    draw_lines_apply_transform(lines[i]);
+                    draw_lines_build_curves(lines[i], curve_tolerance);
                 }
 
-                prev_prev_point = prev_point;
-                prev_point = mouse_pos;
+                selection_bounds = lines_bounds(lines + num_lines - num_selected, num_selected);
+
+                if (!vec2f_eq(drag_start, mouse_pos)) {
+                    draw_history_entry* entry = draw_history_begin(history, DRAW_HISTORY_TRANSFORM);
+                    entry->transform = drag_transform;
+                    for (u32 i = num_lines - num_selected; i < num_lines; i++) {
+                        draw_history_added(history, entry, lines[i]);
+                    }
+                    journal_entry(journal, entry);
+                    draw_history_end(history, entry);
+                }
             }
         }
-        prev_mouse_pos = mouse_pos;
 
-        for (i64 i = 0; i < num_lines; i++) {
-            if (erase && GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT) && draw_lines_collide_circle(lines[i], (circlef){ mouse_pos, 25 })) {
-                draw_lines_clear(lines[i]);
-                draw_lines* cleared_line = lines[i];
+        if (erase && GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT) && num_lines > 0) {
+            mga_temp scratch = mga_scratch_get(NULL, 0);
+
+            // One query covers the whole movement, so fast strokes do not skip lines
+            capsulef eraser = { prev_erase_pos, mouse_pos, 25 };
+            prev_erase_pos = mouse_pos;
 
-                num_lines--;
+            erase_sweep sweep = {
+                .lines = lines,
+                .capsule = eraser,
+                .hits = MGA_PUSH_ZERO_ARRAY(scratch.arena, b8, num_lines)
+            };
+            jobs_parallel_for(jobs, num_lines, ERASE_BATCH_SIZE, erase_sweep_range, &sweep);
+
+            draw_lines** kept = MGA_PUSH_ARRAY(scratch.arena, draw_lines*, MAX_LINES);
+            u32 num_kept = 0;
+
+            f32 curve_tolerance = DRAW_LINES_CURVE_FIT_PIXELS * view.width / win->width;
+
+            for (u32 i = 0; i < num_lines; i++) {
+                if (!sweep.hits[i]) {
+                    kept[num_kept++] = lines[i];
+                    continue;
+                }
+
+                static_dirty = true;
+                draw_tiles_invalidate(tiles, lines[i]->bounding_box);
 
-                for (i64 j = i; j < num_lines; j++) {
-                    lines[j] = lines[j + 1];
+                if (erase_entry == NULL) {
+                    erase_entry = draw_history_begin(history, DRAW_HISTORY_ERASE);
                 }
-                lines[num_lines] = cleared_line;
 
-                i--;
+                // Every erase cuts out one part, the rest can still go through the eraser
+                draw_lines* piece = lines[i];
+                // Pieces split off by the erase have no curves yet
+                b32 split = false;
+
+                // Lines from before this erase are kept as they are for undo,
+                // the lines that get erased share their buckets and take over their geometry
+                if (!draw_history_has_added(erase_entry, piece)) {
+                    draw_lines* taken = new_lines(perm_arena, point_allocator, history, piece->color, piece->width);
+                    draw_lines_take(taken, piece);
+
+                    draw_history_removed(history, erase_entry, piece);
+                    draw_history_added(history, erase_entry, taken);
+
+                    piece = taken;
+                }
+
+                while (piece != NULL) {
+                    // Leaving room for the lines that are still to come
+                    draw_lines* rest = NULL;
+                    if (num_kept + (num_lines - i) < MAX_LINES) {
+                        rest = new_lines(perm_arena, point_allocator, history, piece->color, piece->width);
+                    }
+
+                    b32 erased = draw_lines_erase_capsule(piece, eraser, rest);
+
+                    if (piece->points.size > 0) {
+                        if (erased || split) {
+                            draw_lines_build_curves(piece, curve_tolerance);
+                        }
+                        kept[num_kept++] = piece;
+                    } else {
+                        draw_history_drop_added(history, erase_entry, piece);
+                    }
+
+                    piece = NULL;
+                    if (rest != NULL && rest->points.size > 0) {
+                        draw_history_added(history, erase_entry, rest);
+                        piece = rest;
+                        split = true;
+                    } else if (rest != NULL) {
+                        draw_history_release(history, rest);
+                    }
+
+                    if (!erased) {
+                        break;
+                    }
+                }
             }
+
+            for (u32 i = 0; i < num_kept; i++) {
+                lines[i] = kept[i];
+            }
+            num_lines = num_kept;
+            update_slots(lines, 0, num_lines);
+
+            mga_scratch_release(scratch);
         }
 
-        gfx_win_clear(win);
+        if (erase_entry != NULL && !GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT)) {
+            journal_entry(journal, erase_entry);
+            draw_history_end(history, erase_entry);
+            erase_entry = NULL;
+        }
+
+        u32 num_loaded = 0;
+        if (loader != NULL) {
+            mga_temp scratch = mga_scratch_get(NULL, 0);
+
+            draw_lines** loaded = MGA_PUSH_ARRAY(scratch.arena, draw_lines*, MAX_LINES - num_lines);
+            // Loaded strokes are finished, so they get curves like the ones drawn here
+            num_loaded = draw_loader_update(
+                loader, view, DRAW_LINES_CURVE_FIT_PIXELS * view.width / win->width, LOAD_POINTS_PER_FRAME,
+                point_allocator, jobs, perm_arena, loaded, MAX_LINES - num_lines
+            );
+
+            if (num_loaded > 0) {
+                // The stroke being drawn and the selection have to stay at the end
+                u32 start = num_lines - num_selected - (drawing ? 1 : 0);
+
+                memmove(lines + start + num_loaded, lines + start, sizeof(draw_lines*) * (num_lines - start));
+                memcpy(lines + start, loaded, sizeof(draw_lines*) * num_loaded);
+                num_lines += num_loaded;
+                update_slots(lines, start, num_lines);
+
+                invalidate_lines(tiles, lines + start, num_loaded);
+                static_dirty = true;
+            }
+
+            mga_scratch_release(scratch);
+        }
+
+        if (win->width != static_layer->width || win->height != static_layer->height) {
+            draw_layer_resize(static_layer, win->width, win->height);
+            static_dirty = true;
+        }
+        if (!vec2f_eq(view.center, static_view.center) || view.width != static_view.width ||
+            view.aspect_ratio != static_view.aspect_ratio || view.rotation != static_view.rotation) {
+            static_dirty = true;
+        }
+
+        if (!vec2f_eq(view.center, prev_view.center) || view.width != prev_view.width ||
+            view.rotation != prev_view.rotation) {
+            last_view_change = cur_frame;
+        }
+        prev_view = view;
+
+        b32 view_moving = cur_frame - last_view_change < VIEW_SETTLE_USEC;
 
         // Draw
 
-        // Rect draw
-        {
-            glUseProgram(basic_program);
-            glUniformMatrix3fv(basic_view_mat_loc, 1, GL_FALSE, view_mat.m);
+        scene.num_lines = drawing ? num_lines - 1 : num_lines - num_selected;
 
-            glUniform4f(basic_col_loc, 0.0f, 0.0f, 0.0f, 1.0f);
+        u32 num_restoring = draw_residency_update(residency, lines, scene.num_lines, view, RESTORE_POINTS_PER_FRAME);
 
-            glBindVertexArray(vertex_array);
-            glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+        b32 tiles_pending = false;
+
+        if (view_moving) {
+            gfx_win_clear(win);
+            tiles_pending = draw_tiles_draw(tiles, layer_shaders, win, view, 4000);
+        } else {
+            if (static_dirty) {
+                draw_layer_begin(static_layer);
+                draw_static_scene(&scene, view, viewf_bounding_box(view));
+                draw_layer_end(static_layer, win);
+
+                static_view = view;
+                static_dirty = false;
+            }
+
+            draw_layer_draw_window(static_layer, layer_shaders);
+        }
 
-            vec2f rect_verts[] = {
-                { -250.0f,  250.0f },
-                { -250.0f, -250.0f },
-                {  250.0f, -250.0f },
-                {  250.0f,  250.0f }
+        if (drawing) {
+            draw_lines_draw(lines[num_lines - 1], shaders, win, view);
+        }
+
+        if (num_selected > 0) {
+            rectf view_bounds = viewf_bounding_box(view);
+
+            for (u32 i = num_lines - num_selected; i < num_lines; i++) {
+                // The bounding boxes do not follow the drag
+                if (dragging || rectf_collide_rectf(lines[i]->bounding_box, view_bounds)) {
+                    draw_lines_refit_curves(lines[i], win, view);
+                    draw_lines_draw(lines[i], shaders, win, view);
+                }
+            }
+
+            rectf b = selection_bounds;
+            vec2f box[4] = {
+                { b.x, b.y }, { b.x + b.w, b.y }, { b.x + b.w, b.y + b.h }, { b.x, b.y + b.h }
             };
+            if (dragging) {
+                for (u32 i = 0; i < 4; i++) {
+                    box[i] = mat3f_mul_vec2f(&drag_transform, box[i]);
+                }
+            }
 
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(rect_verts), rect_verts);
+            draw_outline(&scene, outline_buffer, &view_mat, box, 4, (vec4f){ 0.4f, 0.7f, 1.0f, 1.0f });
+        }
 
-            glEnableVertexAttribArray(0);
-            glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vec2f), NULL);
+        // Highlights the stroke under the pointer while nothing else is going on
+        if (!drawing && !lassoing && !dragging && !(erase && GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT))) {
+            f32 hover_dist = HOVER_PIXELS * view.width / win->width + STROKE_WIDTH * 0.5f;
 
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, index_buffer);
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
+            draw_query_hit hover = { 0 };
+            if (draw_query_nearest_lines(lines, num_lines - num_selected, mouse_pos, hover_dist, &hover)) {
+                rectf b = hover.lines->bounding_box;
+                vec2f box[4] = {
+                    { b.x, b.y }, { b.x + b.w, b.y }, { b.x + b.w, b.y + b.h }, { b.x, b.y + b.h }
+                };
 
-            glDisableVertexAttribArray(0);
+                draw_outline(&scene, outline_buffer, &view_mat, box, 4, (vec4f){ 1.0f, 1.0f, 1.0f, 0.3f });
+            }
         }
 
-        for (u32 i = 0; i < num_lines; i++) {
-            draw_lines_draw(lines[i], shaders, win, view);
+        if (lassoing) {
+            draw_outline(&scene, outline_buffer, &view_mat, lasso, num_lasso, (vec4f){ 1.0f, 1.0f, 1.0f, 0.6f });
         }
 
         if (erase && GFX_IS_MOUSE_DOWN(win, GFX_MB_LEFT)) {
+            // The tiles leave the view of the last one they drew in the uniform
             glUseProgram(basic_program);
+            glUniformMatrix3fv(basic_view_mat_loc, 1, GL_FALSE, view_mat.m);
             glUniform4f(basic_col_loc, 0.0f, 1.0f, 0.0f, 0.5f);
             glBindVertexArray(vertex_array);
             glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
@@ -304,24 +937,45 @@ int main(void) {
             glDisableVertexAttribArray(0);
         }
 
-        gfx_win_swap_buffers(win);
+        gfx_pacer_present(&pacer, win);
 
 #ifdef PLATFORM_WASM
         gfx_win_process_events(win);
 #endif
 
-        os_sleep_ms(2);
+        // The tail has to settle back onto the pen once it stops moving
+        // Loading and restoring go on while there is more in reach of the view
+        animating = view_moving || tiles_pending || predicting || num_loaded > 0 || num_restoring > 0 ||
+            GFX_IS_KEY_DOWN(win, GFX_KEY_W) || GFX_IS_KEY_DOWN(win, GFX_KEY_S) ||
+            GFX_IS_KEY_DOWN(win, GFX_KEY_A) || GFX_IS_KEY_DOWN(win, GFX_KEY_D);
+    }
+
+    print_frame_stats(&pacer, win);
+
+    if (journal != NULL) {
+        draw_journal_close(journal);
+    }
+    // Waits for the save, the snapshot can share buckets with any of the lines
+    draw_snapshot_destroy(snapshot);
+    if (loader != NULL) {
+        draw_loader_destroy(loader);
     }
 
     for (u32 i = 0; i < num_lines; i++) {
         draw_lines_destroy(lines[i]);
     }
+    draw_history_destroy(history);
 
+    jobs_destroy(jobs);
+    draw_tiles_destroy(tiles);
+    draw_layer_shaders_destroy(layer_shaders);
+    draw_layer_destroy(static_layer);
     draw_lines_shaders_destroy(shaders);
     draw_point_alloc_destroy(point_allocator);
 
     glDeleteBuffers(1, &vertex_buffer);
     glDeleteBuffers(1, &index_buffer);
+    glDeleteBuffers(1, &outline_buffer);
     glDeleteVertexArrays(1, &vertex_array);
 
     glDeleteProgram(basic_program);
@@ -332,3 +986,224 @@ int main(void) {
 
     return 0;
 }
+
+static void draw_static_scene(void* scene_ptr, viewf view, rectf bounds) {
+    static_scene* scene = (static_scene*)scene_ptr;
+
+    mat3f view_mat = { 0 };
+    mat3f_from_view(&view_mat, view);
+
+    // Rect draw
+    glUseProgram(scene->basic_program);
+    glUniformMatrix3fv(scene->basic_view_mat_loc, 1, GL_FALSE, view_mat.m);
+
+    glUniform4f(scene->basic_col_loc, 0.0f, 0.0f, 0.0f, 1.0f);
+
+    glBindVertexArray(scene->vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, scene->vertex_buffer);
+
+    vec2f rect_verts[] = {
+        { -250.0f,  250.0f },
+        { -250.0f, -250.0f },
+        {  250.0f, -250.0f },
+        {  250.0f,  250.0f }
+    };
+
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(rect_verts), rect_verts);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vec2f), NULL);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, scene->index_buffer);
+    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, NULL);
+
+    glDisableVertexAttribArray(0);
+
+    for (u32 i = 0; i < scene->num_lines; i++) {
+        if (rectf_collide_rectf(scene->lines[i]->bounding_box, bounds)) {
+            // Curves fit when zoomed further out would show their error,
+            // evicted lines are only fit once, when they are restored
+            draw_lines_refit_curves(scene->lines[i], scene->win, view);
+            // Tiles can reach past what the residency keeps around the view
+            draw_lines_restore(scene->lines[i]);
+            draw_lines_draw(scene->lines[i], scene->shaders, scene->win, view);
+        }
+    }
+}
+
+static b32 poll_save(draw_snapshot* snapshot) {
+    b32 saved = false;
+    if (!draw_snapshot_update(snapshot, &saved)) {
+        return false;
+    }
+
+    printf(saved ? "Saved to " SAVE_PATH "\n" : "Failed to save to " SAVE_PATH "\n");
+
+    return true;
+}
+
+static void print_frame_stats(const gfx_pacer* pacer, const gfx_window* win) {
+    gfx_pacer_stats stats = gfx_pacer_get_stats(pacer);
+
+    printf(
+        "Frame times over %u frames: mean %.2fms, std dev %.2fms, min %.2fms, max %.2fms, %u missed\n",
+        stats.num_frames, stats.mean_ms, stats.std_dev_ms, stats.min_ms, stats.max_ms, stats.num_missed
+    );
+    printf(
+        "Refresh %.2fms, work %.2fms%s\n",
+        pacer->refresh_usec / 1000.0f, pacer->work_usec / 1000.0f, pacer->vsync ? "" : " (no vsync)"
+    );
+
+    const gfx_input_stats* input = &win->input_stats;
+    if (input->num_events > 0) {
+        printf(
+            "Input queue latency over %llu events: mean %.3fms, max %.3fms, %llu dropped\n",
+            (unsigned long long)input->num_events, (f32)input->total_latency_usec / (f32)input->num_events / 1000.0f,
+            input->max_latency_usec / 1000.0f, (unsigned long long)input->num_dropped
+        );
+    }
+}
+
+static vec2f screen_to_world(const gfx_window* win, const mat3f* inv_view_mat, vec2f pos) {
+    vec2f ndc = (vec2f){
+        2.0f * pos.x / win->width - 1.0f,
+        -(2.0f * pos.y / win->height - 1.0f),
+    };
+
+    return mat3f_mul_vec2f(inv_view_mat, ndc);
+}
+
+static void erase_sweep_range(void* sweep_ptr, u32 start, u32 end) {
+    erase_sweep* sweep = (erase_sweep*)sweep_ptr;
+
+    for (u32 i = start; i < end; i++) {
+        sweep->hits[i] = draw_lines_collide_capsule(sweep->lines[i], sweep->capsule);
+    }
+}
+
+// Adds a point that stays in the stroke, in place of the provisional tail if there is one
+static void keep_stroke_point(draw_lines* stroke, b32* provisional_tail, vec2f point, f32 width) {
+    if (*provisional_tail) {
+        draw_lines_change_last_width(stroke, point, width);
+        *provisional_tail = false;
+    } else {
+        draw_lines_add_point_width(stroke, point, width);
+    }
+}
+
+static f32 pressure_width(f32 pressure) {
+    return STROKE_WIDTH * (MIN_PRESSURE_WIDTH + (1.0f - MIN_PRESSURE_WIDTH) * pressure);
+}
+
+static void lasso_sweep_range(void* sweep_ptr, u32 start, u32 end) {
+    lasso_sweep* sweep = (lasso_sweep*)sweep_ptr;
+
+    for (u32 i = start; i < end; i++) {
+        draw_lines* lines = sweep->lines[i];
+
+        sweep->hits[i] = rectf_collide_rectf(lines->bounding_box, sweep->bounds) &&
+            draw_query_polygon(&lines->points, sweep->polygon, sweep->num_polygon);
+    }
+}
+
+static void invalidate_lines(draw_tiles* tiles, draw_lines** lines, u32 num_lines) {
+    for (u32 i = 0; i < num_lines; i++) {
+        draw_tiles_invalidate(tiles, lines[i]->bounding_box);
+    }
+}
+
+// The history finds lines in the document by their slot
+static void update_slots(draw_lines** lines, u32 start, u32 num_lines) {
+    for (u32 i = start; i < num_lines; i++) {
+        lines[i]->slot = i;
+    }
+}
+
+static void invalidate_history_set(draw_tiles* tiles, const draw_history_set* set) {
+    for (draw_history_chunk* chunk = set->first; chunk != NULL; chunk = chunk->next) {
+        invalidate_lines(tiles, chunk->lines, chunk->size);
+    }
+}
+
+// Reuses lines objects that nothing refers to anymore before making new ones
+// Saves whether each lines object of the entry is in the document now, after it was done or undone
+static void journal_entry(draw_journal* journal, const draw_history_entry* entry) {
+    if (journal == NULL) {
+        return;
+    }
+
+    journal_set(journal, &entry->removed, !entry->done);
+    // Transformed lines stay in the document either way, only their points change
+    journal_set(journal, &entry->added, entry->done || entry->type == DRAW_HISTORY_TRANSFORM);
+}
+static void journal_set(draw_journal* journal, const draw_history_set* set, b32 in_document) {
+    for (draw_history_chunk* chunk = set->first; chunk != NULL; chunk = chunk->next) {
+        for (u32 i = 0; i < chunk->size; i++) {
+            if (in_document) {
+                draw_journal_put(journal, chunk->lines[i]);
+            } else {
+                draw_journal_remove(journal, chunk->lines[i]);
+            }
+        }
+    }
+}
+static draw_lines* new_lines(mg_arena* arena, draw_point_allocator* allocator, draw_history* history, vec4f col, f32 width) {
+    draw_lines* lines = draw_history_reuse(history, col, width);
+
+    if (lines == NULL) {
+        lines = draw_lines_create(arena, allocator, col, width);
+    }
+
+    return lines;
+}
+
+static rectf lines_bounds(draw_lines** lines, u32 num_lines) {
+    if (num_lines == 0) {
+        return (rectf){ 0 };
+    }
+
+    vec2f min = { lines[0]->bounding_box.x, lines[0]->bounding_box.y };
+    vec2f max = vec2f_add(min, (vec2f){ lines[0]->bounding_box.w, lines[0]->bounding_box.h });
+
+    for (u32 i = 1; i < num_lines; i++) {
+        rectf b = lines[i]->bounding_box;
+
+        min = (vec2f){ MIN(min.x, b.x), MIN(min.y, b.y) };
+        max = (vec2f){ MAX(max.x, b.x + b.w), MAX(max.y, b.y + b.h) };
+    }
+
+    return (rectf){ min.x, min.y, max.x - min.x, max.y - min.y };
+}
+
+// Rotates and scales around pivot, then moves by offset
+static void selection_transform(mat3f* out, vec2f pivot, vec2f offset, f32 rotation, f32 scale) {
+    f32 r_sin = sinf(rotation) * scale;
+    f32 r_cos = cosf(rotation) * scale;
+
+    *out = (mat3f){ {
+        r_cos, r_sin, 0.0f,
+        -r_sin, r_cos, 0.0f,
+        pivot.x + offset.x - (r_cos * pivot.x - r_sin * pivot.y),
+        pivot.y + offset.y - (r_sin * pivot.x + r_cos * pivot.y),
+        1.0f
+    } };
+}
+
+static void draw_outline(const static_scene* scene, u32 outline_buffer, const mat3f* view_mat, const vec2f* points, u32 num_points, vec4f col) {
+    num_points = MIN(num_points, LASSO_MAX_POINTS);
+
+    glUseProgram(scene->basic_program);
+    glUniformMatrix3fv(scene->basic_view_mat_loc, 1, GL_FALSE, view_mat->m);
+    glUniform4f(scene->basic_col_loc, col.x, col.y, col.z, col.w);
+
+    glBindVertexArray(scene->vertex_array);
+    glBindBuffer(GL_ARRAY_BUFFER, outline_buffer);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vec2f) * num_points, points);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vec2f), NULL);
+
+    glDrawArrays(GL_LINE_LOOP, 0, num_points);
+
+    glDisableVertexAttribArray(0);
+}
@@ -6,6 +6,90 @@
 void os_time_init(void);
 u64 os_now_usec(void);
 void os_sleep_ms(u64 ms);
+// Precision depends on the platform, it can be as coarse as a millisecond
+void os_sleep_usec(u64 usec);
 
-#endif // OS_H
+// Number of logical cores, at least 1
+u32 os_num_cores(void);
+
+// Timeout for functions that wait
+#define OS_WAIT_INFINITE 0xffffffff
+
+// Contents defined in os backends
+typedef struct os_thread os_thread;
+typedef struct os_mutex os_mutex;
+typedef struct os_condvar os_condvar;
+typedef struct os_semaphore os_semaphore;
+
+typedef void (os_thread_func)(void* arg);
+
+// Returns NULL if the platform does not support threads
+os_thread* os_thread_create(mg_arena* arena, os_thread_func* func, void* arg);
+void os_thread_join(os_thread* thread);
+// Pins the thread to one core, returns false if the platform does not support it
+b32 os_thread_set_affinity(os_thread* thread, u32 core);
+void os_thread_yield(void);
+
+os_mutex* os_mutex_create(mg_arena* arena);
+void os_mutex_destroy(os_mutex* mutex);
+void os_mutex_lock(os_mutex* mutex);
+void os_mutex_unlock(os_mutex* mutex);
+
+os_condvar* os_condvar_create(mg_arena* arena);
+void os_condvar_destroy(os_condvar* cond);
+// The mutex must be locked, returns false on timeout
+b32 os_condvar_wait(os_condvar* cond, os_mutex* mutex, u32 timeout_ms);
+void os_condvar_signal(os_condvar* cond);
+void os_condvar_broadcast(os_condvar* cond);
 
+os_semaphore* os_semaphore_create(mg_arena* arena, u32 initial_count);
+void os_semaphore_destroy(os_semaphore* sem);
+// Returns false on timeout
+b32 os_semaphore_wait(os_semaphore* sem, u32 timeout_ms);
+void os_semaphore_post(os_semaphore* sem, u32 count);
+
+// Sleeps while *addr == expected, can wake up spuriously
+void os_futex_wait(u32* addr, u32 expected, u32 timeout_ms);
+void os_futex_wake_one(u32* addr);
+void os_futex_wake_all(u32* addr);
+
+typedef struct os_file os_file;
+
+typedef enum {
+    OS_FILE_READ,
+    // Creates the file or empties it
+    OS_FILE_WRITE,
+    // Creates the file or writes after what is already in it
+    OS_FILE_APPEND,
+} os_file_mode;
+
+// Returns NULL if the file cannot be opened
+os_file* os_file_open(mg_arena* arena, string8 path, os_file_mode mode);
+void os_file_close(os_file* file);
+// Writes all of data, returns false if any of it could not be written
+b32 os_file_write(os_file* file, string8 data);
+// Returns once everything written so far is on the disk
+b32 os_file_sync(os_file* file);
+// Returns an empty string if the file cannot be read
+string8 os_file_read_all(mg_arena* arena, string8 path);
+// Replaces the file at to with the one at from, atomically where the platform allows it
+b32 os_file_replace(string8 from, string8 to);
+
+// Atomics, these use the GCC/Clang builtins which every supported toolchain has
+// The plain versions are sequentially consistent
+#define OS_ATOMIC_LOAD(ptr) __atomic_load_n((ptr), __ATOMIC_SEQ_CST)
+#define OS_ATOMIC_STORE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_SEQ_CST)
+#define OS_ATOMIC_LOAD_ACQUIRE(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#define OS_ATOMIC_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#define OS_ATOMIC_LOAD_RELAXED(ptr) __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#define OS_ATOMIC_STORE_RELAXED(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+// These return the previous value
+#define OS_ATOMIC_ADD(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_SEQ_CST)
+#define OS_ATOMIC_SUB(ptr, val) __atomic_fetch_sub((ptr), (val), __ATOMIC_SEQ_CST)
+#define OS_ATOMIC_EXCHANGE(ptr, val) __atomic_exchange_n((ptr), (val), __ATOMIC_SEQ_CST)
+// Writes the current value to *expected_ptr on failure
+#define OS_ATOMIC_CAS(ptr, expected_ptr, desired) \
+    __atomic_compare_exchange_n((ptr), (expected_ptr), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)
+#define OS_ATOMIC_FENCE() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif // OS_H
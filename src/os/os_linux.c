@@ -1,9 +1,23 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
 #include "os.h"
 
 #ifdef PLATFORM_LINUX
 
+#include <stdio.h>
+#include <errno.h>
 #include <unistd.h>
 #include <time.h>
+#include <sched.h>
+#include <limits.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 void os_time_init(void) { }
 u64 os_now_usec(void) {
@@ -14,6 +28,315 @@ u64 os_now_usec(void) {
 void os_sleep_ms(u64 ms) {
     usleep(ms * 1000);
 }
+void os_sleep_usec(u64 usec) {
+    usleep(usec);
+}
 
-#endif
+u32 os_num_cores(void) {
+    long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return num_cores < 1 ? 1 : (u32)num_cores;
+}
+
+typedef struct os_thread {
+    pthread_t handle;
+
+    os_thread_func* func;
+    void* arg;
+} os_thread;
+
+typedef struct os_mutex {
+    pthread_mutex_t handle;
+} os_mutex;
+
+typedef struct os_condvar {
+    pthread_cond_t handle;
+} os_condvar;
+
+typedef struct os_semaphore {
+    sem_t handle;
+} os_semaphore;
+
+typedef struct os_file {
+    int fd;
+} os_file;
+
+static void* _thread_start(void* thread_ptr);
+static struct timespec _timespec_after_ms(clockid_t clock, u32 ms);
+
+os_thread* os_thread_create(mg_arena* arena, os_thread_func* func, void* arg) {
+    os_thread* thread = MGA_PUSH_ZERO_STRUCT(arena, os_thread);
+
+    thread->func = func;
+    thread->arg = arg;
+
+    if (pthread_create(&thread->handle, NULL, _thread_start, thread) != 0) {
+        fprintf(stderr, "Failed to create thread\n");
+        return NULL;
+    }
+
+    return thread;
+}
+void os_thread_join(os_thread* thread) {
+    if (thread == NULL) {
+        fprintf(stderr, "Cannot join NULL thread\n");
+        return;
+    }
+
+    pthread_join(thread->handle, NULL);
+}
+
+b32 os_thread_set_affinity(os_thread* thread, u32 core) {
+    if (thread == NULL) {
+        fprintf(stderr, "Cannot set affinity of NULL thread\n");
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+
+    return pthread_setaffinity_np(thread->handle, sizeof(set), &set) == 0;
+}
+
+void os_thread_yield(void) {
+    sched_yield();
+}
+
+os_mutex* os_mutex_create(mg_arena* arena) {
+    os_mutex* mutex = MGA_PUSH_ZERO_STRUCT(arena, os_mutex);
+
+    pthread_mutex_init(&mutex->handle, NULL);
+
+    return mutex;
+}
+void os_mutex_destroy(os_mutex* mutex) {
+    pthread_mutex_destroy(&mutex->handle);
+}
+void os_mutex_lock(os_mutex* mutex) {
+    pthread_mutex_lock(&mutex->handle);
+}
+void os_mutex_unlock(os_mutex* mutex) {
+    pthread_mutex_unlock(&mutex->handle);
+}
+
+os_condvar* os_condvar_create(mg_arena* arena) {
+    os_condvar* cond = MGA_PUSH_ZERO_STRUCT(arena, os_condvar);
+
+    // Timeouts use the monotonic clock so they are not affected by changes to the system time
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&cond->handle, &attr);
+    pthread_condattr_destroy(&attr);
+
+    return cond;
+}
+void os_condvar_destroy(os_condvar* cond) {
+    pthread_cond_destroy(&cond->handle);
+}
+b32 os_condvar_wait(os_condvar* cond, os_mutex* mutex, u32 timeout_ms) {
+    if (timeout_ms == OS_WAIT_INFINITE) {
+        return pthread_cond_wait(&cond->handle, &mutex->handle) == 0;
+    }
 
+    struct timespec end = _timespec_after_ms(CLOCK_MONOTONIC, timeout_ms);
+
+    return pthread_cond_timedwait(&cond->handle, &mutex->handle, &end) == 0;
+}
+void os_condvar_signal(os_condvar* cond) {
+    pthread_cond_signal(&cond->handle);
+}
+void os_condvar_broadcast(os_condvar* cond) {
+    pthread_cond_broadcast(&cond->handle);
+}
+
+os_semaphore* os_semaphore_create(mg_arena* arena, u32 initial_count) {
+    os_semaphore* sem = MGA_PUSH_ZERO_STRUCT(arena, os_semaphore);
+
+    if (sem_init(&sem->handle, 0, initial_count) != 0) {
+        fprintf(stderr, "Failed to create semaphore\n");
+    }
+
+    return sem;
+}
+void os_semaphore_destroy(os_semaphore* sem) {
+    sem_destroy(&sem->handle);
+}
+b32 os_semaphore_wait(os_semaphore* sem, u32 timeout_ms) {
+    i32 res = 0;
+
+    if (timeout_ms == OS_WAIT_INFINITE) {
+        while ((res = sem_wait(&sem->handle)) != 0 && errno == EINTR) { }
+    } else {
+        // The monotonic clock keeps wall clock changes from stretching or cutting the timeout
+        struct timespec end = _timespec_after_ms(CLOCK_MONOTONIC, timeout_ms);
+        while ((res = sem_clockwait(&sem->handle, CLOCK_MONOTONIC, &end)) != 0 && errno == EINTR) { }
+    }
+
+    return res == 0;
+}
+void os_semaphore_post(os_semaphore* sem, u32 count) {
+    for (u32 i = 0; i < count; i++) {
+        sem_post(&sem->handle);
+    }
+}
+
+void os_futex_wait(u32* addr, u32 expected, u32 timeout_ms) {
+    if (timeout_ms == OS_WAIT_INFINITE) {
+        syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+        return;
+    }
+
+    // FUTEX_WAIT takes a relative timeout
+    struct timespec timeout = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_nsec = (long)(timeout_ms % 1000) * 1000000
+    };
+    syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, expected, &timeout, NULL, 0);
+}
+void os_futex_wake_one(u32* addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+void os_futex_wake_all(u32* addr) {
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+os_file* os_file_open(mg_arena* arena, string8 path, os_file_mode mode) {
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+
+    int flags = O_RDONLY;
+    if (mode == OS_FILE_WRITE) {
+        flags = O_WRONLY | O_CREAT | O_TRUNC;
+    } else if (mode == OS_FILE_APPEND) {
+        flags = O_WRONLY | O_CREAT | O_APPEND;
+    }
+
+    int fd = open((char*)str8_to_cstr(scratch.arena, path), flags | O_CLOEXEC, 0644);
+
+    mga_scratch_release(scratch);
+
+    if (fd == -1) {
+        fprintf(stderr, "Failed to open file \"%.*s\"\n", (int)path.size, path.str);
+        return NULL;
+    }
+
+    os_file* file = MGA_PUSH_ZERO_STRUCT(arena, os_file);
+    file->fd = fd;
+
+    return file;
+}
+void os_file_close(os_file* file) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot close NULL file\n");
+        return;
+    }
+
+    close(file->fd);
+}
+b32 os_file_write(os_file* file, string8 data) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot write to NULL file\n");
+        return false;
+    }
+
+    u64 written = 0;
+    while (written < data.size) {
+        ssize_t res = write(file->fd, data.str + written, data.size - written);
+
+        if (res == -1 && errno == EINTR) {
+            continue;
+        }
+        if (res <= 0) {
+            fprintf(stderr, "Failed to write to file\n");
+            return false;
+        }
+
+        written += (u64)res;
+    }
+
+    return true;
+}
+b32 os_file_sync(os_file* file) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot sync NULL file\n");
+        return false;
+    }
+
+    return fdatasync(file->fd) == 0;
+}
+string8 os_file_read_all(mg_arena* arena, string8 path) {
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+    int fd = open((char*)str8_to_cstr(scratch.arena, path), O_RDONLY | O_CLOEXEC);
+    mga_scratch_release(scratch);
+
+    if (fd == -1) {
+        return (string8){ 0 };
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) == -1 || info.st_size <= 0) {
+        close(fd);
+        return (string8){ 0 };
+    }
+
+    string8 out = {
+        .size = (u64)info.st_size,
+        .str = MGA_PUSH_ARRAY(arena, u8, (u64)info.st_size)
+    };
+
+    u64 num_read = 0;
+    while (num_read < out.size) {
+        ssize_t res = read(fd, out.str + num_read, out.size - num_read);
+
+        if (res == -1 && errno == EINTR) {
+            continue;
+        }
+        if (res <= 0) {
+            break;
+        }
+
+        num_read += (u64)res;
+    }
+
+    close(fd);
+
+    // Whatever could be read, a file cut short is up to the caller
+    out.size = num_read;
+
+    return out;
+}
+b32 os_file_replace(string8 from, string8 to) {
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    b32 out = rename((char*)str8_to_cstr(scratch.arena, from), (char*)str8_to_cstr(scratch.arena, to)) == 0;
+
+    mga_scratch_release(scratch);
+
+    return out;
+}
+
+static void* _thread_start(void* thread_ptr) {
+    os_thread* thread = (os_thread*)thread_ptr;
+
+    thread->func(thread->arg);
+
+    return NULL;
+}
+
+static struct timespec _timespec_after_ms(clockid_t clock, u32 ms) {
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000;
+
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec += 1;
+        ts.tv_nsec -= 1000000000;
+    }
+
+    return ts;
+}
+
+#endif
@@ -2,6 +2,7 @@
 
 #include "os.h"
 
+#include <stdio.h>
 #include <time.h>
 #include <emscripten.h>
 
@@ -17,4 +18,175 @@ void os_sleep_ms(u64 ms) {
     emscripten_sleep(ms);
 }
 
+void os_sleep_usec(u64 usec) {
+    emscripten_sleep(usec / 1000);
+}
+
+// The wasm build does not enable pthreads, so everything runs on the main thread
+// Locks are no-ops and waits return right away
+
+u32 os_num_cores(void) {
+    return 1;
+}
+
+typedef struct os_semaphore {
+    u32 count;
+} os_semaphore;
+
+// Files live in the in-memory file system of emscripten
+typedef struct os_file {
+    FILE* handle;
+} os_file;
+
+os_thread* os_thread_create(mg_arena* arena, os_thread_func* func, void* arg) {
+    UNUSED(arena);
+    UNUSED(func);
+    UNUSED(arg);
+
+    fprintf(stderr, "Cannot create thread: threads are not supported on wasm\n");
+    return NULL;
+}
+void os_thread_join(os_thread* thread) {
+    UNUSED(thread);
+}
+b32 os_thread_set_affinity(os_thread* thread, u32 core) {
+    UNUSED(thread);
+    UNUSED(core);
+
+    return false;
+}
+void os_thread_yield(void) { }
+
+os_mutex* os_mutex_create(mg_arena* arena) {
+    // Never dereferenced, it only has to be unique
+    return (os_mutex*)MGA_PUSH_ZERO_ARRAY(arena, u8, 1);
+}
+void os_mutex_destroy(os_mutex* mutex) { UNUSED(mutex); }
+void os_mutex_lock(os_mutex* mutex) { UNUSED(mutex); }
+void os_mutex_unlock(os_mutex* mutex) { UNUSED(mutex); }
+
+os_condvar* os_condvar_create(mg_arena* arena) {
+    return (os_condvar*)MGA_PUSH_ZERO_ARRAY(arena, u8, 1);
+}
+void os_condvar_destroy(os_condvar* cond) { UNUSED(cond); }
+b32 os_condvar_wait(os_condvar* cond, os_mutex* mutex, u32 timeout_ms) {
+    UNUSED(cond);
+    UNUSED(mutex);
+    UNUSED(timeout_ms);
+
+    // Nothing else could signal it
+    return false;
+}
+void os_condvar_signal(os_condvar* cond) { UNUSED(cond); }
+void os_condvar_broadcast(os_condvar* cond) { UNUSED(cond); }
+
+os_semaphore* os_semaphore_create(mg_arena* arena, u32 initial_count) {
+    os_semaphore* sem = MGA_PUSH_ZERO_STRUCT(arena, os_semaphore);
+    sem->count = initial_count;
+
+    return sem;
+}
+void os_semaphore_destroy(os_semaphore* sem) { UNUSED(sem); }
+b32 os_semaphore_wait(os_semaphore* sem, u32 timeout_ms) {
+    UNUSED(timeout_ms);
+
+    if (sem->count == 0) {
+        return false;
+    }
+
+    sem->count--;
+    return true;
+}
+void os_semaphore_post(os_semaphore* sem, u32 count) {
+    sem->count += count;
+}
+
+void os_futex_wait(u32* addr, u32 expected, u32 timeout_ms) {
+    UNUSED(addr);
+    UNUSED(expected);
+    UNUSED(timeout_ms);
+}
+void os_futex_wake_one(u32* addr) { UNUSED(addr); }
+void os_futex_wake_all(u32* addr) { UNUSED(addr); }
+
+os_file* os_file_open(mg_arena* arena, string8 path, os_file_mode mode) {
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+
+    const char* modes[] = { "rb", "wb", "ab" };
+    FILE* handle = fopen((char*)str8_to_cstr(scratch.arena, path), modes[mode]);
+
+    mga_scratch_release(scratch);
+
+    if (handle == NULL) {
+        fprintf(stderr, "Failed to open file \"%.*s\"\n", (int)path.size, path.str);
+        return NULL;
+    }
+
+    os_file* file = MGA_PUSH_ZERO_STRUCT(arena, os_file);
+    file->handle = handle;
+
+    return file;
+}
+void os_file_close(os_file* file) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot close NULL file\n");
+        return;
+    }
+
+    fclose(file->handle);
+}
+b32 os_file_write(os_file* file, string8 data) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot write to NULL file\n");
+        return false;
+    }
+
+    return fwrite(data.str, 1, data.size, file->handle) == data.size;
+}
+b32 os_file_sync(os_file* file) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot sync NULL file\n");
+        return false;
+    }
+
+    return fflush(file->handle) == 0;
+}
+string8 os_file_read_all(mg_arena* arena, string8 path) {
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+    FILE* handle = fopen((char*)str8_to_cstr(scratch.arena, path), "rb");
+    mga_scratch_release(scratch);
+
+    if (handle == NULL) {
+        return (string8){ 0 };
+    }
+
+    fseek(handle, 0, SEEK_END);
+    long size = ftell(handle);
+    fseek(handle, 0, SEEK_SET);
+
+    if (size <= 0) {
+        fclose(handle);
+        return (string8){ 0 };
+    }
+
+    string8 out = {
+        .size = (u64)size,
+        .str = MGA_PUSH_ARRAY(arena, u8, (u64)size)
+    };
+    out.size = fread(out.str, 1, out.size, handle);
+
+    fclose(handle);
+
+    return out;
+}
+b32 os_file_replace(string8 from, string8 to) {
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    b32 out = rename((char*)str8_to_cstr(scratch.arena, from), (char*)str8_to_cstr(scratch.arena, to)) == 0;
+
+    mga_scratch_release(scratch);
+
+    return out;
+}
+
 #endif // __EMSCRIPTEN__
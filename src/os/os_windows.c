@@ -3,6 +3,7 @@
 #ifdef PLATFORM_WIN32
 
 #include <stdio.h>
+#include <limits.h>
 
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
@@ -30,6 +31,276 @@ u64 os_now_usec(void) {
 void os_sleep_ms(u64 ms) {
     Sleep(ms);
 }
+void os_sleep_usec(u64 usec) {
+    Sleep(usec / 1000);
+}
+
+u32 os_num_cores(void) {
+    SYSTEM_INFO info = { 0 };
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors < 1 ? 1 : (u32)info.dwNumberOfProcessors;
+}
+
+typedef struct os_thread {
+    HANDLE handle;
+
+    os_thread_func* func;
+    void* arg;
+} os_thread;
+
+typedef struct os_mutex {
+    SRWLOCK lock;
+} os_mutex;
+
+typedef struct os_condvar {
+    CONDITION_VARIABLE handle;
+} os_condvar;
+
+typedef struct os_semaphore {
+    HANDLE handle;
+} os_semaphore;
+
+typedef struct os_file {
+    HANDLE handle;
+} os_file;
+
+static DWORD WINAPI _thread_start(LPVOID thread_ptr);
+
+os_thread* os_thread_create(mg_arena* arena, os_thread_func* func, void* arg) {
+    os_thread* thread = MGA_PUSH_ZERO_STRUCT(arena, os_thread);
+
+    thread->func = func;
+    thread->arg = arg;
+
+    thread->handle = CreateThread(NULL, 0, _thread_start, thread, 0, NULL);
+    if (thread->handle == NULL) {
+        fprintf(stderr, "Failed to create thread\n");
+        return NULL;
+    }
+
+    return thread;
+}
+void os_thread_join(os_thread* thread) {
+    if (thread == NULL) {
+        fprintf(stderr, "Cannot join NULL thread\n");
+        return;
+    }
+
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+}
+
+b32 os_thread_set_affinity(os_thread* thread, u32 core) {
+    if (thread == NULL) {
+        fprintf(stderr, "Cannot set affinity of NULL thread\n");
+        return false;
+    }
+
+    return SetThreadAffinityMask(thread->handle, (DWORD_PTR)1 << core) != 0;
+}
+
+void os_thread_yield(void) {
+    SwitchToThread();
+}
+
+os_mutex* os_mutex_create(mg_arena* arena) {
+    os_mutex* mutex = MGA_PUSH_ZERO_STRUCT(arena, os_mutex);
+
+    InitializeSRWLock(&mutex->lock);
+
+    return mutex;
+}
+void os_mutex_destroy(os_mutex* mutex) {
+    // SRW locks do not need to be destroyed
+    UNUSED(mutex);
+}
+void os_mutex_lock(os_mutex* mutex) {
+    AcquireSRWLockExclusive(&mutex->lock);
+}
+void os_mutex_unlock(os_mutex* mutex) {
+    ReleaseSRWLockExclusive(&mutex->lock);
+}
+
+os_condvar* os_condvar_create(mg_arena* arena) {
+    os_condvar* cond = MGA_PUSH_ZERO_STRUCT(arena, os_condvar);
+
+    InitializeConditionVariable(&cond->handle);
+
+    return cond;
+}
+void os_condvar_destroy(os_condvar* cond) {
+    UNUSED(cond);
+}
+b32 os_condvar_wait(os_condvar* cond, os_mutex* mutex, u32 timeout_ms) {
+    return SleepConditionVariableSRW(&cond->handle, &mutex->lock, timeout_ms, 0);
+}
+void os_condvar_signal(os_condvar* cond) {
+    WakeConditionVariable(&cond->handle);
+}
+void os_condvar_broadcast(os_condvar* cond) {
+    WakeAllConditionVariable(&cond->handle);
+}
+
+os_semaphore* os_semaphore_create(mg_arena* arena, u32 initial_count) {
+    os_semaphore* sem = MGA_PUSH_ZERO_STRUCT(arena, os_semaphore);
+
+    sem->handle = CreateSemaphoreW(NULL, initial_count, LONG_MAX, NULL);
+    if (sem->handle == NULL) {
+        fprintf(stderr, "Failed to create semaphore\n");
+    }
+
+    return sem;
+}
+void os_semaphore_destroy(os_semaphore* sem) {
+    CloseHandle(sem->handle);
+}
+b32 os_semaphore_wait(os_semaphore* sem, u32 timeout_ms) {
+    return WaitForSingleObject(sem->handle, timeout_ms) == WAIT_OBJECT_0;
+}
+void os_semaphore_post(os_semaphore* sem, u32 count) {
+    ReleaseSemaphore(sem->handle, count, NULL);
+}
+
+void os_futex_wait(u32* addr, u32 expected, u32 timeout_ms) {
+    WaitOnAddress(addr, &expected, sizeof(u32), timeout_ms);
+}
+void os_futex_wake_one(u32* addr) {
+    WakeByAddressSingle(addr);
+}
+void os_futex_wake_all(u32* addr) {
+    WakeByAddressAll(addr);
+}
+
+os_file* os_file_open(mg_arena* arena, string8 path, os_file_mode mode) {
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+
+    DWORD access = GENERIC_READ;
+    DWORD creation = OPEN_EXISTING;
+    if (mode == OS_FILE_WRITE) {
+        access = GENERIC_WRITE;
+        creation = CREATE_ALWAYS;
+    } else if (mode == OS_FILE_APPEND) {
+        access = FILE_APPEND_DATA;
+        creation = OPEN_ALWAYS;
+    }
+
+    HANDLE handle = CreateFileA(
+        (char*)str8_to_cstr(scratch.arena, path), access, FILE_SHARE_READ | FILE_SHARE_DELETE,
+        NULL, creation, FILE_ATTRIBUTE_NORMAL, NULL
+    );
+
+    mga_scratch_release(scratch);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        fprintf(stderr, "Failed to open file \"%.*s\"\n", (int)path.size, path.str);
+        return NULL;
+    }
+
+    os_file* file = MGA_PUSH_ZERO_STRUCT(arena, os_file);
+    file->handle = handle;
+
+    return file;
+}
+void os_file_close(os_file* file) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot close NULL file\n");
+        return;
+    }
+
+    CloseHandle(file->handle);
+}
+b32 os_file_write(os_file* file, string8 data) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot write to NULL file\n");
+        return false;
+    }
+
+    u64 written = 0;
+    while (written < data.size) {
+        DWORD to_write = (DWORD)MIN(data.size - written, (u64)UINT_MAX);
+        DWORD res = 0;
+
+        if (!WriteFile(file->handle, data.str + written, to_write, &res, NULL) || res == 0) {
+            fprintf(stderr, "Failed to write to file\n");
+            return false;
+        }
+
+        written += res;
+    }
+
+    return true;
+}
+b32 os_file_sync(os_file* file) {
+    if (file == NULL) {
+        fprintf(stderr, "Cannot sync NULL file\n");
+        return false;
+    }
+
+    return FlushFileBuffers(file->handle);
+}
+string8 os_file_read_all(mg_arena* arena, string8 path) {
+    mga_temp scratch = mga_scratch_get(&arena, 1);
+    HANDLE handle = CreateFileA(
+        (char*)str8_to_cstr(scratch.arena, path), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL
+    );
+    mga_scratch_release(scratch);
+
+    if (handle == INVALID_HANDLE_VALUE) {
+        return (string8){ 0 };
+    }
+
+    LARGE_INTEGER size = { 0 };
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart <= 0) {
+        CloseHandle(handle);
+        return (string8){ 0 };
+    }
+
+    string8 out = {
+        .size = (u64)size.QuadPart,
+        .str = MGA_PUSH_ARRAY(arena, u8, (u64)size.QuadPart)
+    };
+
+    u64 num_read = 0;
+    while (num_read < out.size) {
+        DWORD to_read = (DWORD)MIN(out.size - num_read, (u64)UINT_MAX);
+        DWORD res = 0;
+
+        if (!ReadFile(handle, out.str + num_read, to_read, &res, NULL) || res == 0) {
+            break;
+        }
+
+        num_read += res;
+    }
+
+    CloseHandle(handle);
+
+    // Whatever could be read, a file cut short is up to the caller
+    out.size = num_read;
+
+    return out;
+}
+b32 os_file_replace(string8 from, string8 to) {
+    mga_temp scratch = mga_scratch_get(NULL, 0);
+
+    b32 out = MoveFileExA(
+        (char*)str8_to_cstr(scratch.arena, from), (char*)str8_to_cstr(scratch.arena, to),
+        MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH
+    );
+
+    mga_scratch_release(scratch);
+
+    return out;
+}
+
+static DWORD WINAPI _thread_start(LPVOID thread_ptr) {
+    os_thread* thread = (os_thread*)thread_ptr;
+
+    thread->func(thread->arg);
+
+    return 0;
+}
 
 #endif
 